@@ -11,6 +11,7 @@
 
 #include "C64Config.h"
 #include <CodeAnalyser/CodeAnalysisJson.h>
+#include <CodeAnalyser/CodeAnalysisBinary.h>
 #include <CodeAnalyser/CodeAnalysisState.h>
 #include "CodeAnalyser/UI/CharacterMapViewer.h"
 
@@ -48,7 +49,7 @@ void gfx_destroy_texture(void* h)
 static void push_audio(const float* samples, int num_samples, void* user_data)
 {
     FC64Emulator* pC64Emu = (FC64Emulator*)user_data;
-    if(pC64Emu->GetGlobalConfig()->bEnableAudio)
+    if(pC64Emu->GetGlobalConfig()->bEnableAudio && pC64Emu->IsWarping() == false)
         saudio_push(samples, num_samples);
 }
 
@@ -248,10 +249,15 @@ void FC64Emulator::SetupCodeAnalysisLabels()
 {
     // Add IO Labels to code analysis
     FCodeAnalysisBank* pIOBank = CodeAnalysis.GetBank(IOAreaId);
-    AddVICRegisterLabels(pIOBank->Pages[0]);  // Page $D000-$D3ff
-    AddSIDRegisterLabels(pIOBank->Pages[1]);  // Page $D400-$D7ff
-    pIOBank->Pages[2].SetLabelAtAddress("ColourRAM", ELabelType::Data, 0x0000);    // Colour RAM $D800
-    AddCIARegisterLabels(pIOBank->Pages[3]);  // Page $DC00-$Dfff
+    bool bLabelsChanged = false;
+    bLabelsChanged |= AddVICRegisterLabels(CodeAnalysis, pIOBank->Pages[0]);  // Page $D000-$D3ff
+    bLabelsChanged |= AddSIDRegisterLabels(CodeAnalysis, pIOBank->Pages[1]);  // Page $D400-$D7ff
+    bLabelsChanged |= pIOBank->Pages[2].SetLabelAtAddress(CodeAnalysis, "ColourRAM", ELabelType::Data, 0x0000);    // Colour RAM $D800
+    bLabelsChanged |= AddCIARegisterLabels(CodeAnalysis, pIOBank->Pages[3]);  // Page $DC00-$Dfff
+
+    // these can replace loaded labels of another type
+    if (bLabelsChanged)
+        GenerateGlobalInfo(CodeAnalysis);
 }
 
 void FC64Emulator::UpdateCodeAnalysisPages(uint8_t cpuPort)
@@ -337,10 +343,17 @@ bool FC64Emulator::StartGame(FGameConfig* pGameConfig, bool bLoadGameData)
         const std::string dataFName = root + "GameData/" + pGameConfig->Name + ".bin";
 
         const std::string analysisJsonFName = root + "AnalysisJson/" + pGameConfig->Name + ".json";
+        const std::string analysisBinFName = root + "AnalysisBin/" + pGameConfig->Name + ".bin";
         const std::string graphicsSetsJsonFName = root + "GraphicsSets/" + pGameConfig->Name + ".json";
         const std::string analysisStateFName = root + "AnalysisState/" + pGameConfig->Name + ".astate";
         const std::string saveStateFName = root + "SaveStates/" + pGameConfig->Name + ".state";
-        if (FileExists(analysisJsonFName.c_str()))
+        // prefer the binary analysis, Json is for older projects
+        if (FileExists(analysisBinFName.c_str()))
+        {
+            ImportAnalysisBinary(CodeAnalysis, analysisBinFName.c_str());
+            ImportAnalysisState(CodeAnalysis, analysisStateFName.c_str());
+        }
+        else if (FileExists(analysisJsonFName.c_str()))
         {
             ImportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
             ImportAnalysisState(CodeAnalysis, analysisStateFName.c_str());
@@ -470,6 +483,7 @@ bool FC64Emulator::SaveCurrentGameData(void)
     const std::string root = pGlobalConfig->WorkspaceRoot;
     const std::string configFName = root + "Configs/" + pCurrentGameConfig->Name + ".json";
     const std::string analysisJsonFName = root + "AnalysisJson/" + pCurrentGameConfig->Name + ".json";
+    const std::string analysisBinFName = root + "AnalysisBin/" + pCurrentGameConfig->Name + ".bin";
     const std::string graphicsSetsJsonFName = root + "GraphicsSets/" + pCurrentGameConfig->Name + ".json";
     const std::string analysisStateFName = root + "AnalysisState/" + pCurrentGameConfig->Name + ".astate";
     const std::string saveStateFName = root + "SaveStates/" + pCurrentGameConfig->Name + ".state";
@@ -477,13 +491,16 @@ bool FC64Emulator::SaveCurrentGameData(void)
     EnsureDirectoryExists(std::string(root + "Configs").c_str());
     EnsureDirectoryExists(std::string(root + "GameData").c_str());
     EnsureDirectoryExists(std::string(root + "AnalysisJson").c_str());
+    EnsureDirectoryExists(std::string(root + "AnalysisBin").c_str());
     EnsureDirectoryExists(std::string(root + "GraphicsSets").c_str());
     EnsureDirectoryExists(std::string(root + "AnalysisState").c_str());
     EnsureDirectoryExists(std::string(root + "SaveStates").c_str());
 
     SaveGameState(saveStateFName.c_str());
     
-    ExportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
+    ExportAnalysisBinaryChanges(CodeAnalysis, analysisBinFName.c_str());
+    if (pGlobalConfig->bSaveAnalysisJson)
+        ExportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
     ExportAnalysisState(CodeAnalysis, analysisStateFName.c_str());
     //GraphicsViewer.SaveGraphicsSets(graphicsSetsJsonFName.c_str());
     // 
@@ -659,6 +676,22 @@ void	FC64Emulator::WindowsMenuAdditions(void)
 }
 
 
+void FC64Emulator::ExecuteFrame(uint32_t microSeconds)
+{
+	CodeAnalysis.OnFrameStart();
+	//StoreRegisters_6502(CodeAnalysis);
+
+	c64_exec(&C64Emu, microSeconds);
+
+	CodeAnalysis.OnFrameEnd();
+}
+
+// the tape motor is switched on by the loader through the processor port
+bool FC64Emulator::DetectLoading()
+{
+	return (C64Emu.cas_port & C64_CASPORT_MOTOR) == 0;	// motor line is active low
+}
+
 void FC64Emulator::Tick()
 {
     FEmuBase::Tick();
@@ -671,12 +704,7 @@ void FC64Emulator::Tick()
 	{
 		const float frameTime = (float)std::min(1000000.0f / ImGui::GetIO().Framerate, 32000.0f) * 1.0f;// speccyInstance.ExecSpeedScale;
     
-		CodeAnalysis.OnFrameStart();
-		//StoreRegisters_6502(CodeAnalysis);
-
-        c64_exec(&C64Emu, (uint32_t)std::max(static_cast<uint32_t>(frameTime), uint32_t(1)));
-
-		CodeAnalysis.OnFrameEnd();
+		ExecuteHostFrame((uint32_t)std::max(static_cast<uint32_t>(frameTime), uint32_t(1)));
     }
     DrawDockingView();
 #if 0
@@ -886,6 +914,7 @@ uint64_t FC64Emulator::OnCPUTick(uint64_t pins)
         }
         else
         {
+            state.MarkMemoryWritten(addr);
             if (state.bRegisterDataAccesses)
             {
                 RegisterDataWrite(CodeAnalysis, pc, addr, val);
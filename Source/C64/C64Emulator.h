@@ -74,6 +74,8 @@ public:
 	void    Shutdown() override;
 	void	DrawEmulatorUI() override;
 	void    Tick() override;
+	void	ExecuteFrame(uint32_t microSeconds) override;
+	bool	DetectLoading() override;
 	void    Reset() override;
 
 	void	FileMenuAdditions(void) override;
@@ -108,6 +110,7 @@ public:
 	void WriteByte(uint16_t address, uint8_t value) override
 	{
 		mem_wr(&C64Emu.mem_cpu, address, value);
+		CodeAnalysis.MarkMemoryWritten(address);
 	}
 
 	FAddressRef GetPC() override
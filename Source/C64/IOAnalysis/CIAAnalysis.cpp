@@ -297,18 +297,21 @@ void	FCIAAnalysis::DrawDetailsUI(void)
 	ImGui::EndChild();
 }
 
-void AddCIARegisterLabels(FCodeAnalysisPage& IOPage)
+bool AddCIARegisterLabels(FCodeAnalysisState& state, FCodeAnalysisPage& IOPage)
 {
+	bool bChanged = false;
+
 	// CIA 1 -$DC00 - $DC0F
 	std::vector<FRegDisplayConfig>& CIA1RegList = g_CIA1RegDrawInfo;
 
 	for (int reg = 0; reg < (int)CIA1RegList.size(); reg++)
-		IOPage.SetLabelAtAddress(CIA1RegList[reg].Name, ELabelType::Data, reg);
+		bChanged |= IOPage.SetLabelAtAddress(state, CIA1RegList[reg].Name, ELabelType::Data, reg);
 
 	// CIA 2 -$DD00 - $DD0F
 	std::vector<FRegDisplayConfig>& CIA2RegList = g_CIA1RegDrawInfo;
 
 	for (int reg = 0; reg < (int)CIA2RegList.size(); reg++)
-		IOPage.SetLabelAtAddress(CIA2RegList[reg].Name, ELabelType::Data, reg + 0x100);	// offset by 256 bytes
+		bChanged |= IOPage.SetLabelAtAddress(state, CIA2RegList[reg].Name, ELabelType::Data, reg + 0x100);	// offset by 256 bytes
 
+	return bChanged;
 }
\ No newline at end of file
@@ -48,4 +48,4 @@ public:
 
 };
 
-void AddCIARegisterLabels(FCodeAnalysisPage& IOPage);
\ No newline at end of file
+bool AddCIARegisterLabels(FCodeAnalysisState& state, FCodeAnalysisPage& IOPage);
\ No newline at end of file
@@ -115,11 +115,13 @@ void	FSIDAnalysis::DrawDetailsUI(void)
 	ImGui::EndChild();
 }
 
-void AddSIDRegisterLabels(FCodeAnalysisPage& IOPage)
+bool AddSIDRegisterLabels(FCodeAnalysisState& state, FCodeAnalysisPage& IOPage)
 {
 	std::vector<FRegDisplayConfig>& regList = g_SIDRegDrawInfo;
+	bool bChanged = false;
 
 	for (int reg = 0; reg < (int)regList.size(); reg++)
-		IOPage.SetLabelAtAddress(regList[reg].Name, ELabelType::Data, reg);
+		bChanged |= IOPage.SetLabelAtAddress(state, regList[reg].Name, ELabelType::Data, reg);
 
+	return bChanged;
 }
\ No newline at end of file
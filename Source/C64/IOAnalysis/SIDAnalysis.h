@@ -23,4 +23,4 @@ private:
 	int		SelectedRegister = -1;
 };
 
-void AddSIDRegisterLabels(FCodeAnalysisPage& IOPage);
\ No newline at end of file
+bool AddSIDRegisterLabels(FCodeAnalysisState& state, FCodeAnalysisPage& IOPage);
\ No newline at end of file
@@ -532,8 +532,10 @@ void FVICAnalysis::DrawVICRegisterInfo(void)
 
 
 
-void AddVICRegisterLabels(FCodeAnalysisPage& IOPage)
+bool AddVICRegisterLabels(FCodeAnalysisState& state, FCodeAnalysisPage& IOPage)
 {
+	bool bChanged = false;
 	for(int reg=0;reg< (int)g_VICRegDrawInfo.size();reg++)
-		IOPage.SetLabelAtAddress(g_VICRegDrawInfo[reg].Name, ELabelType::Data, reg);
+		bChanged |= IOPage.SetLabelAtAddress(state, g_VICRegDrawInfo[reg].Name, ELabelType::Data, reg);
+	return bChanged;
 }
\ No newline at end of file
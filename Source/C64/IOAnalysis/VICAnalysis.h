@@ -111,4 +111,4 @@ private:
 
 };
 
-void AddVICRegisterLabels(FCodeAnalysisPage& IOPage);
\ No newline at end of file
+bool AddVICRegisterLabels(FCodeAnalysisState& state, FCodeAnalysisPage& IOPage);
\ No newline at end of file
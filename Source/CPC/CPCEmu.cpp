@@ -13,6 +13,7 @@
 #include <CodeAnalyser/CodeAnalysisState.h>
 #include <CodeAnalyser/AssemblerExport.h>
 #include "CodeAnalyser/CodeAnalysisJson.h"
+#include "CodeAnalyser/CodeAnalysisBinary.h"
 #include "CPCGameConfig.h"
 #include "Debug/DebugLog.h"
 #include "CPCChipsImpl.h"
@@ -58,6 +59,7 @@ const uint8_t* FCPCEmu::GetMemPtr(uint16_t address) const
 void FCPCEmu::WriteByte(uint16_t address, uint8_t value)
 {
 	mem_wr(&CPCEmuState.mem, address, value);
+	CodeAnalysis.MarkMemoryWritten(address);
 }
 
 FAddressRef FCPCEmu::GetPC(void) 
@@ -139,7 +141,7 @@ void gfx_destroy_texture(void* h)
 static void PushAudio(const float* samples, int num_samples, void* user_data)
 {
 	FCPCEmu* pEmu = (FCPCEmu*)user_data;
-	if(pEmu->GetGlobalConfig()->bEnableAudio)
+	if(pEmu->GetGlobalConfig()->bEnableAudio && pEmu->IsWarping() == false)
 		saudio_push(samples, num_samples);
 }
 
@@ -187,11 +189,11 @@ uint64_t FCPCEmu::Z80Tick(int num, uint64_t pins)
 	{
 		if (scanlinePos == 0)
 		{
-			debugger.OnMachineFrameStart();
+			state.OnMachineFrameStart();
 		}
 		if (scanlinePos == 311)
 		{
-			debugger.OnMachineFrameEnd();
+			state.OnMachineFrameEnd();
 		}
 	}
 	lastScanlinePos = scanlinePos;
@@ -215,6 +217,7 @@ uint64_t FCPCEmu::Z80Tick(int num, uint64_t pins)
 		}
 		else if (pins & Z80_WR) 
 		{
+			state.MarkMemoryWritten(addr);
 			if (state.bRegisterDataAccesses)
 				RegisterDataWrite(state, pc, addr, value);
 			const FAddressRef addrRef = state.AddressRefFromPhysicalAddress(addr);
@@ -906,6 +909,7 @@ bool FCPCEmu::StartGame(FGameConfig* pGameConfig, bool bLoadGameData)
 	{
 		const std::string root = pGlobalConfig->WorkspaceRoot;
 		const std::string analysisJsonFName = root + "AnalysisJson/" + pGameConfig->Name + ".json";
+		const std::string analysisBinFName = root + "AnalysisBin/" + pGameConfig->Name + ".bin";
 		const std::string graphicsSetsJsonFName = root + "GraphicsSets/" + pGameConfig->Name + ".json";
 		const std::string analysisStateFName = root + "AnalysisState/" + pGameConfig->Name + ".astate";
 		const std::string saveStateFName = root + "SaveStates/" + pGameConfig->Name + ".state";
@@ -924,7 +928,11 @@ bool FCPCEmu::StartGame(FGameConfig* pGameConfig, bool bLoadGameData)
 			return false;
 		}
 
-		ImportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
+		// prefer the binary analysis, Json is for older projects
+		if (FileExists(analysisBinFName.c_str()))
+			ImportAnalysisBinary(CodeAnalysis, analysisBinFName.c_str());
+		else
+			ImportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
 		ImportAnalysisState(CodeAnalysis, analysisStateFName.c_str());
 
 		pGraphicsViewer->LoadGraphicsSets(graphicsSetsJsonFName.c_str());
@@ -1041,12 +1049,14 @@ bool FCPCEmu::SaveCurrentGameData(void)
 		const std::string configFName = root + "Configs/" + pGameConfig->Name + ".json";
 		const std::string dataFName = root + "GameData/" + pGameConfig->Name + ".bin";
 		const std::string analysisJsonFName = root + "AnalysisJson/" + pGameConfig->Name + ".json";
+		const std::string analysisBinFName = root + "AnalysisBin/" + pGameConfig->Name + ".bin";
 		const std::string graphicsSetsJsonFName = root + "GraphicsSets/" + pGameConfig->Name + ".json";
 		const std::string analysisStateFName = root + "AnalysisState/" + pGameConfig->Name + ".astate";
 		const std::string saveStateFName = root + "SaveStates/" + pGameConfig->Name + ".state";
 		EnsureDirectoryExists(std::string(root + "Configs").c_str());
 		EnsureDirectoryExists(std::string(root + "GameData").c_str());
 		EnsureDirectoryExists(std::string(root + "AnalysisJson").c_str());
+		EnsureDirectoryExists(std::string(root + "AnalysisBin").c_str());
 		EnsureDirectoryExists(std::string(root + "GraphicsSets").c_str());
 		EnsureDirectoryExists(std::string(root + "AnalysisState").c_str());
 		EnsureDirectoryExists(std::string(root + "SaveStates").c_str());
@@ -1063,7 +1073,9 @@ bool FCPCEmu::SaveCurrentGameData(void)
 
 		SaveGameConfigToFile(*pGameConfig, configFName.c_str());
 		SaveGameState(saveStateFName.c_str());
-		ExportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
+		ExportAnalysisBinaryChanges(CodeAnalysis, analysisBinFName.c_str());
+		if (pGlobalConfig->bSaveAnalysisJson)
+			ExportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
 		ExportAnalysisState(CodeAnalysis, analysisStateFName.c_str());
 		//ExportGameJson(this, analysisJsonFName.c_str());
 		pGraphicsViewer->SaveGraphicsSets(graphicsSetsJsonFName.c_str());
@@ -1529,16 +1541,7 @@ void FCPCEmu::Tick()
 		const float frameTime = std::min(1000000.0f / ImGui::GetIO().Framerate, 32000.0f) * ExecSpeedScale;
 		const uint32_t microSeconds = std::max(static_cast<uint32_t>(frameTime), uint32_t(1));
 
-		CodeAnalysis.OnFrameStart();
-		
-		StoreRegisters_Z80(CodeAnalysis);
-
-		cpc_exec(&CPCEmuState, microSeconds);
-		
-		// sam todo
-		//FrameTraceViewer.CaptureFrame();
-
-		CodeAnalysis.OnFrameEnd();
+		ExecuteHostFrame(microSeconds);
 	}
 	
 	UpdateCharacterSets(CodeAnalysis);
@@ -1548,6 +1551,26 @@ void FCPCEmu::Tick()
 	DrawDockingView();
 }
 
+void FCPCEmu::ExecuteFrame(uint32_t microSeconds)
+{
+	CodeAnalysis.OnFrameStart();
+		
+	StoreRegisters_Z80(CodeAnalysis);
+
+	cpc_exec(&CPCEmuState, microSeconds);
+		
+	// sam todo
+	//FrameTraceViewer.CaptureFrame();
+
+	CodeAnalysis.OnFrameEnd();
+}
+
+// the firmware & tape loaders switch the cassette motor on with PPI port C bit 4
+bool FCPCEmu::DetectLoading()
+{
+	return (CPCEmuState.ppi.pc.outp & (1 << 4)) != 0;
+}
+
 #if 0
 // todo: delete?
 void FCPCEmu::DrawMemoryTools()
@@ -115,6 +115,8 @@ public:
 
 	void				Reset() override;
 	void				Tick() override;
+	void				ExecuteFrame(uint32_t microSeconds) override;
+	bool				DetectLoading() override;
 
 	void				DrawEmulatorUI(void);
 
@@ -1,5 +1,6 @@
 #include "CodeAnalyser6502.h"
 #include "../CodeAnalyser.h"
+#include "M6502Disassembler.h"
 #include <Debug/DebugLog.h>
 
 enum class EAddressMode : uint8_t
@@ -266,43 +267,67 @@ bool CheckStopInstruction6502(const FCodeAnalysisState& state, uint16_t pc)
 	return false;
 }
 
-bool RegisterCodeExecuted6502(FCodeAnalysisState& state, uint16_t pc, uint16_t oldpc)
+// Decode what's needed when the instruction is executed
+// returns false if the result can't be cached
+bool DecodeInstruction6502(FCodeAnalysisState& state, uint16_t pc, FDecodedInstruction& instr)
 {
-	const ICPUInterface* pCPUInterface = state.CPUInterface;
-	FDebugger& debugger = state.Debugger;
-	const uint8_t opcode = pCPUInterface->ReadByte(pc);
-	const uint8_t oldOpcode = pCPUInterface->ReadByte(oldpc);
-	const m6502_t* pCPU = static_cast<m6502_t*>(state.CPUInterface->GetCPUEmulator());
+	uint16_t operandAddr = 0;
+	if (CheckJumpInstruction6502(state, pc, &operandAddr))
+		instr.bJump = true;
+	else if (CheckPointerRefInstruction6502(state, pc, &operandAddr))
+		instr.bPointerRef = true;
+	instr.OperandAddress = operandAddr;
+
+	uint8_t stepOpcode = 0;
+	instr.Opcode = state.ReadByte(pc);
+	instr.Length = (uint8_t)(M6502DisassembleGetNextPC(pc, state, stepOpcode) - pc);
+
+	switch (instr.Opcode)
+	{
+	case 0x20:	// JSR
+		instr.Flow = EInstructionFlow::Call;
+		instr.StackEffect = EInstructionStackEffect::Push;
+		instr.bStepOver = true;
+		break;
+	case 0x40:	// RTI
+	case 0x60:	// RTS
+		instr.Flow = EInstructionFlow::Return;
+		break;
+	case 0x08:	// PHP
+	case 0x48:	// PHA
+		instr.StackEffect = EInstructionStackEffect::Push;
+		break;
+	case 0x6C:	// JMP indirect - target is read from memory so can't be cached
+		return false;
+	}
 
+	return true;
+}
+
+bool RegisterCodeExecuted6502(FCodeAnalysisState& state, uint16_t pc, uint16_t oldpc, const FDecodedInstruction& instr, const FDecodedInstruction& oldInstr)
+{
 	std::vector<FCPUFunctionCall>& callStack = state.Debugger.GetCallstack();
 
-	switch (opcode)
+	switch (instr.Flow)
 	{
-		case 0x20:  // JSR
+		case EInstructionFlow::Call:  // JSR
 		{
 			FCPUFunctionCall callInfo;
 			callInfo.CallAddr = state.AddressRefFromPhysicalAddress(pc);
-			callInfo.FunctionAddr = state.AddressRefFromPhysicalAddress(state.ReadWord(pc+1));
-			callInfo.ReturnAddr = state.AddressRefFromPhysicalAddress(pc + 3);
+			callInfo.FunctionAddr = state.AddressRefFromPhysicalAddress(instr.OperandAddress);
+			callInfo.ReturnAddr = state.AddressRefFromPhysicalAddress(pc + instr.Length);
 			callStack.push_back(callInfo);
 		}
 		break;
 
-		// TODO: ret
-		case 0x40:	// RTI
-			//LOGINFO("RTI at $%04X", pc);
-		case 0x60:	// RTS
+		case EInstructionFlow::Return:	// RTI & RTS
 			if (callStack.empty() == false)
-			{
-				FCPUFunctionCall& callInfo = callStack.back();
-				//assert(callInfo.ReturnAddr == nextpc);
-
 				callStack.pop_back();
-			}
+		break;
+
+		default:
 		break;
 	}
-	bool bPushInstruction = false;
 
 	return false;
 }
-
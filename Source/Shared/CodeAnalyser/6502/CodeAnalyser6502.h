@@ -3,10 +3,12 @@
 
 class ICPUInterface;
 class FCodeAnalysisState;
+struct FDecodedInstruction;
 
 bool CheckPointerIndirectionInstruction6502(const FCodeAnalysisState& state, uint16_t pc, uint16_t* out_addr);
 bool CheckPointerRefInstruction6502(const FCodeAnalysisState& state, uint16_t pc, uint16_t* out_addr);
 bool CheckJumpInstruction6502(const FCodeAnalysisState& state, uint16_t pc, uint16_t* out_addr);
 bool CheckCallInstruction6502(const FCodeAnalysisState& state, uint16_t pc);
 bool CheckStopInstruction6502(const FCodeAnalysisState& state, uint16_t pc);
-bool RegisterCodeExecuted6502(FCodeAnalysisState& state, uint16_t pc, uint16_t oldpc);
\ No newline at end of file
+bool DecodeInstruction6502(FCodeAnalysisState& state, uint16_t pc, FDecodedInstruction& instr);
+bool RegisterCodeExecuted6502(FCodeAnalysisState& state, uint16_t pc, uint16_t oldpc, const FDecodedInstruction& instr, const FDecodedInstruction& oldInstr);
\ No newline at end of file
@@ -0,0 +1,507 @@
+#include "BreakpointCondition.h"
+
+#include "CodeAnalyser.h"
+
+#include <cctype>
+#include <cstring>
+
+// Recursive descent compiler for condition expressions
+class FConditionCompiler
+{
+public:
+	FConditionCompiler(const char* pText, ECPUType cpuType, std::vector<FConditionInstruction>& program)
+		: pCur(pText), CPUType(cpuType), Program(program) {}
+
+	bool	Compile(std::string& errorText)
+	{
+		ParseLogicalOr();
+		SkipWhitespace();
+		if (Error.empty() && *pCur != 0)
+			Error = std::string("Unexpected '") + *pCur + "'";
+		if (Error.empty() && MaxDepth > FBreakpointCondition::kMaxStackDepth)
+			Error = "Expression too complex";
+
+		errorText = Error;
+		return Error.empty();
+	}
+
+private:
+	void	SkipWhitespace()
+	{
+		while (*pCur == ' ' || *pCur == '\t')
+			pCur++;
+	}
+
+	// match an operator making sure it isn't the start of a longer one e.g. '&' vs '&&'
+	bool	MatchOp(const char* pOp, const char* pNotFollowedBy = nullptr)
+	{
+		SkipWhitespace();
+		const size_t len = strlen(pOp);
+		if (strncmp(pCur, pOp, len) != 0)
+			return false;
+		if (pNotFollowedBy != nullptr && pCur[len] != 0 && strchr(pNotFollowedBy, pCur[len]) != nullptr)
+			return false;
+		pCur += len;
+		return true;
+	}
+
+	void	Emit(EConditionOp op, int32_t operand = 0)
+	{
+		Program.push_back({ op, operand });
+
+		switch (op)
+		{
+		case EConditionOp::PushConst:
+		case EConditionOp::PushReg:
+			Depth++;
+			break;
+		case EConditionOp::ReadByte:
+		case EConditionOp::ReadWord:
+		case EConditionOp::Negate:
+		case EConditionOp::LogicalNot:
+		case EConditionOp::BitNot:
+			break;
+		default:	// binary ops pop two and push one
+			Depth--;
+			break;
+		}
+		MaxDepth = std::max(Depth, MaxDepth);
+	}
+
+	void	ParseLogicalOr()
+	{
+		ParseLogicalAnd();
+		while (Error.empty() && MatchOp("||"))
+		{
+			ParseLogicalAnd();
+			Emit(EConditionOp::LogicalOr);
+		}
+	}
+
+	void	ParseLogicalAnd()
+	{
+		ParseBitOr();
+		while (Error.empty() && MatchOp("&&"))
+		{
+			ParseBitOr();
+			Emit(EConditionOp::LogicalAnd);
+		}
+	}
+
+	void	ParseBitOr()
+	{
+		ParseBitXor();
+		while (Error.empty() && MatchOp("|", "|"))
+		{
+			ParseBitXor();
+			Emit(EConditionOp::BitOr);
+		}
+	}
+
+	void	ParseBitXor()
+	{
+		ParseBitAnd();
+		while (Error.empty() && MatchOp("^"))
+		{
+			ParseBitAnd();
+			Emit(EConditionOp::BitXor);
+		}
+	}
+
+	void	ParseBitAnd()
+	{
+		ParseEquality();
+		while (Error.empty() && MatchOp("&", "&"))
+		{
+			ParseEquality();
+			Emit(EConditionOp::BitAnd);
+		}
+	}
+
+	void	ParseEquality()
+	{
+		ParseRelational();
+		while (Error.empty())
+		{
+			if (MatchOp("=="))
+			{
+				ParseRelational();
+				Emit(EConditionOp::Equal);
+			}
+			else if (MatchOp("!="))
+			{
+				ParseRelational();
+				Emit(EConditionOp::NotEqual);
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+	void	ParseRelational()
+	{
+		ParseShift();
+		while (Error.empty())
+		{
+			EConditionOp op;
+			if (MatchOp("<=", "<"))
+				op = EConditionOp::LessEqual;
+			else if (MatchOp(">=", ">"))
+				op = EConditionOp::GreaterEqual;
+			else if (MatchOp("<", "<"))
+				op = EConditionOp::Less;
+			else if (MatchOp(">", ">"))
+				op = EConditionOp::Greater;
+			else
+				break;
+
+			ParseShift();
+			Emit(op);
+		}
+	}
+
+	void	ParseShift()
+	{
+		ParseAdditive();
+		while (Error.empty())
+		{
+			if (MatchOp("<<"))
+			{
+				ParseAdditive();
+				Emit(EConditionOp::ShiftLeft);
+			}
+			else if (MatchOp(">>"))
+			{
+				ParseAdditive();
+				Emit(EConditionOp::ShiftRight);
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+	void	ParseAdditive()
+	{
+		ParseMultiplicative();
+		while (Error.empty())
+		{
+			if (MatchOp("+"))
+			{
+				ParseMultiplicative();
+				Emit(EConditionOp::Add);
+			}
+			else if (MatchOp("-"))
+			{
+				ParseMultiplicative();
+				Emit(EConditionOp::Sub);
+			}
+			else
+			{
+				break;
+			}
+		}
+	}
+
+	void	ParseMultiplicative()
+	{
+		ParseUnary();
+		while (Error.empty())
+		{
+			EConditionOp op;
+			if (MatchOp("*"))
+				op = EConditionOp::Mul;
+			else if (MatchOp("/"))
+				op = EConditionOp::Div;
+			else if (MatchOp("%"))
+				op = EConditionOp::Mod;
+			else
+				break;
+
+			ParseUnary();
+			Emit(op);
+		}
+	}
+
+	void	ParseUnary()
+	{
+		if (MatchOp("-"))
+		{
+			ParseUnary();
+			Emit(EConditionOp::Negate);
+		}
+		else if (MatchOp("!", "="))
+		{
+			ParseUnary();
+			Emit(EConditionOp::LogicalNot);
+		}
+		else if (MatchOp("~"))
+		{
+			ParseUnary();
+			Emit(EConditionOp::BitNot);
+		}
+		else
+		{
+			ParsePrimary();
+		}
+	}
+
+	void	ParsePrimary()
+	{
+		SkipWhitespace();
+
+		if (MatchOp("("))
+		{
+			ParseLogicalOr();
+			if (Error.empty() && MatchOp(")") == false)
+				Error = "Missing ')'";
+			return;
+		}
+
+		// memory reads
+		const bool bWordRead = (pCur[0] == 'w' || pCur[0] == 'W') && pCur[1] == '[';
+		if (bWordRead)
+			pCur++;
+		if (MatchOp("["))
+		{
+			ParseLogicalOr();
+			if (Error.empty() && MatchOp("]") == false)
+				Error = "Missing ']'";
+			Emit(bWordRead ? EConditionOp::ReadWord : EConditionOp::ReadByte);
+			return;
+		}
+
+		if (isdigit((unsigned char)*pCur) || *pCur == '$')
+		{
+			ParseNumber();
+			return;
+		}
+
+		if (isalpha((unsigned char)*pCur))
+		{
+			ParseRegister();
+			return;
+		}
+
+		Error = *pCur == 0 ? std::string("Unexpected end of expression") : std::string("Unexpected '") + *pCur + "'";
+	}
+
+	void	ParseNumber()
+	{
+		int base = 10;
+		if (*pCur == '$')
+		{
+			base = 16;
+			pCur++;
+		}
+		else if (pCur[0] == '0' && (pCur[1] == 'x' || pCur[1] == 'X'))
+		{
+			base = 16;
+			pCur += 2;
+		}
+
+		char* pEnd = nullptr;
+		const long val = strtol(pCur, &pEnd, base);
+		if (pEnd == pCur)
+		{
+			Error = "Bad number";
+			return;
+		}
+		pCur = pEnd;
+		Emit(EConditionOp::PushConst, (int32_t)val);
+	}
+
+	void	ParseRegister()
+	{
+		char name[8] = { 0 };
+		int len = 0;
+		while (isalnum((unsigned char)*pCur))
+		{
+			if (len < (int)sizeof(name) - 1)
+				name[len++] = (char)tolower((unsigned char)*pCur);
+			pCur++;
+		}
+
+		struct FRegName
+		{
+			const char*		Name;
+			EConditionReg	Reg;
+		};
+
+		static const FRegName z80Regs[] =
+		{
+			{"pc", EConditionReg::PC},
+			{"a", EConditionReg::A}, {"f", EConditionReg::F}, {"b", EConditionReg::B}, {"c", EConditionReg::C},
+			{"d", EConditionReg::D}, {"e", EConditionReg::E}, {"h", EConditionReg::H}, {"l", EConditionReg::L},
+			{"i", EConditionReg::I}, {"r", EConditionReg::R},
+			{"af", EConditionReg::AF}, {"bc", EConditionReg::BC}, {"de", EConditionReg::DE}, {"hl", EConditionReg::HL},
+			{"ix", EConditionReg::IX}, {"iy", EConditionReg::IY}, {"sp", EConditionReg::SP},
+		};
+
+		static const FRegName m6502Regs[] =
+		{
+			{"pc", EConditionReg::PC},
+			{"a", EConditionReg::A}, {"x", EConditionReg::X}, {"y", EConditionReg::Y},
+			{"s", EConditionReg::S}, {"p", EConditionReg::P},
+		};
+
+		const FRegName* pRegs = CPUType == ECPUType::M6502 ? m6502Regs : z80Regs;
+		const int noRegs = CPUType == ECPUType::M6502 ? (int)(sizeof(m6502Regs) / sizeof(FRegName)) : (int)(sizeof(z80Regs) / sizeof(FRegName));
+
+		for (int i = 0; i < noRegs; i++)
+		{
+			if (strcmp(pRegs[i].Name, name) == 0)
+			{
+				Emit(EConditionOp::PushReg, (int32_t)pRegs[i].Reg);
+				return;
+			}
+		}
+
+		Error = std::string("Unknown register '") + name + "'";
+	}
+
+	const char*		pCur;
+	ECPUType		CPUType;
+	std::vector<FConditionInstruction>&	Program;
+	std::string		Error;
+	int				Depth = 0;
+	int				MaxDepth = 0;
+};
+
+bool FBreakpointCondition::Compile(const char* pText, ECPUType cpuType)
+{
+	Clear();
+
+	// empty condition means always
+	const char* pCheck = pText;
+	while (*pCheck == ' ' || *pCheck == '\t')
+		pCheck++;
+	if (*pCheck == 0)
+		return true;
+
+	FConditionCompiler compiler(pText, cpuType, Program);
+	if (compiler.Compile(ErrorText) == false)
+	{
+		Program.clear();
+		return false;
+	}
+
+	return true;
+}
+
+static int32_t GetConditionRegister(const FConditionContext& context, EConditionReg reg)
+{
+	if (reg == EConditionReg::PC)
+		return context.PC;
+
+	if (context.CPUType == ECPUType::Z80)
+	{
+		const z80_t& cpu = *context.pZ80;
+		switch (reg)
+		{
+		case EConditionReg::A:	return cpu.a;
+		case EConditionReg::F:	return cpu.f;
+		case EConditionReg::B:	return cpu.b;
+		case EConditionReg::C:	return cpu.c;
+		case EConditionReg::D:	return cpu.d;
+		case EConditionReg::E:	return cpu.e;
+		case EConditionReg::H:	return cpu.h;
+		case EConditionReg::L:	return cpu.l;
+		case EConditionReg::I:	return cpu.i;
+		case EConditionReg::R:	return cpu.r;
+		case EConditionReg::AF:	return cpu.af;
+		case EConditionReg::BC:	return cpu.bc;
+		case EConditionReg::DE:	return cpu.de;
+		case EConditionReg::HL:	return cpu.hl;
+		case EConditionReg::IX:	return cpu.ix;
+		case EConditionReg::IY:	return cpu.iy;
+		case EConditionReg::SP:	return cpu.sp;
+		default: break;
+		}
+	}
+	else if (context.CPUType == ECPUType::M6502)
+	{
+		const m6502_t& cpu = *context.pM6502;
+		switch (reg)
+		{
+		case EConditionReg::A:	return cpu.A;
+		case EConditionReg::X:	return cpu.X;
+		case EConditionReg::Y:	return cpu.Y;
+		case EConditionReg::S:	return cpu.S;
+		case EConditionReg::P:	return cpu.P;
+		default: break;
+		}
+	}
+
+	return 0;
+}
+
+// values are unsigned so arithmetic wraps rather than overflowing, they're compared & divided as signed
+int32_t FBreakpointCondition::Evaluate(const FConditionContext& context) const
+{
+	uint32_t stack[kMaxStackDepth];
+	int sp = 0;
+
+	for (const FConditionInstruction& instr : Program)
+	{
+		switch (instr.Op)
+		{
+		case EConditionOp::PushConst:
+			stack[sp++] = (uint32_t)instr.Operand;
+			break;
+		case EConditionOp::PushReg:
+			stack[sp++] = (uint32_t)GetConditionRegister(context, (EConditionReg)instr.Operand);
+			break;
+		case EConditionOp::ReadByte:
+			stack[sp - 1] = context.pCodeAnalysis->ReadByte((uint16_t)stack[sp - 1]);
+			break;
+		case EConditionOp::ReadWord:
+			stack[sp - 1] = context.pCodeAnalysis->ReadWord((uint16_t)stack[sp - 1]);
+			break;
+		case EConditionOp::Negate:
+			stack[sp - 1] = 0u - stack[sp - 1];
+			break;
+		case EConditionOp::LogicalNot:
+			stack[sp - 1] = stack[sp - 1] == 0;
+			break;
+		case EConditionOp::BitNot:
+			stack[sp - 1] = ~stack[sp - 1];
+			break;
+		default:
+		{
+			const uint32_t rhs = stack[--sp];
+			uint32_t& lhs = stack[sp - 1];
+			const int64_t signedLhs = (int32_t)lhs;	// 64 bit so INT_MIN / -1 doesn't overflow
+			const int64_t signedRhs = (int32_t)rhs;
+			switch (instr.Op)
+			{
+			case EConditionOp::Mul:				lhs = lhs * rhs; break;
+			case EConditionOp::Div:				lhs = rhs != 0 ? (uint32_t)(signedLhs / signedRhs) : 0; break;
+			case EConditionOp::Mod:				lhs = rhs != 0 ? (uint32_t)(signedLhs % signedRhs) : 0; break;
+			case EConditionOp::Add:				lhs = lhs + rhs; break;
+			case EConditionOp::Sub:				lhs = lhs - rhs; break;
+			case EConditionOp::ShiftLeft:		lhs = lhs << (rhs & 31); break;
+			case EConditionOp::ShiftRight:		lhs = (uint32_t)(signedLhs >> (rhs & 31)); break;
+			case EConditionOp::Less:			lhs = signedLhs < signedRhs; break;
+			case EConditionOp::LessEqual:		lhs = signedLhs <= signedRhs; break;
+			case EConditionOp::Greater:			lhs = signedLhs > signedRhs; break;
+			case EConditionOp::GreaterEqual:	lhs = signedLhs >= signedRhs; break;
+			case EConditionOp::Equal:			lhs = lhs == rhs; break;
+			case EConditionOp::NotEqual:		lhs = lhs != rhs; break;
+			case EConditionOp::BitAnd:			lhs = lhs & rhs; break;
+			case EConditionOp::BitXor:			lhs = lhs ^ rhs; break;
+			case EConditionOp::BitOr:			lhs = lhs | rhs; break;
+			case EConditionOp::LogicalAnd:		lhs = lhs != 0 && rhs != 0; break;
+			case EConditionOp::LogicalOr:		lhs = lhs != 0 || rhs != 0; break;
+			default: break;
+			}
+		}
+		break;
+		}
+	}
+
+	return sp > 0 ? (int32_t)stack[sp - 1] : 1;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CodeAnalyserTypes.h"
+
+#include <chips/z80.h>
+#include <chips/m6502.h>
+#include <string>
+#include <vector>
+
+class FCodeAnalysisState;
+
+// Breakpoint conditions
+// These are compiled once into a small stack based program so they are cheap enough to evaluate on every hit
+//
+// Syntax is C like:
+//	numbers		: 123, $7f, 0x7f
+//	registers	: Z80 - a f b c d e h l i r af bc de hl ix iy sp pc, 6502 - a x y s p pc
+//	memory		: [addr] for a byte, w[addr] for a little endian word
+//	operators	: ( ) ! ~ - * / % + - << >> < <= > >= == != & ^ | && ||
+// e.g. "a == $10 && [hl] != 0"
+
+enum class EConditionOp : uint8_t
+{
+	PushConst,
+	PushReg,
+	ReadByte,
+	ReadWord,
+
+	// unary
+	Negate,
+	LogicalNot,
+	BitNot,
+
+	// binary
+	Mul,
+	Div,
+	Mod,
+	Add,
+	Sub,
+	ShiftLeft,
+	ShiftRight,
+	Less,
+	LessEqual,
+	Greater,
+	GreaterEqual,
+	Equal,
+	NotEqual,
+	BitAnd,
+	BitXor,
+	BitOr,
+	LogicalAnd,
+	LogicalOr,
+};
+
+enum class EConditionReg : uint8_t
+{
+	PC,
+
+	// Z80
+	A, F, B, C, D, E, H, L, I, R,
+	AF, BC, DE, HL, IX, IY, SP,
+
+	// 6502
+	X, Y, S, P,
+};
+
+struct FConditionInstruction
+{
+	EConditionOp	Op;
+	int32_t			Operand;
+};
+
+// What a condition needs to read machine state
+struct FConditionContext
+{
+	ECPUType					CPUType = ECPUType::Unknown;
+	const z80_t*				pZ80 = nullptr;
+	const m6502_t*				pM6502 = nullptr;
+	const FCodeAnalysisState*	pCodeAnalysis = nullptr;
+	uint16_t					PC = 0;
+};
+
+class FBreakpointCondition
+{
+public:
+	bool	Compile(const char* pText, ECPUType cpuType);
+	void	Clear() { Program.clear(); ErrorText.clear(); }
+
+	bool	IsEmpty() const { return Program.empty(); }
+	bool	HasError() const { return ErrorText.empty() == false; }
+	const std::string& GetErrorText() const { return ErrorText; }
+
+	int32_t	Evaluate(const FConditionContext& context) const;
+
+	static const int kMaxStackDepth = 32;
+
+private:
+	std::vector<FConditionInstruction>	Program;
+	std::string							ErrorText;
+};
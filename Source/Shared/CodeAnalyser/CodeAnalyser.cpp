@@ -10,6 +10,7 @@
 
 #include "Util/Misc.h"
 #include "Util/GraphicsView.h"
+#include "Util/MemorySearch.h"
 #include "UI/ImageViewer.h"
 
 #include "Z80/CodeAnalyserZ80.h"
@@ -251,11 +252,13 @@ bool FCodeAnalysisState::FindMemoryPatternInPhysicalMemory(uint8_t* pData, size_
 	return false;
 }*/
 
-std::vector<FAddressRef> FCodeAnalysisState::FindAllMemoryPatterns(uint8_t* pData, size_t dataSize, bool bROM, bool bPhysicalOnly)
+std::vector<FAddressRef> FCodeAnalysisState::FindAllMemoryPatterns(const uint8_t* pData, size_t dataSize, bool bROM, bool bPhysicalOnly, const uint8_t* pMask)
 {
 	std::vector<FAddressRef> results;
-	// iterate through banks
-	for (auto& bank : Banks)
+	std::vector<const FCodeAnalysisBank*> searchBanks;
+	std::vector<FMemoryBlock> searchBlocks;
+
+	for (const auto& bank : Banks)
 	{
 		if (bank.bReadOnly && bROM == false)
 			continue;
@@ -263,25 +266,23 @@ std::vector<FAddressRef> FCodeAnalysisState::FindAllMemoryPatterns(uint8_t* pDat
 		if (bank.IsMapped() == false && bPhysicalOnly)
 			continue;
 
-		const int bankByteSize = bank.GetSizeBytes();
-		for (int bAddr = 0; bAddr < bankByteSize - dataSize; bAddr++)
-		{
-			bool bFound = true;
-			for (int byteNo = 0; byteNo < dataSize; byteNo++)
-			{
-				const uint8_t byte = bank.Memory[bAddr + byteNo];
-				if (byte != pData[byteNo])
-				{
-					bFound = false;
-					break;
-				}
-			}
+		searchBanks.push_back(&bank);
+		searchBlocks.push_back({ bank.Memory, (size_t)bank.GetSizeBytes() });
+	}
 
-			if (bFound)
-			{
-				results.push_back(FAddressRef(bank.Id, bAddr + bank.GetMappedAddress()));
-			}
-		}
+	FMemoryPattern pattern;
+	pattern.pBytes = pData;
+	pattern.pMask = pMask;
+	pattern.Size = dataSize;
+
+	std::vector<std::vector<uint32_t>> bankMatches;
+	FindPatternMatchesInBlocks(searchBlocks, pattern, bankMatches);
+
+	for (size_t bankNo = 0; bankNo < searchBanks.size(); bankNo++)
+	{
+		const FCodeAnalysisBank* pBank = searchBanks[bankNo];
+		for (const uint32_t bankAddr : bankMatches[bankNo])
+			results.push_back(FAddressRef(pBank->Id, bankAddr + pBank->GetMappedAddress()));
 	}
 
 	return results;	
@@ -337,92 +338,79 @@ bool IsValidStringChar(char c)
 	return IsAlphanumeric(c) || IsPunctuation(c);
 }
 
+// strings come from the memory analyser's cache, this brings it up to date first
 std::vector<FFoundString> FCodeAnalysisState::FindAllStrings(bool bROM, bool bPhysicalOnly)
 {
 	std::vector<FFoundString> results;
+	FStringCache& stringCache = MemoryAnalyser.GetStringCache();
 
-	for (auto& bank : Banks)
-	{
-		if (bank.bReadOnly && bROM == false)
-			continue;
-
-		if (bank.IsMapped() == false && bPhysicalOnly)
-			continue;
+	stringCache.Update(true);
+	stringCache.GetStrings(results, bROM, bPhysicalOnly);
+	return results;
+}
 
-		FAddressRef stringStart;	
-		int stringLength = 0;
-		int vowelCount = 0;
-		std::string foundString;
+uint32_t FCodeAnalysisState::GetLinesWrittenSince(const FCodeAnalysisPage& page, uint32_t token) const
+{
+	if (HasPageBeenWrittenSince(page, token) == false)
+		return 0;
 
-		const int bankByteSize = bank.GetSizeBytes();
-		int stringStartBankPos = 0;
-		
-		for(int bAddr = 0; bAddr < bankByteSize;bAddr++)
-		{
-			FAddressRef addressRef(bank.Id, bank.GetMappedAddress() + bAddr);
-			char c = bank.Memory[bAddr];
-			bool bTerminated = false;
-
-			// Check for code & skip
-			const FCodeInfo* pCodeInfo = GetCodeInfoForAddress(addressRef);
-			if (pCodeInfo != nullptr)
-				continue;
-
-			// check data
-			const FDataInfo* pDataInfo = GetDataInfoForAddress(addressRef);
-			if (pDataInfo->DataType != EDataType::Byte && pDataInfo->DataType != EDataType::Text)
-				continue;
-			if (pDataInfo->LastFrameWritten != -1)
-				continue;
-
-			if (c & (1 << 7))	// high bit terminated strings
-			{
-				c = c & ~(1 << 7);
-				bTerminated = true;
-			}
+	uint32_t lines = 0;
+	for (int lineNo = 0; lineNo < FCodeAnalysisPage::kNoWriteLines; lineNo++)
+	{
+		if (page.LineWriteGenerations[lineNo] > token)
+			lines |= 1 << lineNo;
+	}
+	return lines;
+}
 
-			if(IsValidStringChar(c))
-			{
-				if (stringStart.IsValid() == false)	// string start
-				{
-					stringStart = addressRef;
-					stringStartBankPos = bAddr;
-					stringLength = 0;
-				}
+// is any of the range in the lines written since the token was taken
+static bool HasPageRangeBeenWrittenSince(const FCodeAnalysisPage& page, int pageOffset, int noBytes, uint32_t token)
+{
+	if (page.WriteGeneration <= token)
+		return false;
 
-				stringLength++;
-				if (IsVowel(c))
-					vowelCount++;
-				foundString.push_back(c);
+	const int lastLine = (pageOffset + noBytes - 1) >> FCodeAnalysisPage::kWriteLineShift;
+	for (int lineNo = pageOffset >> FCodeAnalysisPage::kWriteLineShift; lineNo <= lastLine; lineNo++)
+	{
+		if (page.LineWriteGenerations[lineNo] > token)
+			return true;
+	}
+	return false;
+}
 
-				//if (stringLength == 4 && vowelCount == 0)	// string of 4 chars must have a vowel
-				//	bTerminated = true;
-			}
-			else
-			{
-				bTerminated = true;
-			}
+bool FCodeAnalysisState::HasMemoryBeenWrittenSince(FAddressRef addr, int noBytes, uint32_t token) const
+{
+	const FCodeAnalysisBank* pBank = GetBank(addr.BankId);
+	if (pBank == nullptr)
+		return false;
 
-			if(bTerminated && foundString.empty() == false)
-			{
-				// Run through (simple) acceptance filter
-				if (stringLength > 2 && vowelCount > 0)
-				{
-					results.push_back({ stringStart, foundString });
-				}
-				else
-				{
-					bAddr = stringStartBankPos;	// wind back to start of string
-				}
-				stringStart.SetInvalid();;
-				stringLength = 0;
-				vowelCount = 0;
-				foundString.clear();
-			}
-		}
+	int bankOffset = (uint16_t)(addr.Address - pBank->GetMappedAddress());
+	const int bankEnd = std::min(bankOffset + noBytes, (int)pBank->GetSizeBytes());
+	while (bankOffset < bankEnd)
+	{
+		const int pageOffset = bankOffset & FCodeAnalysisPage::kPageMask;
+		const int noPageBytes = std::min(FCodeAnalysisPage::kPageSize - pageOffset, bankEnd - bankOffset);
+		if (HasPageRangeBeenWrittenSince(pBank->Pages[bankOffset >> FCodeAnalysisPage::kPageShift], pageOffset, noPageBytes, token))
+			return true;
+		bankOffset += noPageBytes;
 	}
+	return false;
+}
 
-	return results;
+bool FCodeAnalysisState::HasMemoryBeenWrittenSince(uint16_t physAddr, int noBytes, uint32_t token) const
+{
+	int addr = physAddr;
+	const int endAddr = std::min(addr + noBytes, 1 << 16);
+	while (addr < endAddr)
+	{
+		const int pageOffset = addr & kPageMask;
+		const int noPageBytes = std::min(FCodeAnalysisPage::kPageSize - pageOffset, endAddr - addr);
+		const FCodeAnalysisPage* pPage = GetReadPage((uint16_t)addr);
+		if (pPage != nullptr && HasPageRangeBeenWrittenSince(*pPage, pageOffset, noPageBytes, token))
+			return true;
+		addr += noPageBytes;
+	}
+	return false;
 }
 
 #if 0
@@ -563,7 +551,7 @@ FLabelInfo* GenerateLabelForAddress(FCodeAnalysisState &state, FAddressRef addre
 		return pLabel;
 
 		
-	pLabel = FLabelInfo::Allocate();
+	pLabel = FLabelInfo::Allocate(state.GetLabelNames());
 	pLabel->LabelType = labelType;
 	//pLabel->Address = address;
 	pLabel->ByteSize = 0;
@@ -615,8 +603,6 @@ FLabelInfo* GenerateLabelForAddress(FCodeAnalysisState &state, FAddressRef addre
 	}
 
 	pLabel->InitialiseName(label);
-	if (pLabel->Global)
-		GenerateGlobalInfo(state);
 	state.SetLabelForAddress(address, pLabel);
 	state.SetCodeAnalysisDirty(address);
 	return pLabel;	
@@ -629,6 +615,7 @@ void UpdateCodeInfoForAddress(FCodeAnalysisState &state, uint16_t pc)
 		return;
 
 	pCodeInfo->bIsCall = CheckCallInstruction(state, pc);
+	pCodeInfo->Decoded.bValid = false;
 
 	if (state.CPUInterface->CPUType == ECPUType::Z80)
 		Z80DisassembleCodeInfoItem(pc, state, pCodeInfo);
@@ -645,6 +632,7 @@ uint16_t WriteCodeInfoForAddress(FCodeAnalysisState &state, uint16_t pc)
 		pCodeInfo = FCodeInfo::Allocate();
 		state.SetCodeInfoForAddress(pc, pCodeInfo);
 	}	
+	pCodeInfo->Decoded.bValid = false;
 
 	// does this function branch?
 	uint16_t jumpAddr;
@@ -711,17 +699,59 @@ uint16_t WriteCodeInfoForAddress(FCodeAnalysisState &state, uint16_t pc)
 	return newPC;
 }
 
+// does memory still hold the instruction bytes the decode was made from
+static bool DoesDecodeMatchMemory(FCodeAnalysisState& state, uint16_t pc, const FDecodedInstruction& decoded)
+{
+	for (int byteNo = 0; byteNo < decoded.Length; byteNo++)
+	{
+		if (decoded.Bytes[byteNo] != state.ReadByte(pc + byteNo))
+			return false;
+	}
+	return true;
+}
+
+// Get the execution info for an instruction, using the code info's cached copy when it's still valid
+FDecodedInstruction GetDecodedInstruction(FCodeAnalysisState& state, uint16_t pc, FCodeInfo* pCodeInfo)
+{
+	// comparing all the bytes catches self modified operands & memory that's been changed without going through the analyser
+	if (pCodeInfo != nullptr && pCodeInfo->Decoded.bValid && DoesDecodeMatchMemory(state, pc, pCodeInfo->Decoded))
+		return pCodeInfo->Decoded;
+
+	FDecodedInstruction decoded;
+	bool bCacheable = false;
+	if (state.CPUInterface->CPUType == ECPUType::Z80)
+		bCacheable = DecodeInstructionZ80(state, pc, decoded);
+	else if (state.CPUInterface->CPUType == ECPUType::M6502)
+		bCacheable = DecodeInstruction6502(state, pc, decoded);
+
+	if (pCodeInfo != nullptr && bCacheable && decoded.Length <= sizeof(decoded.Bytes))
+	{
+		for (int byteNo = 0; byteNo < decoded.Length; byteNo++)
+			decoded.Bytes[byteNo] = state.ReadByte(pc + byteNo);
+		pCodeInfo->Decoded = decoded;
+		pCodeInfo->Decoded.bValid = true;
+	}
+
+	return decoded;
+}
+
+FDecodedInstruction GetDecodedInstruction(FCodeAnalysisState& state, uint16_t pc)
+{
+	return GetDecodedInstruction(state, pc, state.GetCodeInfoForAddress(pc));
+}
+
 // return if we should continue
 bool AnalyseAtPC(FCodeAnalysisState &state, uint16_t& pc)
 {
 	FCodeInfo* pCodeInfo = state.GetCodeInfoForAddress(pc);
+	const FDecodedInstruction decoded = GetDecodedInstruction(state, pc, pCodeInfo);
 
 	// Register Code accesses
 	// 
 	// set jump reference
-	uint16_t jumpPhysAddr;
-	if (CheckJumpInstruction(state, pc, &jumpPhysAddr))
+	if (decoded.bJump)
 	{
+		const uint16_t jumpPhysAddr = decoded.OperandAddress;
 		const FAddressRef jumpAddr = state.AddressRefFromPhysicalAddress(jumpPhysAddr);
 		assert(state.IsAddressValid(jumpAddr));
 
@@ -734,9 +764,9 @@ bool AnalyseAtPC(FCodeAnalysisState &state, uint16_t& pc)
 	}
 
 	// set pointer reference
-	uint16_t ptr;
-	if (CheckPointerRefInstruction(state, pc, &ptr))
+	if (decoded.bPointerRef)
 	{
+		const uint16_t ptr = decoded.OperandAddress;
 		FLabelInfo* pLabel = state.GetLabelForPhysicalAddress(ptr); // NOTE: we have to use the physical address because of banks mapped twice
 		if (pLabel != nullptr)
 			pLabel->References.RegisterAccess(state.AddressRefFromPhysicalAddress(pc));
@@ -753,8 +783,7 @@ bool AnalyseAtPC(FCodeAnalysisState &state, uint16_t& pc)
 			pCodeInfo->bSelfModifyingCode = false;
 			for(uint16_t operandAddr = 0;operandAddr<pCodeInfo->ByteSize;operandAddr++)
 			{
-				FDataInfo* pOpDataInfo = state.GetReadDataInfoForAddress(pc + operandAddr);
-				if(pOpDataInfo->Writes.IsEmpty() == false)
+				if(state.GetReadDataReferencesForAddress(pc + operandAddr).Writes.IsEmpty() == false)
 				{
 					pCodeInfo->bSelfModifyingCode = true;
 				}					
@@ -789,6 +818,9 @@ void AnalyseFromPC(FCodeAnalysisState &state, uint16_t pc)
 
 bool RegisterCodeExecuted(FCodeAnalysisState &state, uint16_t pc, uint16_t oldpc)
 {
+	if (state.bRegisterCodeExecution == false)
+		return false;
+
 	AnalyseAtPC(state, pc);
 
 	FCodeInfo* pCodeInfo = state.GetCodeInfoForAddress(pc);
@@ -798,10 +830,14 @@ bool RegisterCodeExecuted(FCodeAnalysisState &state, uint16_t pc, uint16_t oldpc
 		pCodeInfo->ExecutionCount++;
 	}
 
+	// AnalyseAtPC will have filled in the cache
+	const FDecodedInstruction decoded = GetDecodedInstruction(state, pc, pCodeInfo);
+	const FDecodedInstruction oldDecoded = GetDecodedInstruction(state, oldpc);
+
 	if (state.CPUInterface->CPUType == ECPUType::Z80)
-		return RegisterCodeExecutedZ80(state, pc, oldpc);
+		return RegisterCodeExecutedZ80(state, pc, oldpc, decoded, oldDecoded);
 	else if (state.CPUInterface->CPUType == ECPUType::M6502)
-		return RegisterCodeExecuted6502(state, pc, oldpc);
+		return RegisterCodeExecuted6502(state, pc, oldpc, decoded, oldDecoded);
 
 	return false;
 }
@@ -822,19 +858,22 @@ void RegisterDataRead(FCodeAnalysisState& state, uint16_t pc, uint16_t dataAddr)
 
 	if (state.GetCodeInfoForAddress(dataAddr) == nullptr)	// don't register instruction data reads
 	{
-		FDataInfo* pDataInfo = state.GetReadDataInfoForAddress(dataAddr);
-		pDataInfo->ReadCount++;
-		pDataInfo->LastFrameRead = state.CurrentFrameNo;
-		pDataInfo->Reads.RegisterAccess(state.AddressRefFromPhysicalAddress(pc));
+		FCodeAnalysisPage* pPage = state.GetReadPage(dataAddr);
+		const uint16_t pageAddr = dataAddr & FCodeAnalysisPage::kPageMask;
+		pPage->DataAccesses.ReadCount[pageAddr]++;
+		pPage->DataAccesses.LastFrameRead[pageAddr] = state.CurrentFrameNo;
+		pPage->AddDataReferences(pageAddr).Reads.RegisterAccess(state.AddressRefFromPhysicalAddress(pc));
 	}
 }
 
 void RegisterDataWrite(FCodeAnalysisState &state, uint16_t pc,uint16_t dataAddr,uint8_t value)
 {
-	FDataInfo* pDataInfo = state.GetWriteDataInfoForAddress(dataAddr);
-	pDataInfo->WriteCount++;
-	pDataInfo->LastFrameWritten = state.CurrentFrameNo;
-	pDataInfo->Writes.RegisterAccess(state.AddressRefFromPhysicalAddress(pc));
+	FCodeAnalysisPage* pPage = state.GetWritePage(dataAddr);
+	const uint16_t pageAddr = dataAddr & FCodeAnalysisPage::kPageMask;
+	pPage->DataAccesses.WriteCount[pageAddr]++;
+	pPage->DataAccesses.LastFrameWritten[pageAddr] = state.CurrentFrameNo;
+	FDataInfo* pDataInfo = &pPage->DataInfo[pageAddr];
+	pPage->AddDataReferences(pageAddr).Writes.RegisterAccess(state.AddressRefFromPhysicalAddress(pc));
 
 	// check for SMC
 	if (pDataInfo->DataType == EDataType::InstructionOperand)
@@ -842,7 +881,10 @@ void RegisterDataWrite(FCodeAnalysisState &state, uint16_t pc,uint16_t dataAddr,
 		// TODO: record some info such as what byte was written
 		FCodeInfo* pCodeWrittenTo = state.GetCodeInfoForAddress(pDataInfo->InstructionAddress);
 		if (pCodeWrittenTo != nullptr)	// sometime data can be malformed so do a defensive check
+		{
 			pCodeWrittenTo->bSelfModifyingCode = true;
+			pCodeWrittenTo->Decoded.bValid = false;
+		}
 	}
 }
 
@@ -863,7 +905,7 @@ void ReAnalyseCode(FCodeAnalysisState &state)
 				pOperandData->ByteSize = 1;
 				pOperandData->DataType = EDataType::InstructionOperand;
 				pOperandData->InstructionAddress = state.AddressRefFromPhysicalAddress(addr);
-				if (pOperandData->Writes.IsEmpty() == false)
+				if (state.GetReadDataReferencesForAddress(addr + i).Writes.IsEmpty() == false)
 					pCodeInfo->bSelfModifyingCode = true;
 				if (i > 0)	// make sure other entries after are null
 					state.SetCodeInfoForAddress(addr + i, nullptr);
@@ -890,13 +932,14 @@ void ResetReferenceInfo(FCodeAnalysisState &state)
 {
 	for (int i = 0; i < (1 << 16); i++)
 	{
-		FDataInfo* pDataInfo = state.GetReadDataInfoForAddress(i);
-		if (pDataInfo != nullptr)
+		FCodeAnalysisPage* pPage = state.GetReadPage(i);
+		if (pPage != nullptr)
 		{
-			pDataInfo->LastFrameRead = -1;
-			pDataInfo->Reads.Reset();
-			pDataInfo->LastFrameWritten = -1;
-			pDataInfo->Writes.Reset();
+			const uint16_t pageAddr = i & FCodeAnalysisPage::kPageMask;
+			pPage->DataAccesses.LastFrameRead[pageAddr] = -1;
+			pPage->DataAccesses.LastFrameWritten[pageAddr] = -1;
+			if (pageAddr == 0)	// every address in the page gets visited
+				pPage->ResetDataReferences();
 		}
 
 		FLabelInfo* pLabelInfo = state.GetLabelForPhysicalAddress(i);
@@ -912,7 +955,7 @@ void ResetReferenceInfo(FCodeAnalysisState &state)
 // TODO: Phase this out
 FLabelInfo* AddLabel(FCodeAnalysisState &state, uint16_t address,const char *name,ELabelType type)
 {
-	FLabelInfo *pLabel = FLabelInfo::Allocate();
+	FLabelInfo *pLabel = FLabelInfo::Allocate(state.GetLabelNames());
 	pLabel->InitialiseName(name);
 	pLabel->LabelType = type;
 	//pLabel->Address = address;
@@ -920,15 +963,12 @@ FLabelInfo* AddLabel(FCodeAnalysisState &state, uint16_t address,const char *nam
 	pLabel->Global = type == ELabelType::Function;
 	state.SetLabelForPhysicalAddress(address, pLabel);
 
-	if (pLabel->Global)
-		GenerateGlobalInfo(state);
-
 	return pLabel;
 }
 
 FLabelInfo* AddLabel(FCodeAnalysisState& state, FAddressRef address, const char* name, ELabelType type)
 {
-	FLabelInfo* pLabel = FLabelInfo::Allocate();
+	FLabelInfo* pLabel = FLabelInfo::Allocate(state.GetLabelNames());
 	pLabel->InitialiseName(name);
 	pLabel->LabelType = type;
 	//pLabel->Address = address;
@@ -936,9 +976,6 @@ FLabelInfo* AddLabel(FCodeAnalysisState& state, FAddressRef address, const char*
 	pLabel->Global = type == ELabelType::Function;
 	state.SetLabelForAddress(address, pLabel);
 
-	if (pLabel->Global)
-		GenerateGlobalInfo(state);
-
 	return pLabel;
 }
 
@@ -1006,10 +1043,80 @@ void GenerateGlobalInfo(FCodeAnalysisState &state)
 		
 	}*/
 
+	// keep in address ref order for UpdateGlobalLabelIndex
+	auto addressOrder = [](const FCodeAnalysisItem& a, const FCodeAnalysisItem& b) { return a.AddressRef < b.AddressRef; };
+	std::sort(state.GlobalDataItems.begin(), state.GlobalDataItems.end(), addressOrder);
+	std::sort(state.GlobalFunctions.begin(), state.GlobalFunctions.end(), addressOrder);
+
 	state.bRebuildFilteredGlobalDataItems = true;
 	state.bRebuildFilteredGlobalFunctions = true;
 }
 
+// Put the label in or take it out of an ordered global list, returns true if the list changed
+static bool UpdateGlobalItemList(std::vector<FCodeAnalysisItem>& itemList, FAddressRef addrRef, FLabelInfo* pLabel)
+{
+	auto it = std::lower_bound(itemList.begin(), itemList.end(), addrRef,
+		[](const FCodeAnalysisItem& item, FAddressRef addr) { return item.AddressRef < addr; });
+	const bool bInList = it != itemList.end() && it->AddressRef == addrRef;
+
+	if (pLabel == nullptr)
+	{
+		if (bInList == false)
+			return false;
+		itemList.erase(it);
+	}
+	else if (bInList)
+	{
+		if (it->Item == pLabel)
+			return false;
+		it->Item = pLabel;
+	}
+	else
+	{
+		itemList.insert(it, FCodeAnalysisItem(pLabel, addrRef));
+	}
+
+	return true;
+}
+
+void FCodeAnalysisState::UpdateGlobalLabelIndex(FAddressRef addrRef)
+{
+	const FCodeAnalysisBank* pBank = GetBank(addrRef.BankId);
+	if (pBank == nullptr || pBank->PrimaryMappedPage == -1)	// only mapped banks go in the global lists
+		return;
+
+	// regenerate at the end of the batch, or now if the address isn't in the bank's primary mapping
+	if (GlobalLabelBatchDepth > 0)
+	{
+		bGlobalLabelIndexDirty = true;
+		return;
+	}
+	if (pBank->AddressValid(addrRef.Address) == false)
+	{
+		GenerateGlobalInfo(*this);
+		return;
+	}
+
+	FLabelInfo* pLabel = GetLabelForAddress(addrRef);
+	FLabelInfo* pGlobalData = pLabel != nullptr && pLabel->LabelType == ELabelType::Data && pLabel->Global ? pLabel : nullptr;
+	FLabelInfo* pFunction = pLabel != nullptr && pLabel->LabelType == ELabelType::Function ? pLabel : nullptr;
+
+	if (UpdateGlobalItemList(GlobalDataItems, addrRef, pGlobalData))
+		bRebuildFilteredGlobalDataItems = true;
+	if (UpdateGlobalItemList(GlobalFunctions, addrRef, pFunction))
+		bRebuildFilteredGlobalFunctions = true;
+}
+
+void FCodeAnalysisState::EndGlobalLabelBatch()
+{
+	assert(GlobalLabelBatchDepth > 0);
+	if (--GlobalLabelBatchDepth == 0 && bGlobalLabelIndexDirty)
+	{
+		bGlobalLabelIndexDirty = false;
+		GenerateGlobalInfo(*this);
+	}
+}
+
 FCodeAnalysisState::FCodeAnalysisState()
 {
 	for (int i = 0; i < kNoPagesInAddressSpace; i++)
@@ -1031,7 +1138,7 @@ void FCodeAnalysisState::Init(FEmuBase* pEmu)
 	InitImageViewers();
 	InitCharacterSets();
 	
-	FLabelInfo::ResetLabelNames();
+	LabelNames.Reset();
 	ItemList.clear();
 
 	// reset registered pages
@@ -1058,6 +1165,7 @@ void FCodeAnalysisState::Init(FEmuBase* pEmu)
 	
 	FreeMachineStates(*this);
 	FLabelInfo::FreeAll();
+	LabelNames.Clear();	// no labels left to use the names
 	FCodeInfo::FreeAll();
 	FCommentBlock::FreeAll();
 
@@ -1072,8 +1180,13 @@ void FCodeAnalysisState::Init(FEmuBase* pEmu)
 	{
 		bank.Description.clear();
 		bank.ItemList.clear();
+		bank.bIsDirty = true;
 	}
 
+	// analysis no longer matches any project file
+	SyncedAnalysisFile.clear();
+	SyncedAnalysisFileSize = 0;
+
 	pEmulator = pEmu;
 	CPUInterface = pEmu;
 	//uint16_t initialPC = pCPUInterface->GetPC();
@@ -1121,34 +1234,64 @@ void FCodeAnalysisState::OnFrameEnd()
 // Start/End handlers for machine frame
 void	FCodeAnalysisState::OnMachineFrameStart()
 {
+	WriteGeneration++;
 	IOAnalyser.OnMachineFrameStart();
 	Debugger.OnMachineFrameStart();
 }
 void	FCodeAnalysisState::OnMachineFrameEnd()
 {
+	MemoryAnalyser.OnMachineFrameEnd();
 	IOAnalyser.OnMachineFrameEnd();
 	Debugger.OnMachineFrameEnd();
 }
 
+// Machines that don't have a specialised tick function come through here
 void FCodeAnalysisState::OnCPUTick(uint64_t pins)
 {
-	// Only Z80 has IO operations
-	if(CPUInterface->CPUType == ECPUType::Z80)
-	{
-		// Handle IO operations
-		if (pins & Z80_IORQ)
-		{
-			const uint8_t data = Z80_GET_DATA(pins);
-			const uint16_t addr = Z80_GET_ADDR(pins);
+	const FCPUTickPins tick = Debugger.DecodeTickPins(pins);
 
-			if (pins & Z80_RD)
-				IOAnalyser.RegisterIORead(Debugger.GetPC(), addr, data);
-			else if (pins & Z80_WR)
-				IOAnalyser.RegisterIOWrite(Debugger.GetPC(), addr, data);
-		}
-	}
+	if (bRegisterIOAccesses)
+		OnCPUTick<TickFeature_All>(tick);
+	else
+		OnCPUTick<TickFeature_All & ~TickFeature_IOAnalysis>(tick);
+}
 
-	Debugger.CPUTick(pins);
+// Get the per tick features that are currently needed
+// Machine specific features (e.g. screen write events) are added by the machine
+uint32_t FCodeAnalysisState::GetTickFeatures() const
+{
+	uint32_t features = 0;
+
+	if (bRegisterDataAccesses)
+		features |= TickFeature_DataAccesses;
+	if (bRegisterIOAccesses)
+		features |= TickFeature_IOAnalysis;
+	if (bRecordEvents)
+		features |= TickFeature_Events;
+	if (Debugger.NeedsTickChecks())
+		features |= TickFeature_Breakpoints;
+
+	return features;
+}
+
+void FCodeAnalysisState::SetAnalysisLevel(EAnalysisLevel level)
+{
+	bRegisterCodeExecution = level >= EAnalysisLevel::CodeCoverage;
+	bRegisterDataAccesses = level >= EAnalysisLevel::DataAccess;
+	bRegisterIOAccesses = level >= EAnalysisLevel::DataAccess;
+	bRecordEvents = level >= EAnalysisLevel::Full;
+}
+
+// the individual flags can be set separately so this is the highest level they fully cover
+EAnalysisLevel FCodeAnalysisState::GetAnalysisLevel() const
+{
+	if (bRegisterCodeExecution == false)
+		return EAnalysisLevel::Off;
+	if (bRegisterDataAccesses == false || bRegisterIOAccesses == false)
+		return EAnalysisLevel::CodeCoverage;
+	if (bRecordEvents == false)
+		return EAnalysisLevel::DataAccess;
+	return EAnalysisLevel::Full;
 }
 
 void SetItemCode(FCodeAnalysisState &state, FAddressRef address)
@@ -1252,11 +1395,7 @@ void RemoveLabelAtAddress(FCodeAnalysisState &state, FAddressRef address)
 
 	if (pLabelInfo != nullptr)
 	{
-		state.SetLabelForAddress(address, nullptr);
-		// Remove from globals
-		if (pLabelInfo->Global || pLabelInfo->LabelType == ELabelType::Function)
-			GenerateGlobalInfo(state);
-
+		state.SetLabelForAddress(address, nullptr);	// also removes from globals
 		state.SetCodeAnalysisDirty(address);
 	}
 }
@@ -1264,6 +1403,7 @@ void RemoveLabelAtAddress(FCodeAnalysisState &state, FAddressRef address)
 void SetItemCommentText(FCodeAnalysisState &state, const FCodeAnalysisItem& item, const char *pText)
 {
 	item.Item->Comment = pText;
+	state.MarkPageChanged(item.AddressRef);
 }
 
 
@@ -96,6 +96,15 @@ enum class EDataTypeFilter : int
 	ColAttr,
 };
 
+// How much analysis is done as the machine runs
+enum class EAnalysisLevel
+{
+	Off,			// emulation only
+	CodeCoverage,	// instructions executed
+	DataAccess,		// + memory & IO accesses
+	Full,			// + events
+};
+
 enum class EBankAccess
 {
 	None	= 0x00,
@@ -233,7 +242,16 @@ struct FCodeAnalysisBank
 	bool				bEverBeenMapped = false;
 	std::vector<FCodeAnalysisItem>		ItemList;
 
-	FCommentLine::FAllocator	CommentLineAllocator;
+	// range of ItemList built from each page, so pages can be rebuilt on their own
+	struct FPageItemRange
+	{
+		int		FirstItem = 0;
+		int		NoItems = 0;
+		int		Overhang = 0;	// how far the page's last item runs into the next page
+		bool	bDirty = true;
+		FCommentLine::FAllocator	CommentLineAllocator;
+	};
+	std::vector<FPageItemRange>	PageItemRanges;
 
 	EBankAccess			Mapping = EBankAccess::None;
 
@@ -272,6 +290,12 @@ struct FCodeAnalysisBank
 	EBankAccess	GetBankMapping(int16_t bankId) const { return Mapping;}
 	uint16_t	GetMappedAddress() const { return PrimaryMappedPage * FCodeAnalysisPage::kPageSize; }
 	uint16_t	GetSizeBytes() const { return NoPages * FCodeAnalysisPage::kPageSize; }
+
+	void		SetPageItemsDirty(int bankPageNo)
+	{
+		if (bankPageNo < (int)PageItemRanges.size())
+			PageItemRanges[bankPageNo].bDirty = true;
+	}
 };
 
 
@@ -293,6 +317,25 @@ public:
 	void	OnMachineFrameStart();
 	void	OnMachineFrameEnd();
 	void	OnCPUTick(uint64_t pins);
+	uint32_t	GetTickFeatures() const;
+	void	SetAnalysisLevel(EAnalysisLevel level);
+	EAnalysisLevel	GetAnalysisLevel() const;
+
+	// Per tick analysis, specialised on the ETickFeature flags
+	template <uint32_t kFeatures>
+	void	OnCPUTick(const FCPUTickPins& tick)
+	{
+		// Only Z80 has IO operations, the pins won't be set for other CPUs
+		if constexpr ((kFeatures & TickFeature_IOAnalysis) != 0)
+		{
+			if (tick.bIORead)
+				IOAnalyser.RegisterIORead(Debugger.GetPC(), tick.Addr, tick.Data);
+			else if (tick.bIOWrite)
+				IOAnalyser.RegisterIOWrite(Debugger.GetPC(), tick.Addr, tick.Data);
+		}
+
+		Debugger.CPUTick<(kFeatures & TickFeature_Breakpoints) != 0>(tick);
+	}
 
 	const FEmuBase* GetEmulator() const { return pEmulator; }
 	FEmuBase* GetEmulator() { return pEmulator; }
@@ -365,6 +408,7 @@ public:
 			CPUInterface->WriteByte(address, value);
 		else
 			*(MappedMem[(address >> kPageShift)] + (address & kPageMask)) = value;
+		MarkMemoryWritten(address);
 	}
 	
 	bool IsValidPageId(int16_t id) const { return id >=0 && id < RegisteredPages.size(); }
@@ -394,8 +438,12 @@ public:
 	{
 		FCodeAnalysisBank* pBank = GetBank(addrRef.BankId);
 		if (pBank != nullptr)
-			pBank->bIsDirty = true;
+		{
+			const uint16_t bankAddr = addrRef.Address - pBank->GetMappedAddress();
+			pBank->SetPageItemsDirty((bankAddr >> FCodeAnalysisPage::kPageShift) & pBank->SizeMask);
+		}
 		bCodeAnalysisDataDirty = true;
+		MarkPageChanged(addrRef);
 	}
 
 	void	SetCodeAnalysisDirty(uint16_t address)	
@@ -420,7 +468,14 @@ public:
 	void	SetAllBanksDirty()
 	{
 		for (auto& bank : Banks)
+		{
 			bank.bIsDirty = true;
+			for (int pageNo = 0; pageNo < bank.NoPages; pageNo++)
+			{
+				bank.Pages[pageNo].bStringsDirty = true;
+				MarkPageWritten(&bank.Pages[pageNo]);	// memory could have changed anywhere
+			}
+		}
 		bCodeAnalysisDataDirty = true;
 	}
 
@@ -430,6 +485,66 @@ public:
 	}
 	
 	bool IsCodeAnalysisDataDirty() const { return bCodeAnalysisDataDirty; }
+
+	// Change tracking for incremental saves
+	// Modified pages are stamped with the current change generation, which moves on each time the analysis is saved
+	// the page's strings are rescanned too as the change could be to what can hold a string
+	void	MarkPageChanged(FCodeAnalysisPage* pPage)
+	{
+		if (pPage != nullptr)
+		{
+			pPage->ChangeGeneration = ChangeGeneration;
+			pPage->bStringsDirty = true;
+		}
+	}
+	void	MarkPageChanged(uint16_t physAddr) { MarkPageChanged(GetReadPage(physAddr)); }
+	void	MarkPageChanged(FAddressRef addrRef)
+	{
+		FCodeAnalysisBank* pBank = GetBank(addrRef.BankId);
+		if (pBank != nullptr)
+		{
+			const uint16_t bankAddr = addrRef.Address - pBank->GetMappedAddress();
+			MarkPageChanged(&pBank->Pages[(bankAddr >> FCodeAnalysisPage::kPageShift) & pBank->SizeMask]);
+		}
+	}
+	bool	HasPageChangedSinceSave(const FCodeAnalysisPage& page) const { return page.ChangeGeneration > SavedGeneration; }
+
+	// Write tracking, for finding out what memory has changed without comparing it
+	// Every write stamps its page & 64 byte line with the current write generation, which moves on each machine frame.
+	// Take a token with GetWriteToken, then ask what has been written since with that token.
+	uint32_t	GetWriteToken() { return WriteGeneration++; }
+	void	MarkMemoryWritten(uint16_t physAddr)
+	{
+		FCodeAnalysisPage* pPage = WritePageTable[physAddr >> kPageShift];
+		if (pPage != nullptr)
+		{
+			pPage->WriteGeneration = WriteGeneration;
+			pPage->LineWriteGenerations[(physAddr & kPageMask) >> FCodeAnalysisPage::kWriteLineShift] = WriteGeneration;
+
+			// the string cache skips written bytes when data accesses are registered, so only the first write matters then
+			if (bRegisterDataAccesses == false || pPage->DataAccesses.LastFrameWritten[physAddr & kPageMask] == -1)
+				pPage->bStringsDirty = true;
+		}
+	}
+	void	MarkPageWritten(FCodeAnalysisPage* pPage)
+	{
+		pPage->WriteGeneration = WriteGeneration;
+		for (uint32_t& lineGeneration : pPage->LineWriteGenerations)
+			lineGeneration = WriteGeneration;
+	}
+	bool	HasPageBeenWrittenSince(const FCodeAnalysisPage& page, uint32_t token) const { return page.WriteGeneration > token; }
+	uint32_t	GetLinesWrittenSince(const FCodeAnalysisPage& page, uint32_t token) const;	// bit per 64 byte line
+	bool	HasMemoryBeenWrittenSince(FAddressRef addr, int noBytes, uint32_t token) const;
+	bool	HasMemoryBeenWrittenSince(uint16_t physAddr, int noBytes, uint32_t token) const;
+
+	// the analysis now matches this file
+	void	SetSyncedAnalysisFile(const char* pFileName, size_t fileSize)
+	{
+		SyncedAnalysisFile = pFileName;
+		SyncedAnalysisFileSize = fileSize;
+		SavedGeneration = ChangeGeneration++;
+	}
+	bool	IsSyncedWithAnalysisFile(const char* pFileName, size_t fileSize) const { return SyncedAnalysisFile == pFileName && SyncedAnalysisFileSize == fileSize; }
 	void ClearRemappings() { bMemoryRemapped = false; }
 	bool HasMemoryBeenRemapped() const { return bMemoryRemapped; }
 	//const std::vector<int16_t>& GetDirtyBanks() const { return RemappedBanks; }
@@ -439,9 +554,18 @@ public:
 
 public:
 
+	bool					bRegisterCodeExecution = true;
 	bool					bRegisterDataAccesses = true;
+	bool					bRegisterIOAccesses = true;
+	bool					bRecordEvents = true;
 
 	std::vector<FCodeAnalysisItem>	ItemList;
+	struct FItemListBankRange
+	{
+		int16_t	BankId = -1;
+		int		FirstItem = 0;
+	};
+	std::vector<FItemListBankRange>	ItemListBanks;	// banks ItemList is made from, in order
 
 	std::vector<FCodeAnalysisItem>	GlobalDataItems;
 	bool						bRebuildFilteredGlobalDataItems = true;	// should this be in the view 
@@ -449,6 +573,15 @@ public:
 	std::vector<FCodeAnalysisItem>	GlobalFunctions;
 	bool						bRebuildFilteredGlobalFunctions = true;
 
+	// GlobalDataItems & GlobalFunctions are ordered by address ref and updated as labels are set
+	void	UpdateGlobalLabelIndex(FAddressRef addrRef);	// call after changing a label's type or global flag
+	// batch up label changes, the global lists get regenerated once at the end
+	void	BeginGlobalLabelBatch() { GlobalLabelBatchDepth++; }
+	void	EndGlobalLabelBatch();
+
+	FLabelNames&	GetLabelNames() { return LabelNames; }	// new labels are allocated with these
+	FLabelInfo*		FindLabelByName(const char* pName) const { return LabelNames.FindLabel(pName); }
+
 	static const int kNoViewStates = 4;
 	FCodeAnalysisViewState	ViewState[kNoViewStates];	// new multiple view states
 	int						FocussedWindowId = 0;
@@ -516,21 +649,30 @@ public:
 	}
 	void SetLabelForPhysicalAddress(uint16_t addr, FLabelInfo* pLabel)
 	{
+		FLabelInfo*& pPageLabel = GetReadPage(addr)->Labels[addr & kPageMask];
+		if (pPageLabel != nullptr && pPageLabel != pLabel)	// name can be reused
+			pPageLabel->RemoveName();
 		if(pLabel != nullptr)	// ensure no name clashes
 			pLabel->EnsureUniqueName();
-		GetReadPage(addr)->Labels[addr & kPageMask] = pLabel; 
+		pPageLabel = pLabel; 
+		MarkPageChanged(addr);
+		UpdateGlobalLabelIndex(AddressRefFromPhysicalAddress(addr));
 	}
 	void SetLabelForAddress(FAddressRef addrRef, FLabelInfo* pLabel)
 	{
-		if (pLabel != nullptr)	// ensure no name clashes
-			pLabel->EnsureUniqueName();
-
 		FCodeAnalysisBank* pBank = GetBank(addrRef.BankId);
 		if (pBank != nullptr)
 		{
 			const uint16_t bankAddr = addrRef.Address - (pBank->PrimaryMappedPage * FCodeAnalysisPage::kPageSize);
 			assert(bankAddr < pBank->NoPages * FCodeAnalysisPage::kPageSize);	// This assert gets caused by banks being mapped into more than one location in physical memory
-			pBank->Pages[(bankAddr >> FCodeAnalysisPage::kPageShift) & pBank->SizeMask].Labels[bankAddr & FCodeAnalysisPage::kPageMask] = pLabel;
+			FLabelInfo*& pPageLabel = pBank->Pages[(bankAddr >> FCodeAnalysisPage::kPageShift) & pBank->SizeMask].Labels[bankAddr & FCodeAnalysisPage::kPageMask];
+			if (pPageLabel != nullptr && pPageLabel != pLabel)	// name can be reused
+				pPageLabel->RemoveName();
+			if (pLabel != nullptr)	// ensure no name clashes
+				pLabel->EnsureUniqueName();
+			pPageLabel = pLabel;
+			MarkPageChanged(addrRef);
+			UpdateGlobalLabelIndex(addrRef);
 		}
 	}
 
@@ -557,6 +699,7 @@ public:
 			const uint16_t bankAddr = addrRef.Address - (pBank->PrimaryMappedPage * FCodeAnalysisPage::kPageSize);
 			assert(bankAddr < pBank->NoPages * FCodeAnalysisPage::kPageSize);	// This assert gets caused by banks being mapped into more than one location in physical memory
 			pBank->Pages[(bankAddr >> FCodeAnalysisPage::kPageShift) & pBank->SizeMask].CommentBlocks[bankAddr & FCodeAnalysisPage::kPageMask] = pCommentBlock;
+			MarkPageChanged(addrRef);
 		}
 		//GetReadPage(addr)->CommentBlocks[addr & kPageMask] = pCommentBlock;
 	}
@@ -578,7 +721,7 @@ public:
 		}
 	}
 
-	void SetCodeInfoForAddress(uint16_t addr, FCodeInfo* pCodeInfo) { GetReadPage(addr)->CodeInfo[addr & kPageMask] = pCodeInfo; }
+	void SetCodeInfoForAddress(uint16_t addr, FCodeInfo* pCodeInfo) { GetReadPage(addr)->CodeInfo[addr & kPageMask] = pCodeInfo; MarkPageChanged(addr); }
 	void SetCodeInfoForAddress(FAddressRef addrRef, FCodeInfo* pCodeInfo)
 	{ 
 		FCodeAnalysisBank* pBank = GetBank(addrRef.BankId);
@@ -587,6 +730,7 @@ public:
 			const uint16_t bankAddr = addrRef.Address - (pBank->PrimaryMappedPage * FCodeAnalysisPage::kPageSize);
 			assert(bankAddr < pBank->NoPages * FCodeAnalysisPage::kPageSize);	// This assert gets caused by banks being mapped into more than one location in physical memory
 			pBank->Pages[(bankAddr >> FCodeAnalysisPage::kPageShift) & pBank->SizeMask].CodeInfo[bankAddr & FCodeAnalysisPage::kPageMask] = pCodeInfo;
+			MarkPageChanged(addrRef);
 		}
 	}
 
@@ -611,14 +755,39 @@ public:
 	const FDataInfo* GetWriteDataInfoForAddress(uint16_t addr) const { return  &GetWritePage(addr)->DataInfo[addr & kPageMask]; }
 	FDataInfo* GetWriteDataInfoForAddress(uint16_t addr) { return &GetWritePage(addr)->DataInfo[addr & kPageMask]; }
 	
-	FAddressRef GetLastWriterForAddress(uint16_t addr) const { return GetWritePage(addr)->DataInfo[addr & kPageMask].LastWriter; }
-	void SetLastWriterForAddress(uint16_t addr, FAddressRef lastWriter) { GetWritePage(addr)->DataInfo[addr & kPageMask].LastWriter = lastWriter; }
+	// page holding an address, for its data access arrays - the page offset is addrRef.Address & kPageMask
+	const FCodeAnalysisPage* GetPageForAddress(FAddressRef addrRef) const
+	{
+		const FCodeAnalysisBank* pBank = GetBank(addrRef.BankId);
+		if (pBank == nullptr)
+			return nullptr;
+
+		const uint16_t bankAddr = addrRef.Address - pBank->GetMappedAddress();
+		return &pBank->Pages[(bankAddr >> FCodeAnalysisPage::kPageShift) & pBank->SizeMask];
+	}
+
+	FAddressRef GetLastWriterForAddress(uint16_t addr) const { return GetWritePage(addr)->DataAccesses.LastWriter[addr & kPageMask]; }
+	FAddressRef GetLastWriterForAddress(FAddressRef addrRef) const
+	{
+		const FCodeAnalysisPage* pPage = GetPageForAddress(addrRef);
+		return pPage != nullptr ? pPage->DataAccesses.LastWriter[addrRef.Address & kPageMask] : FAddressRef();
+	}
+	void SetLastWriterForAddress(uint16_t addr, FAddressRef lastWriter) { GetWritePage(addr)->DataAccesses.LastWriter[addr & kPageMask] = lastWriter; }
+
+	// code that has read & written an address
+	const FDataReferences& GetDataReferencesForAddress(FAddressRef addrRef) const
+	{
+		const FCodeAnalysisPage* pPage = GetPageForAddress(addrRef);
+		return pPage != nullptr ? pPage->GetDataReferences(addrRef.Address & kPageMask) : FCodeAnalysisPage::NoDataReferences;
+	}
+	const FDataReferences& GetReadDataReferencesForAddress(uint16_t addr) const { return GetReadPage(addr)->GetDataReferences(addr & kPageMask); }
+	const FDataReferences& GetWriteDataReferencesForAddress(uint16_t addr) const { return GetWritePage(addr)->GetDataReferences(addr & kPageMask); }
 
-	FMachineState* GetMachineState(uint16_t addr) { return GetReadPage(addr)->MachineState[addr & kPageMask];}
-	void SetMachineStateForAddress(uint16_t addr, FMachineState* pMachineState) { GetReadPage(addr)->MachineState[addr & kPageMask] = pMachineState; }
+	FMachineState* GetMachineState(uint16_t addr) { return GetReadPage(addr)->GetMachineState(addr & kPageMask);}
+	void SetMachineStateForAddress(uint16_t addr, FMachineState* pMachineState) { GetReadPage(addr)->SetMachineState(addr & kPageMask, pMachineState); }
 
 	//FAddressRef FindMemoryPattern(uint8_t* pData, size_t dataSize);
-	std::vector<FAddressRef> FindAllMemoryPatterns(uint8_t* pData, size_t dataSize, bool bROM, bool bPhysicalOnly);
+	std::vector<FAddressRef> FindAllMemoryPatterns(const uint8_t* pData, size_t dataSize, bool bROM, bool bPhysicalOnly, const uint8_t* pMask = nullptr);	// mask of 0 is a wildcard
 	std::vector<FFoundString> FindAllStrings(bool bROM, bool bPhysicalOnly);
 
 	//bool FindMemoryPatternInPhysicalMemory(uint8_t* pData, size_t dataSize, uint16_t offset, uint16_t& outAddr);
@@ -680,12 +849,34 @@ private:
 	bool						bCodeAnalysisDataDirty = false;
 	bool						bMemoryRemapped = true;
 
+	FLabelNames					LabelNames;
+	int							GlobalLabelBatchDepth = 0;
+	bool						bGlobalLabelIndexDirty = false;	// labels changed during a batch
+
+	uint32_t					ChangeGeneration = 1;
+	uint32_t					SavedGeneration = 0;
+	uint32_t					WriteGeneration = 1;
+	std::string					SyncedAnalysisFile;	// project file the analysis was last loaded from or saved to
+	size_t						SyncedAnalysisFileSize = 0;
+
+};
+
+// Defers global label list updates to the end of a bulk change such as an import
+class FGlobalLabelBatchScope
+{
+public:
+	FGlobalLabelBatchScope(FCodeAnalysisState& state) : State(state) { State.BeginGlobalLabelBatch(); }
+	~FGlobalLabelBatchScope() { State.EndGlobalLabelBatch(); }
+private:
+	FCodeAnalysisState&	State;
 };
 
 // Analysis
 FLabelInfo* GenerateLabelForAddress(FCodeAnalysisState &state, FAddressRef addrRef, ELabelType label);
 void RunStaticCodeAnalysis(FCodeAnalysisState &state, uint16_t pc);
 bool RegisterCodeExecuted(FCodeAnalysisState &state, uint16_t pc, uint16_t oldpc);
+FDecodedInstruction GetDecodedInstruction(FCodeAnalysisState& state, uint16_t pc, FCodeInfo* pCodeInfo);
+FDecodedInstruction GetDecodedInstruction(FCodeAnalysisState& state, uint16_t pc);
 void ReAnalyseCode(FCodeAnalysisState &state);
 uint16_t WriteCodeInfoForAddress(FCodeAnalysisState& state, uint16_t pc);
 void GenerateGlobalInfo(FCodeAnalysisState &state);
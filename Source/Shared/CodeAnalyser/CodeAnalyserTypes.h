@@ -5,6 +5,11 @@
 #include <cstring>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <new>
+#include <type_traits>
+
+#include "Util/StringPool.h"
 
 // Enums
 
@@ -143,91 +148,242 @@ struct FFoundString
 	std::string		String;
 };
 
+// Read only view of a contiguous list of address references
+struct FAddressRefList
+{
+	const FAddressRef*	begin() const { return pStart; }
+	const FAddressRef*	end() const { return pStart + Count; }
+	size_t				size() const { return Count; }
+	bool				empty() const { return Count == 0; }
+	const FAddressRef&	operator[](size_t index) const { return pStart[index]; }
+
+	const FAddressRef*	pStart = nullptr;
+	size_t				Count = 0;
+};
+
+// Set of unique addresses that have referenced an item, iterated in the order they were registered
+// The first few references are stored inline, after that they move to the heap
+// and once there are enough of them a hash set is used for the lookup
 class FItemReferenceTracker
 {
 public:
-	void Reset() { References.clear(); }
+	FItemReferenceTracker() : pOverflow(nullptr) {}
+	FItemReferenceTracker(const FItemReferenceTracker& other) : pOverflow(nullptr) { *this = other; }
+	FItemReferenceTracker(FItemReferenceTracker&& other) noexcept : pOverflow(nullptr) { *this = std::move(other); }
+	~FItemReferenceTracker() { Reset(); }
+
+	FItemReferenceTracker& operator=(const FItemReferenceTracker& other)
+	{
+		if (this != &other)
+		{
+			Reset();
+			for (const FAddressRef& ref : other.GetReferences())
+				RegisterAccess(ref);
+		}
+		return *this;
+	}
+
+	FItemReferenceTracker& operator=(FItemReferenceTracker&& other) noexcept
+	{
+		if (this != &other)
+		{
+			Reset();
+			memcpy(InlineRefs, other.InlineRefs, sizeof(InlineRefs));	// also moves the overflow pointer
+			NoReferences = other.NoReferences;
+			other.NoReferences = 0;
+		}
+		return *this;
+	}
+
+	void Reset()
+	{
+		if (NoReferences > kNoInlineRefs)
+			delete pOverflow;
+		pOverflow = nullptr;
+		NoReferences = 0;
+	}
 
 	void	RegisterAccess(const FAddressRef& addrRef)
 	{
-		const auto size = References.size();
-		for (int i = 0; i < size; i++)
+		if (NoReferences < kNoInlineRefs)
+		{
+			for (uint32_t i = 0; i < NoReferences; i++)
+			{
+				if (InlineRefs[i] == addrRef)
+					return;
+			}
+			InlineRefs[NoReferences++] = addrRef;
+			return;
+		}
+
+		if (NoReferences == kNoInlineRefs)
+		{
+			for (uint32_t i = 0; i < kNoInlineRefs; i++)
+			{
+				if (InlineRefs[i] == addrRef)
+					return;
+			}
+
+			// move inline references to the heap
+			FOverflow* pNewOverflow = new FOverflow;
+			pNewOverflow->References.assign(InlineRefs, InlineRefs + kNoInlineRefs);
+			pOverflow = pNewOverflow;
+		}
+		else if (NoReferences <= kHashThreshold)
 		{
-			if (References[i] == addrRef)
-				return;
+			for (const FAddressRef& ref : pOverflow->References)
+			{
+				if (ref == addrRef)
+					return;
+			}
 		}
+		else if (pOverflow->Lookup.count(addrRef) != 0)
+		{
+			return;
+		}
+
+		pOverflow->References.emplace_back(addrRef);
+		NoReferences++;
+
+		if (NoReferences == kHashThreshold + 1)
+			pOverflow->Lookup.insert(pOverflow->References.begin(), pOverflow->References.end());
+		else if (NoReferences > kHashThreshold + 1)
+			pOverflow->Lookup.insert(addrRef);
+	}
 
-		References.emplace_back(addrRef);
+	bool IsEmpty() const { return NoReferences == 0; }
+	int NumReferences() const { return (int)NoReferences; }
+	FAddressRefList GetReferences() const
+	{
+		if (NoReferences <= kNoInlineRefs)
+			return { InlineRefs, NoReferences };
+		return { pOverflow->References.data(), NoReferences };
 	}
 
-	bool IsEmpty() const { return References.empty(); }
-	int NumReferences() const { return (int)References.size(); }
-	const std::vector<FAddressRef>& GetReferences() const { return References; }
+	static const uint32_t kNoInlineRefs = 2;	// most items only get referenced from one or two places
+	static const uint32_t kHashThreshold = 16;	// above this use a hash set rather than a linear search
 private:
-	std::vector<FAddressRef>	References;
-};
+	struct FOverflow
+	{
+		std::vector<FAddressRef>			References;	// keeps the registration order
+		std::unordered_set<FAddressRef>		Lookup;
+	};
 
+	union
+	{
+		FAddressRef	InlineRefs[kNoInlineRefs];
+		FOverflow*	pOverflow;
+	};
+	uint32_t	NoReferences = 0;
+};
 
-struct FItem
+// Code that has read & written an address
+// Kept in a sparse table on the page rather than in FDataInfo as most addresses are never accessed by code
+struct FDataReferences
 {
-	EItemType		Type = EItemType::Unknown;
-	std::string		Comment;
-	uint16_t		ByteSize = 0;
+	bool	IsEmpty() const { return Reads.IsEmpty() && Writes.IsEmpty(); }
+
+	FItemReferenceTracker	Reads;	// address and counts of data access instructions
+	FItemReferenceTracker	Writes;	// address and counts of data access instructions
 };
 
-struct FLabelInfo : FItem
+
+// Allocates items from slabs so they are packed together in memory rather than scattered across the heap
+// There's one allocator per item type shared by all the banks, items are in allocation order rather than address order.
+// Items can't be freed individually - FreeAll destroys all of them and keeps the slabs for reuse.
+// FreeAll still visits every item as they own strings & reference lists.
+template <class T>
+class FItemSlabAllocator
 {
-	static FLabelInfo* Allocate();
-	static FLabelInfo* Duplicate(const FLabelInfo* pSourceLabel);
-	static void FreeAll();
+public:
+	~FItemSlabAllocator()
+	{
+		FreeAll();
+		for (T* pSlab : Slabs)
+			::operator delete(pSlab);
+	}
 
-	bool EnsureUniqueName(void)
+	T* Allocate()
 	{
-		auto labelIt = LabelUsage.find(Name);
-		if (labelIt == LabelUsage.end())
+		if (SlabItemNo == kSlabSize)
 		{
-			LabelUsage[Name] = 0;
-			return false;
+			SlabNo++;
+			SlabItemNo = 0;
 		}
+		if (SlabNo == Slabs.size())
+			Slabs.push_back(static_cast<T*>(::operator new(sizeof(T) * kSlabSize)));
 
-		char postFix[32];
-		snprintf(postFix, 32, "_%d", ++LabelUsage[Name]);
-		Name += std::string(postFix);
-
-		return true;
+		return new(Slabs[SlabNo] + SlabItemNo++) T;
 	}
 
-	bool RemoveLabelName(const std::string& labelName)
+	void FreeAll()
 	{
-		auto labelIt = LabelUsage.find(labelName);
-		//assert(labelIt != LabelUsage.end());	// shouldn't happen - it does though - investigate
-		if (labelIt == LabelUsage.end())
-			return false;
-
-		if (labelIt->second == 0)	// only a single use so we can remove from the map
+		if constexpr (std::is_trivially_destructible_v<T> == false)
 		{
-			LabelUsage.erase(labelIt);
-			return true;
+			for (size_t slabNo = 0; slabNo < Slabs.size() && slabNo <= SlabNo; slabNo++)
+			{
+				const size_t noItems = slabNo == SlabNo ? SlabItemNo : kSlabSize;
+				for (size_t itemNo = 0; itemNo < noItems; itemNo++)
+					Slabs[slabNo][itemNo].~T();
+			}
 		}
 
-		return false;
+		SlabNo = 0;
+		SlabItemNo = 0;
 	}
 
-	static void	ResetLabelNames() { LabelUsage.clear(); }
+	size_t	GetNoAllocated() const { return SlabNo * kSlabSize + SlabItemNo; }
+
+	static const size_t kSlabSize = 1024;	// items per slab
+private:
+	std::vector<T*>	Slabs;
+	size_t			SlabNo = 0;		// slab we're allocating from
+	size_t			SlabItemNo = 0;	// next free item in that slab
+};
+
+struct FItem
+{
+	EItemType		Type = EItemType::Unknown;
+	std::string		Comment;
+	uint16_t		ByteSize = 0;
+};
+
+struct FLabelInfo;
+
+// Interned label names & the labels using them, owned by the analysis state
+struct FLabelNames
+{
+	void			Reset();	// forget which labels use the names
+	void			Clear();	// free the names too - only when there are no labels left
+	FLabelInfo*		FindLabel(const char* pName) const;	// only finds labels that have been made unique
+	size_t			GetMemoryUsage() const { return Pool.GetMemoryUsage(); }
+
+	FStringPool		Pool;
+	std::unordered_map<FStringHandle, FLabelInfo*>	Index;	// labels by unique name
+	std::unordered_map<FStringHandle, int>	SuffixCount;	// last _n postfix used to make each name unique
+};
+
+struct FLabelInfo : FItem
+{
+	static FLabelInfo* Allocate(FLabelNames& names);
+	static FLabelInfo* Duplicate(const FLabelInfo* pSourceLabel);
+	static void FreeAll();
 
+	bool EnsureUniqueName(void);	// returns true if the name had to be changed
+	void RemoveName(void);			// take the name out of the name index so it can be reused
 
-	void			InitialiseName(const char* pNewName) { Name = pNewName; }
+	void			InitialiseName(const char* pNewName) { Name = pNames->Pool.Intern(pNewName); }
 	void			ChangeName(const char* pNewName) 
 	{
 		if (strlen(pNewName) == 0)	// don't let a label be empty
 			return;
 
-		RemoveLabelName(Name);
-		Name = pNewName;
+		RemoveName();
+		Name = pNames->Pool.Intern(pNewName);
 		EnsureUniqueName();
 		Edited = true;
 	}
-	const char*		GetName() const {return Name.c_str(); }
+	const char*		GetName() const {return pNames->Pool.Get(Name); }
 
 	bool					Global = false;
 	bool					Edited = false;	// has the name been changed since generation?
@@ -238,11 +394,55 @@ private:
 	FLabelInfo() { Type = EItemType::Label; }
 	~FLabelInfo() = default;
 
-	std::string				Name;
+	FLabelNames*			pNames = nullptr;	// the analysis state's names
+	FStringHandle			Name = 0;
 
-	static std::vector<FLabelInfo*>	AllocatedList;
-	static std::unordered_map<std::string, int>	LabelUsage;
+	friend class FItemSlabAllocator<FLabelInfo>;
+	static FItemSlabAllocator<FLabelInfo>	Allocator;
+};
+
+// How an instruction changes the stack pointer
+enum class EInstructionStackEffect : uint8_t
+{
+	None,
+	Push,			// pushes a word, including calls
+	SetSPImmediate,	// SP = operand
+	SetSPIndirect,	// SP = (operand)
+	SetSPFromHL,
+	SetSPFromIX,
+	SetSPFromIY,
+};
+
+// Flow types that are tracked on the call stack
+enum class EInstructionFlow : uint8_t
+{
+	Normal,
+	Call,
+	Return,
+};
+
+// Instruction info needed each time an instruction is executed
+// Cached in the code info so it's only decoded once, until the instruction gets written to
+struct FDecodedInstruction
+{
+	uint16_t	OperandAddress = 0;	// jump target, 16 bit immediate or SP operand
+	uint8_t		Opcode = 0;			// first byte
+	uint8_t		Length = 0;
+	uint8_t		Bytes[4] = { 0 };	// instruction bytes decoded - checked against memory before the cache is used
+	EInstructionFlow		Flow = EInstructionFlow::Normal;
+	EInstructionStackEffect	StackEffect = EInstructionStackEffect::None;
 
+	union
+	{
+		struct
+		{
+			bool	bValid : 1;			// cached decode can be used
+			bool	bJump : 1;			// OperandAddress is a jump target
+			bool	bPointerRef : 1;	// OperandAddress is an address operand
+			bool	bStepOver : 1;		// debugger steps over this instruction
+		};
+		uint8_t	Flags = 0;
+	};
 };
 
 struct FCodeInfo : FItem
@@ -272,11 +472,13 @@ struct FCodeInfo : FItem
 
 	bool	bNOPped = false;
 	uint8_t	OpcodeBkp[4] = { 0 };
+	FDecodedInstruction	Decoded;
 private:
 	FCodeInfo() :FItem() { Type = EItemType::Code; }
 	~FCodeInfo() = default;
 
-	static std::vector<FCodeInfo*>	AllocatedList;
+	friend class FItemSlabAllocator<FCodeInfo>;
+	static FItemSlabAllocator<FCodeInfo>	Allocator;
 };
 
 // struct for additional image data
@@ -307,16 +509,11 @@ struct FDataInfo : FItem
 		DataType = EDataType::Byte;
 		DisplayType = EDataItemDisplayType::Unknown;
 		Comment.clear();
-		ReadCount = 0;
-		LastFrameRead = -1;
-		Reads.Reset();
-		WriteCount = 0;
-		LastFrameWritten = -1;
-		Writes.Reset();
 	}
 
-	EDataType	DataType = EDataType::Byte;
-	EDataItemDisplayType	DisplayType = EDataItemDisplayType::Unknown;
+	// access counts, frame numbers & last writer are kept in the page's dense FDataAccessArrays
+	// read & write references are in the page's sparse FDataReferences
+	EDataType				DataType = EDataType::Byte;
 
 	union
 	{
@@ -338,19 +535,10 @@ struct FDataInfo : FItem
 		FAddressRef	GraphicsSetRef;	// for bitmap data
 		FAddressRef	InstructionAddress;	// for operand data types
 	};
+
+	EDataItemDisplayType	DisplayType = EDataItemDisplayType::Unknown;
 	uint8_t		EmptyCharNo = 0;
 	int			PaletteNo = -1;
-
-	// Reads
-	int						ReadCount = 0;
-	int						LastFrameRead = -1;
-	FItemReferenceTracker	Reads;	// address and counts of data access instructions
-
-	// Writes
-	int						WriteCount = 0;
-	int						LastFrameWritten = -1;
-	FItemReferenceTracker	Writes;	// address and counts of data access instructions
-	FAddressRef				LastWriter;
 };
 
 struct FCommentBlock : FItem
@@ -361,7 +549,8 @@ struct FCommentBlock : FItem
 private:
 	FCommentBlock() : FItem() { Type = EItemType::CommentBlock; }
 	~FCommentBlock() = default;
-	static std::vector<FCommentBlock*>	AllocatedList;
+	friend class FItemSlabAllocator<FCommentBlock>;
+	static FItemSlabAllocator<FCommentBlock>	Allocator;
 };
 
 struct FCommentLine : FItem
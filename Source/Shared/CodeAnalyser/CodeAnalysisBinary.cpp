@@ -0,0 +1,743 @@
+#include "CodeAnalysisBinary.h"
+#include "CodeAnalyser.h"
+#include "CodeAnalysisPage.h"
+
+#include "Util/FileUtil.h"
+#include "Util/GraphicsView.h"
+#include "Debug/DebugLog.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// File layout - all sections are 4 byte aligned
+//
+//	FBinHeader
+//	FBinBank[]					one per bank
+//	FBinPage[]					one per page, each refers to a range of records in each column
+//	FBinCodeRecord[]			record columns for all pages
+//	FBinDataRecord[]
+//	FBinLabelRecord[]
+//	FBinCommentBlockRecord[]
+//	FBinCharacterSet[]
+//	FBinCharacterMap[]
+//	uint32_t[]					palette colours
+//	FPaletteEntry[]
+//	char[]						string pool
+//
+// Strings are referenced by their offset from the start of the file, 0 is the empty string
+//
+// Saving only the pages that have changed appends the same set of sections after the end of the file.
+// Unchanged pages keep referring to their old records, then the header is rewritten to point at the new sections.
+// The file always ends with a string pool.
+//
+// Version 2: page record ranges are file offsets rather than indices into the header's columns
+
+static const uint32_t kBinMagic = 0x4e425341;	// 'ASBN'
+static const uint32_t kBinVersion = 2;
+
+struct FBinSection
+{
+	uint32_t	Offset = 0;	// file offset
+	uint32_t	Count = 0;	// number of records
+};
+
+struct FBinHeader
+{
+	uint32_t	Magic = kBinMagic;
+	uint32_t	Version = kBinVersion;
+	uint32_t	FileSize = 0;
+	FBinSection	Banks;
+	FBinSection	Pages;
+	FBinSection	CodeInfo;
+	FBinSection	DataInfo;
+	FBinSection	Labels;
+	FBinSection	CommentBlocks;
+	FBinSection	CharacterSets;
+	FBinSection	CharacterMaps;
+	FBinSection	PaletteColours;
+	FBinSection	Palettes;
+	FBinSection	Strings;	// count is in bytes
+	uint32_t	BaseSize = 0;	// file size after the last full save - version 2
+};
+
+struct FBinBank
+{
+	int16_t		BankId;
+	uint16_t	NoPages;
+	uint32_t	Description;
+};
+
+// version 1 files store the record's index in the header's column rather than its file offset
+struct FBinPage
+{
+	int16_t		PageId;
+	uint16_t	Pad;
+	FBinSection	CodeInfo;
+	FBinSection	DataInfo;
+	FBinSection	Labels;
+	FBinSection	CommentBlocks;
+};
+
+struct FBinCodeRecord
+{
+	uint16_t	PageAddr;
+	uint8_t		ByteSize;
+	uint8_t		OperandType;
+	uint32_t	Flags;
+	uint32_t	Comment;
+};
+
+struct FBinDataRecord
+{
+	uint16_t	PageAddr;
+	uint16_t	ByteSize;
+	uint8_t		DataType;
+	uint8_t		DisplayType;
+	uint8_t		EmptyCharNo;
+	uint8_t		Pad;
+	uint32_t	Flags;
+	uint32_t	AddressRef;	// character set, graphics set or instruction address depending on type
+	int32_t		PaletteNo;
+	uint32_t	Comment;
+};
+
+struct FBinLabelRecord
+{
+	uint16_t	PageAddr;
+	uint8_t		LabelType;
+	uint8_t		Global;
+	uint32_t	Name;
+	uint32_t	Comment;
+};
+
+struct FBinCommentBlockRecord
+{
+	uint16_t	PageAddr;
+	uint16_t	Pad;
+	uint32_t	Comment;
+};
+
+struct FBinCharacterSet
+{
+	uint32_t	AddressRef;
+	uint32_t	AttribsAddressRef;
+	uint8_t		MaskInfo;
+	uint8_t		ColourInfo;
+	uint8_t		BitmapFormat;
+	uint8_t		Dynamic;
+	int32_t		PaletteNo;
+};
+
+struct FBinCharacterMap
+{
+	uint32_t	AddressRef;
+	uint32_t	CharacterSetRef;
+	uint16_t	Width;
+	uint16_t	Height;
+	uint8_t		IgnoreCharacter;
+	uint8_t		Pad[3];
+};
+
+static_assert(sizeof(FBinHeader) == 104, "binary format changed");
+static_assert(sizeof(FBinPage) == 36, "binary format changed");
+static_assert(sizeof(FBinCodeRecord) == 12, "binary format changed");
+static_assert(sizeof(FBinDataRecord) == 24, "binary format changed");
+static_assert(sizeof(FBinLabelRecord) == 12, "binary format changed");
+static_assert(sizeof(FBinCommentBlockRecord) == 8, "binary format changed");
+static_assert(sizeof(FPaletteEntry) == 8, "binary format changed");
+
+
+// Export
+
+// strings are de-duplicated, references are relative to the pool until the file is laid out
+struct FBinStringPool
+{
+	FBinStringPool() { Data.push_back(0); }
+
+	uint32_t Add(const std::string& str)
+	{
+		if (str.empty())
+			return 0;
+
+		const auto it = Lookup.find(str);
+		if (it != Lookup.end())
+			return it->second;
+
+		const uint32_t offset = (uint32_t)Data.size();
+		Data.insert(Data.end(), str.c_str(), str.c_str() + str.size() + 1);
+		Lookup[str] = offset;
+		return offset;
+	}
+
+	std::vector<char>							Data;
+	std::unordered_map<std::string, uint32_t>	Lookup;
+};
+
+struct FBinExportContext
+{
+	std::vector<FBinBank>				Banks;
+	std::vector<FBinPage>				Pages;
+	std::vector<bool>					PageReused;	// page refers to records already in the file
+	std::vector<FBinCodeRecord>			CodeInfo;
+	std::vector<FBinDataRecord>			DataInfo;
+	std::vector<FBinLabelRecord>		Labels;
+	std::vector<FBinCommentBlockRecord>	CommentBlocks;
+	FBinStringPool						Strings;
+	int									PagesWritten = 0;
+};
+
+// only write data items that deviate from the default
+static bool IsDefaultDataInfo(const FDataInfo* pDataInfo)
+{
+	return pDataInfo->DataType == EDataType::Byte && pDataInfo->DisplayType == EDataItemDisplayType::Unknown &&
+		pDataInfo->ByteSize == 1 && pDataInfo->Flags == 0 && pDataInfo->Comment.empty() && pDataInfo->PaletteNo == -1;
+}
+
+// same walk as WritePageToJson
+// page ranges are column indices until the file is laid out
+static void WritePageToBinary(const FCodeAnalysisPage& page, FBinExportContext& context)
+{
+	FBinPage binPage = {};
+	binPage.PageId = page.PageId;
+	binPage.CodeInfo.Offset = (uint32_t)context.CodeInfo.size();
+	binPage.DataInfo.Offset = (uint32_t)context.DataInfo.size();
+	binPage.Labels.Offset = (uint32_t)context.Labels.size();
+	binPage.CommentBlocks.Offset = (uint32_t)context.CommentBlocks.size();
+
+	int pageAddr = 0;
+	while (pageAddr < FCodeAnalysisPage::kPageSize)
+	{
+		const FCommentBlock* pCommentBlock = page.CommentBlocks[pageAddr];
+		if (pCommentBlock != nullptr && pCommentBlock->Comment.empty() == false)
+			context.CommentBlocks.push_back({ (uint16_t)pageAddr, 0, context.Strings.Add(pCommentBlock->Comment) });
+
+		const FLabelInfo* pLabelInfo = page.Labels[pageAddr];
+		if (pLabelInfo != nullptr)
+		{
+			FBinLabelRecord& record = context.Labels.emplace_back();
+			record.PageAddr = (uint16_t)pageAddr;
+			record.LabelType = (uint8_t)pLabelInfo->LabelType;
+			record.Global = pLabelInfo->Global ? 1 : 0;
+			record.Name = context.Strings.Add(pLabelInfo->GetName());
+			record.Comment = context.Strings.Add(pLabelInfo->Comment);
+		}
+
+		const FCodeInfo* pCodeInfoItem = page.CodeInfo[pageAddr];
+		if (pCodeInfoItem != nullptr)
+		{
+			FBinCodeRecord& record = context.CodeInfo.emplace_back();
+			record.PageAddr = (uint16_t)pageAddr;
+			record.ByteSize = (uint8_t)pCodeInfoItem->ByteSize;
+			record.OperandType = (uint8_t)pCodeInfoItem->OperandType;
+			record.Flags = pCodeInfoItem->Flags;
+			record.Comment = context.Strings.Add(pCodeInfoItem->Comment);
+
+			if (pCodeInfoItem->bSelfModifyingCode == false)
+				pageAddr += pCodeInfoItem->ByteSize;
+		}
+
+		// we do want data info for SMC operands
+		if (pCodeInfoItem == nullptr || pCodeInfoItem->bSelfModifyingCode == true)
+		{
+			const FDataInfo* pDataInfo = &page.DataInfo[pageAddr];
+			if (IsDefaultDataInfo(pDataInfo) == false)
+			{
+				FBinDataRecord& record = context.DataInfo.emplace_back();
+				record.PageAddr = (uint16_t)pageAddr;
+				record.ByteSize = pDataInfo->ByteSize;
+				record.DataType = (uint8_t)pDataInfo->DataType;
+				record.DisplayType = (uint8_t)pDataInfo->DisplayType;
+				record.EmptyCharNo = pDataInfo->EmptyCharNo;
+				record.Pad = 0;
+				record.Flags = pDataInfo->Flags;
+				record.AddressRef = pDataInfo->InstructionAddress.Val;
+				record.PaletteNo = pDataInfo->PaletteNo;
+				record.Comment = context.Strings.Add(pDataInfo->Comment);
+			}
+			pageAddr += pDataInfo->ByteSize;
+		}
+	}
+
+	binPage.CodeInfo.Count = (uint32_t)context.CodeInfo.size() - binPage.CodeInfo.Offset;
+	binPage.DataInfo.Count = (uint32_t)context.DataInfo.size() - binPage.DataInfo.Offset;
+	binPage.Labels.Count = (uint32_t)context.Labels.size() - binPage.Labels.Offset;
+	binPage.CommentBlocks.Count = (uint32_t)context.CommentBlocks.size() - binPage.CommentBlocks.Offset;
+	context.Pages.push_back(binPage);
+	context.PageReused.push_back(false);
+	context.PagesWritten++;
+}
+
+template <typename T>
+static FBinSection AppendSection(std::vector<uint8_t>& data, uint32_t baseOffset, const T* pRecords, size_t count)
+{
+	FBinSection section;
+	section.Offset = baseOffset + (uint32_t)data.size();
+	section.Count = (uint32_t)count;
+	const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pRecords);
+	data.insert(data.end(), pBytes, pBytes + count * sizeof(T));
+	return section;
+}
+
+template <typename T>
+static FBinSection AppendSection(std::vector<uint8_t>& data, uint32_t baseOffset, const std::vector<T>& records)
+{
+	return AppendSection(data, baseOffset, records.data(), records.size());
+}
+
+template <typename T>
+static T* GetSectionData(std::vector<uint8_t>& data, uint32_t baseOffset, const FBinSection& section)
+{
+	return reinterpret_cast<T*>(data.data() + (section.Offset - baseOffset));
+}
+
+// Build all the sections of a save, to be written at baseOffset in the file
+// Pages in pOldPages that haven't changed since the last save keep their existing records
+static void BuildSections(FCodeAnalysisState& state, bool bROMS, const std::unordered_map<int16_t, FBinPage>* pOldPages,
+	uint32_t baseOffset, std::vector<uint8_t>& outData, FBinHeader& outHeader)
+{
+	FBinExportContext context;
+	const auto& banks = state.GetBanks();
+
+	for (int bankNo = 0; bankNo < banks.size(); bankNo++)
+	{
+		const FCodeAnalysisBank& bank = banks[bankNo];
+		if (bank.bReadOnly != bROMS)	// skip read only banks - ROM
+			continue;
+
+		context.Banks.push_back({ bank.Id, (uint16_t)bank.NoPages, context.Strings.Add(bank.Description) });
+
+		for (int pageNo = 0; pageNo < bank.NoPages; pageNo++)
+		{
+			const FCodeAnalysisPage& page = bank.Pages[pageNo];
+			if (pOldPages != nullptr && state.HasPageChangedSinceSave(page) == false)
+			{
+				const auto oldPageIt = pOldPages->find(page.PageId);
+				if (oldPageIt != pOldPages->end())
+				{
+					context.Pages.push_back(oldPageIt->second);
+					context.PageReused.push_back(true);
+					continue;
+				}
+			}
+
+			WritePageToBinary(page, context);
+		}
+	}
+
+	std::vector<FBinCharacterSet> characterSets;
+	for (int i = 0; i < GetNoCharacterSets(); i++)
+	{
+		const FCharSetCreateParams& params = GetCharacterSetFromIndex(i)->Params;
+		FBinCharacterSet& charSet = characterSets.emplace_back();
+		charSet.AddressRef = params.Address.Val;
+		charSet.AttribsAddressRef = params.AttribsAddress.Val;
+		charSet.MaskInfo = (uint8_t)params.MaskInfo;
+		charSet.ColourInfo = (uint8_t)params.ColourInfo;
+		charSet.BitmapFormat = (uint8_t)params.BitmapFormat;
+		charSet.Dynamic = params.bDynamic ? 1 : 0;
+		charSet.PaletteNo = params.PaletteNo;
+	}
+
+	std::vector<FBinCharacterMap> characterMaps;
+	for (int i = 0; i < GetNoCharacterMaps(); i++)
+	{
+		const FCharMapCreateParams& params = GetCharacterMapFromIndex(i)->Params;
+		FBinCharacterMap charMap = {};
+		charMap.AddressRef = params.Address.Val;
+		charMap.CharacterSetRef = params.CharacterSet.Val;
+		charMap.Width = (uint16_t)params.Width;
+		charMap.Height = (uint16_t)params.Height;
+		charMap.IgnoreCharacter = params.IgnoreCharacter;
+		characterMaps.push_back(charMap);
+	}
+
+	std::vector<FPaletteEntry> palettes;
+	for (int i = 0; i < GetNoPaletteEntries(); i++)
+		palettes.push_back(*GetPaletteEntry(i));
+	int noPaletteColours = 0;
+	const uint32_t* pPaletteColours = GetPaletteColours(noPaletteColours);
+
+	// lay out the sections
+	FBinHeader& header = outHeader;
+	header.Banks = AppendSection(outData, baseOffset, context.Banks);
+	header.Pages = AppendSection(outData, baseOffset, context.Pages);
+	header.CodeInfo = AppendSection(outData, baseOffset, context.CodeInfo);
+	header.DataInfo = AppendSection(outData, baseOffset, context.DataInfo);
+	header.Labels = AppendSection(outData, baseOffset, context.Labels);
+	header.CommentBlocks = AppendSection(outData, baseOffset, context.CommentBlocks);
+	header.CharacterSets = AppendSection(outData, baseOffset, characterSets);
+	header.CharacterMaps = AppendSection(outData, baseOffset, characterMaps);
+	header.PaletteColours = AppendSection(outData, baseOffset, pPaletteColours, noPaletteColours);
+	header.Palettes = AppendSection(outData, baseOffset, palettes);
+	header.Strings = AppendSection(outData, baseOffset, context.Strings.Data);
+
+	// string references are now file offsets
+	const uint32_t stringBase = header.Strings.Offset;
+	auto fixupString = [stringBase](uint32_t& stringRef) { if (stringRef != 0) stringRef += stringBase; };
+	FBinBank* pBanks = GetSectionData<FBinBank>(outData, baseOffset, header.Banks);
+	for (uint32_t i = 0; i < header.Banks.Count; i++)
+		fixupString(pBanks[i].Description);
+	FBinCodeRecord* pCodeInfo = GetSectionData<FBinCodeRecord>(outData, baseOffset, header.CodeInfo);
+	for (uint32_t i = 0; i < header.CodeInfo.Count; i++)
+		fixupString(pCodeInfo[i].Comment);
+	FBinDataRecord* pDataInfo = GetSectionData<FBinDataRecord>(outData, baseOffset, header.DataInfo);
+	for (uint32_t i = 0; i < header.DataInfo.Count; i++)
+		fixupString(pDataInfo[i].Comment);
+	FBinLabelRecord* pLabels = GetSectionData<FBinLabelRecord>(outData, baseOffset, header.Labels);
+	for (uint32_t i = 0; i < header.Labels.Count; i++)
+	{
+		fixupString(pLabels[i].Name);
+		fixupString(pLabels[i].Comment);
+	}
+	FBinCommentBlockRecord* pCommentBlocks = GetSectionData<FBinCommentBlockRecord>(outData, baseOffset, header.CommentBlocks);
+	for (uint32_t i = 0; i < header.CommentBlocks.Count; i++)
+		fixupString(pCommentBlocks[i].Comment);
+
+	// as are the record ranges of the pages just written
+	FBinPage* pPages = GetSectionData<FBinPage>(outData, baseOffset, header.Pages);
+	for (uint32_t i = 0; i < header.Pages.Count; i++)
+	{
+		if (context.PageReused[i])
+			continue;
+		pPages[i].CodeInfo.Offset = header.CodeInfo.Offset + pPages[i].CodeInfo.Offset * sizeof(FBinCodeRecord);
+		pPages[i].DataInfo.Offset = header.DataInfo.Offset + pPages[i].DataInfo.Offset * sizeof(FBinDataRecord);
+		pPages[i].Labels.Offset = header.Labels.Offset + pPages[i].Labels.Offset * sizeof(FBinLabelRecord);
+		pPages[i].CommentBlocks.Offset = header.CommentBlocks.Offset + pPages[i].CommentBlocks.Offset * sizeof(FBinCommentBlockRecord);
+	}
+
+	LOGINFO("%d of %d pages written", context.PagesWritten, (int)context.Pages.size());
+}
+
+// write to a temporary file first so a failed save doesn't lose the existing file
+static bool SaveFileSafely(const char* pFileName, const void* pData, size_t byteCount)
+{
+	const std::string tempFileName = std::string(pFileName) + ".tmp";
+	if (SaveBinaryFile(tempFileName.c_str(), pData, byteCount) == false)
+		return false;
+
+	if (rename(tempFileName.c_str(), pFileName) != 0)
+	{
+		// Windows won't rename over an existing file
+		remove(pFileName);
+		if (rename(tempFileName.c_str(), pFileName) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+bool ExportAnalysisBinary(FCodeAnalysisState& state, const char* pFileName, bool bROMS)
+{
+	std::vector<uint8_t> fileData(sizeof(FBinHeader));
+	FBinHeader header;
+	BuildSections(state, bROMS, nullptr, sizeof(FBinHeader), fileData, header);
+	header.FileSize = (uint32_t)fileData.size();
+	header.BaseSize = header.FileSize;
+	memcpy(fileData.data(), &header, sizeof(FBinHeader));
+
+	if (SaveFileSafely(pFileName, fileData.data(), fileData.size()) == false)
+		return false;
+
+	if (bROMS == false)
+		state.SetSyncedAnalysisFile(pFileName, fileData.size());
+	return true;
+}
+
+// Import
+
+struct FBinFile
+{
+	bool	Open(const char* pFileName)
+	{
+		bMapped = true;
+		pData = static_cast<const uint8_t*>(MapFile(pFileName, Size));
+		if (pData == nullptr)	// fall back to reading it in
+		{
+			bMapped = false;
+			pData = static_cast<const uint8_t*>(LoadBinaryFile(pFileName, Size));
+		}
+		pHeader = pData != nullptr ? ValidateHeader() : nullptr;
+		return pData != nullptr;
+	}
+
+	void	Close()
+	{
+		if (bMapped)
+			UnmapFile(pData, Size);
+		else
+			free(const_cast<uint8_t*>(pData));
+		pData = nullptr;
+		pHeader = nullptr;
+		Size = 0;
+	}
+
+	// nullptr if the file isn't valid
+	const FBinHeader*	GetHeader() const { return pHeader; }
+
+	template <typename T>
+	const T* GetSection(const FBinSection& section) const
+	{
+		if ((uint64_t)section.Offset + (uint64_t)section.Count * sizeof(T) > pHeader->FileSize)
+			return nullptr;
+		return reinterpret_cast<const T*>(pData + section.Offset);
+	}
+
+	template <typename T>
+	const T* GetPageRecords(const FBinSection& pageRange, const FBinSection& column) const
+	{
+		FBinSection range = pageRange;
+		if (pHeader->Version == 1)
+			range.Offset = column.Offset + range.Offset * sizeof(T);
+		return GetSection<T>(range);
+	}
+
+	// strings are null terminated as the file ends with a string pool
+	const char* GetString(uint32_t stringRef) const
+	{
+		return stringRef != 0 && stringRef < pHeader->FileSize ? reinterpret_cast<const char*>(pData + stringRef) : "";
+	}
+
+private:
+	// there can be data from an interrupted save after the end of the file described by the header
+	const FBinHeader*	ValidateHeader() const
+	{
+		if (Size < sizeof(FBinHeader))
+			return nullptr;
+
+		const FBinHeader* pFileHeader = reinterpret_cast<const FBinHeader*>(pData);
+		if (pFileHeader->Magic != kBinMagic || pFileHeader->Version > kBinVersion || pFileHeader->FileSize > Size || pFileHeader->FileSize < sizeof(FBinHeader))
+			return nullptr;
+		if (pData[pFileHeader->FileSize - 1] != 0)	// string pool is always last
+			return nullptr;
+
+		return pFileHeader;
+	}
+
+	const uint8_t*		pData = nullptr;
+	const FBinHeader*	pHeader = nullptr;
+	size_t				Size = 0;
+	bool				bMapped = false;
+};
+
+static bool ReadAnalysisBinary(FCodeAnalysisState& state, const FBinFile& file)
+{
+	const FBinHeader* pHeader = file.GetHeader();
+	if (pHeader == nullptr)
+		return false;
+
+	const FBinBank* pBanks = file.GetSection<FBinBank>(pHeader->Banks);
+	const FBinPage* pPages = file.GetSection<FBinPage>(pHeader->Pages);
+	const FBinCharacterSet* pCharacterSets = file.GetSection<FBinCharacterSet>(pHeader->CharacterSets);
+	const FBinCharacterMap* pCharacterMaps = file.GetSection<FBinCharacterMap>(pHeader->CharacterMaps);
+	const uint32_t* pPaletteColours = file.GetSection<uint32_t>(pHeader->PaletteColours);
+	const FPaletteEntry* pPalettes = file.GetSection<FPaletteEntry>(pHeader->Palettes);
+
+	if (pBanks == nullptr || pPages == nullptr || pCharacterSets == nullptr || pCharacterMaps == nullptr || pPaletteColours == nullptr || pPalettes == nullptr)
+	{
+		LOGERROR("Analysis binary file is corrupt");
+		return false;
+	}
+
+	for (uint32_t bankNo = 0; bankNo < pHeader->Banks.Count; bankNo++)
+	{
+		FCodeAnalysisBank* pBank = state.GetBank(pBanks[bankNo].BankId);
+		if (pBank != nullptr)
+			pBank->Description = file.GetString(pBanks[bankNo].Description);
+	}
+
+	// items can run on into the following pages of their bank but no further
+	std::unordered_map<int16_t, int> pageBytesToBankEnd;
+	for (const FCodeAnalysisBank& bank : state.GetBanks())
+	{
+		for (int bankPageNo = 0; bankPageNo < bank.NoPages; bankPageNo++)
+			pageBytesToBankEnd[bank.Pages[bankPageNo].PageId] = (bank.NoPages - bankPageNo) * FCodeAnalysisPage::kPageSize;
+	}
+
+	for (uint32_t pageNo = 0; pageNo < pHeader->Pages.Count; pageNo++)
+	{
+		const FBinPage& binPage = pPages[pageNo];
+		if (state.IsValidPageId(binPage.PageId) == false)
+			continue;
+		FCodeAnalysisPage* pPage = state.GetPage(binPage.PageId);
+		if (pPage == nullptr)
+			continue;
+
+		const FBinCommentBlockRecord* pCommentBlocks = file.GetPageRecords<FBinCommentBlockRecord>(binPage.CommentBlocks, pHeader->CommentBlocks);
+		const FBinLabelRecord* pLabels = file.GetPageRecords<FBinLabelRecord>(binPage.Labels, pHeader->Labels);
+		const FBinCodeRecord* pCodeInfo = file.GetPageRecords<FBinCodeRecord>(binPage.CodeInfo, pHeader->CodeInfo);
+		const FBinDataRecord* pDataInfo = file.GetPageRecords<FBinDataRecord>(binPage.DataInfo, pHeader->DataInfo);
+		if (pCommentBlocks == nullptr || pLabels == nullptr || pCodeInfo == nullptr || pDataInfo == nullptr)
+		{
+			LOGERROR("Analysis binary page %d is corrupt", binPage.PageId);
+			continue;
+		}
+
+		for (uint32_t i = 0; i < binPage.CommentBlocks.Count; i++)
+		{
+			const FBinCommentBlockRecord& record = pCommentBlocks[i];
+			FCommentBlock* pCommentBlock = FCommentBlock::Allocate();
+			pCommentBlock->Comment = file.GetString(record.Comment);
+			pPage->CommentBlocks[record.PageAddr & FCodeAnalysisPage::kPageMask] = pCommentBlock;
+		}
+
+		for (uint32_t i = 0; i < binPage.Labels.Count; i++)
+		{
+			const FBinLabelRecord& record = pLabels[i];
+			FLabelInfo* pLabelInfo = FLabelInfo::Allocate(state.GetLabelNames());
+			pLabelInfo->InitialiseName(file.GetString(record.Name));
+			pLabelInfo->Global = record.Global != 0;
+			pLabelInfo->LabelType = (ELabelType)record.LabelType;
+			pLabelInfo->Comment = file.GetString(record.Comment);
+			pLabelInfo->EnsureUniqueName();	// add to the name index
+			pPage->Labels[record.PageAddr & FCodeAnalysisPage::kPageMask] = pLabelInfo;
+		}
+
+		const auto bankEndIt = pageBytesToBankEnd.find(binPage.PageId);
+		const int bytesToBankEnd = bankEndIt != pageBytesToBankEnd.end() ? bankEndIt->second : FCodeAnalysisPage::kPageSize;
+		auto isValidItemSize = [bytesToBankEnd](uint16_t pageAddr, int byteSize)
+		{
+			return byteSize > 0 && (pageAddr & FCodeAnalysisPage::kPageMask) + byteSize <= bytesToBankEnd;
+		};
+		int noBadRecords = 0;
+
+		for (uint32_t i = 0; i < binPage.CodeInfo.Count; i++)
+		{
+			const FBinCodeRecord& record = pCodeInfo[i];
+			if (isValidItemSize(record.PageAddr, record.ByteSize) == false)
+			{
+				noBadRecords++;
+				continue;
+			}
+			FCodeInfo* pCodeInfoItem = FCodeInfo::Allocate();
+			pCodeInfoItem->ByteSize = record.ByteSize;
+			pCodeInfoItem->OperandType = (EOperandType)record.OperandType;
+			pCodeInfoItem->Flags = record.Flags;
+			pCodeInfoItem->Comment = file.GetString(record.Comment);
+			pPage->CodeInfo[record.PageAddr & FCodeAnalysisPage::kPageMask] = pCodeInfoItem;
+		}
+
+		for (uint32_t i = 0; i < binPage.DataInfo.Count; i++)
+		{
+			const FBinDataRecord& record = pDataInfo[i];
+			if (isValidItemSize(record.PageAddr, record.ByteSize) == false)
+			{
+				noBadRecords++;
+				continue;
+			}
+			FDataInfo& dataInfo = pPage->DataInfo[record.PageAddr & FCodeAnalysisPage::kPageMask];
+			dataInfo.ByteSize = record.ByteSize;
+			dataInfo.DataType = (EDataType)record.DataType;
+			dataInfo.DisplayType = (EDataItemDisplayType)record.DisplayType;
+			dataInfo.EmptyCharNo = record.EmptyCharNo;
+			dataInfo.Flags = record.Flags;
+			dataInfo.InstructionAddress.Val = record.AddressRef;
+			dataInfo.PaletteNo = record.PaletteNo;
+			dataInfo.Comment = file.GetString(record.Comment);
+		}
+
+		if (noBadRecords > 0)
+			LOGERROR("Analysis binary page %d has %d items with bad sizes, they have been skipped", binPage.PageId, noBadRecords);
+
+		pPage->bUsed = true;
+	}
+
+	// palettes may be needed to create the character sets
+	SetPaletteStore(pPaletteColours, pHeader->PaletteColours.Count, pPalettes, pHeader->Palettes.Count);
+
+	for (uint32_t i = 0; i < pHeader->CharacterSets.Count; i++)
+	{
+		const FBinCharacterSet& charSet = pCharacterSets[i];
+		FCharSetCreateParams params;
+		params.Address.Val = charSet.AddressRef;
+		params.AttribsAddress.Val = charSet.AttribsAddressRef;
+		params.MaskInfo = (EMaskInfo)charSet.MaskInfo;
+		params.ColourInfo = (EColourInfo)charSet.ColourInfo;
+		params.BitmapFormat = (EBitmapFormat)charSet.BitmapFormat;
+		params.bDynamic = charSet.Dynamic != 0;
+		params.PaletteNo = charSet.PaletteNo;
+		params.ColourLUT = state.Config.CharacterColourLUT;
+		CreateCharacterSetAt(state, params);
+	}
+
+	for (uint32_t i = 0; i < pHeader->CharacterMaps.Count; i++)
+	{
+		const FBinCharacterMap& charMap = pCharacterMaps[i];
+		FCharMapCreateParams params;
+		params.Address.Val = charMap.AddressRef;
+		params.CharacterSet.Val = charMap.CharacterSetRef;
+		params.Width = charMap.Width;
+		params.Height = charMap.Height;
+		params.IgnoreCharacter = charMap.IgnoreCharacter;
+		CreateCharacterMap(state, params);
+	}
+
+	return true;
+}
+
+bool ImportAnalysisBinary(FCodeAnalysisState& state, const char* pFileName)
+{
+	FBinFile file;
+	if (file.Open(pFileName) == false)
+		return false;
+
+	const bool bLoaded = ReadAnalysisBinary(state, file);
+	if (bLoaded)
+		state.SetSyncedAnalysisFile(pFileName, file.GetHeader()->FileSize);
+
+	file.Close();
+	return bLoaded;
+}
+
+// Incremental save
+
+bool ExportAnalysisBinaryChanges(FCodeAnalysisState& state, const char* pFileName)
+{
+	FBinFile file;
+	if (file.Open(pFileName) == false)
+		return ExportAnalysisBinary(state, pFileName);
+
+	// can only add to the file if it's the one we loaded or last saved
+	const FBinHeader* pOldHeader = file.GetHeader();
+	const FBinPage* pOldPages = pOldHeader != nullptr ? file.GetSection<FBinPage>(pOldHeader->Pages) : nullptr;
+	if (pOldPages == nullptr || pOldHeader->Version != kBinVersion || state.IsSyncedWithAnalysisFile(pFileName, pOldHeader->FileSize) == false ||
+		pOldHeader->FileSize - pOldHeader->BaseSize > pOldHeader->BaseSize)	// compact once the file has doubled in size
+	{
+		file.Close();
+		return ExportAnalysisBinary(state, pFileName);
+	}
+
+	std::unordered_map<int16_t, FBinPage> oldPages;
+	for (uint32_t i = 0; i < pOldHeader->Pages.Count; i++)
+		oldPages[pOldPages[i].PageId] = pOldPages[i];
+
+	const uint32_t oldFileSize = pOldHeader->FileSize;
+	const uint32_t baseOffset = (oldFileSize + 3) & ~3;
+	FBinHeader header;
+	header.BaseSize = pOldHeader->BaseSize;
+	file.Close();
+
+	std::vector<uint8_t> appendData;
+	BuildSections(state, false, &oldPages, baseOffset, appendData, header);
+	header.FileSize = baseOffset + (uint32_t)appendData.size();
+
+	FILE* fp = fopen(pFileName, "r+b");
+	if (fp == nullptr)
+		return false;
+
+	// the old header still describes a complete file until the new one is written
+	const uint8_t padding[4] = { 0 };
+	bool bWritten = fseek(fp, oldFileSize, SEEK_SET) == 0 &&
+		fwrite(padding, 1, baseOffset - oldFileSize, fp) == baseOffset - oldFileSize &&
+		fwrite(appendData.data(), 1, appendData.size(), fp) == appendData.size() &&
+		fflush(fp) == 0;
+	if (bWritten)
+		bWritten = fseek(fp, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(FBinHeader), 1, fp) == 1 && fflush(fp) == 0;
+	fclose(fp);
+
+	if (bWritten)
+		state.SetSyncedAnalysisFile(pFileName, header.FileSize);
+	return bWritten;
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+class FCodeAnalysisState;
+
+// Binary analysis file
+// Columnar layout of fixed size records that is loaded by mapping the file and fixing up offsets.
+// This is the project format - Json is still available as an interchange export.
+bool ExportAnalysisBinary(FCodeAnalysisState& state, const char* pFileName, bool bROMS = false);
+bool ImportAnalysisBinary(FCodeAnalysisState& state, const char* pFileName);
+
+// Only write the pages that have changed since the file was loaded or saved, appending them to the file.
+// Falls back to a full save if the file doesn't match the analysis or has grown too much.
+bool ExportAnalysisBinaryChanges(FCodeAnalysisState& state, const char* pFileName);
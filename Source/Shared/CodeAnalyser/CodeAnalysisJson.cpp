@@ -15,7 +15,7 @@ void WritePageToJson(const FCodeAnalysisPage& page, json& jsonDoc);
 void ReadPageFromJson(FCodeAnalysisState& state, FCodeAnalysisPage& page, const json& jsonDoc);
 FCommentBlock* CreateCommentBlockFromJson(const json& commentBlockJson);
 FCodeInfo* CreateCodeInfoFromJson(const json& codeInfoJson);
-FLabelInfo* CreateLabelInfoFromJson(const json& labelInfoJson);
+FLabelInfo* CreateLabelInfoFromJson(FCodeAnalysisState& state, const json& labelInfoJson);
 void LoadDataInfoFromJson(FCodeAnalysisState& state, FDataInfo* pDataInfo, const json& dataInfoJson);
 
 bool ExportAnalysisJson(FCodeAnalysisState& state, const char* pJsonFileName, bool bROMS)
@@ -111,6 +111,8 @@ bool ImportAnalysisJson(FCodeAnalysisState& state, const char* pJsonFileName)
 	inFileStream >> jsonGameData;
 	inFileStream.close();
 
+	FGlobalLabelBatchScope labelBatch(state);
+
 	if (jsonGameData.contains("Banks"))
 	{
 		for (const auto& bankJson : jsonGameData["Banks"])
@@ -189,7 +191,7 @@ bool ImportAnalysisJson(FCodeAnalysisState& state, const char* pJsonFileName)
 		for (const auto labelInfoJson : jsonGameData["LabelInfo"])
 		{
 			const uint16_t addr = labelInfoJson["Address"];
-			FLabelInfo* pLabelInfo = CreateLabelInfoFromJson(labelInfoJson);
+			FLabelInfo* pLabelInfo = CreateLabelInfoFromJson(state, labelInfoJson);
 			state.SetLabelForPhysicalAddress(addr, pLabelInfo);
 		}
 	}
@@ -432,11 +434,12 @@ FCodeInfo* CreateCodeInfoFromJson(const json& codeInfoJson)
 	return pCodeInfo;
 }
 
-FLabelInfo* CreateLabelInfoFromJson(const json& labelInfoJson)
+FLabelInfo* CreateLabelInfoFromJson(FCodeAnalysisState& state, const json& labelInfoJson)
 {
-	FLabelInfo* pLabelInfo = FLabelInfo::Allocate();
+	FLabelInfo* pLabelInfo = FLabelInfo::Allocate(state.GetLabelNames());
 
 	pLabelInfo->InitialiseName(((std::string)labelInfoJson["Name"]).c_str());
+	pLabelInfo->EnsureUniqueName();	// add to the name index
 	if (labelInfoJson.contains("Global"))
 		pLabelInfo->Global = true;
 
@@ -559,7 +562,7 @@ void ReadPageFromJson(FCodeAnalysisState &state, FCodeAnalysisPage& page, const
 		for (const auto labelInfoJson : jsonDoc["LabelInfo"])
 		{
 			const uint16_t pageAddr = labelInfoJson["Address"];
-			FLabelInfo* pLabelInfo = CreateLabelInfoFromJson(labelInfoJson);
+			FLabelInfo* pLabelInfo = CreateLabelInfoFromJson(state, labelInfoJson);
 			page.Labels[pageAddr] = pLabelInfo;
 		}
 	}
@@ -7,10 +7,10 @@
 #include <string.h>
 
 //#include "json.hpp"
-std::vector<FCodeInfo*>		FCodeInfo::AllocatedList;
-std::vector<FLabelInfo*>				FLabelInfo::AllocatedList;
-std::unordered_map<std::string, int>	FLabelInfo::LabelUsage;
-std::vector<FCommentBlock*>	FCommentBlock::AllocatedList;
+FItemSlabAllocator<FCodeInfo>		FCodeInfo::Allocator;
+FItemSlabAllocator<FLabelInfo>		FLabelInfo::Allocator;
+FItemSlabAllocator<FCommentBlock>	FCommentBlock::Allocator;
+const FDataReferences				FCodeAnalysisPage::NoDataReferences;
 
 FImageData::~FImageData() 
 { 
@@ -19,24 +19,41 @@ FImageData::~FImageData()
 
 FCodeInfo* FCodeInfo::Allocate()
 {
-	FCodeInfo* pCodeInfo = new FCodeInfo;
-	AllocatedList.push_back(pCodeInfo);
-	return pCodeInfo;
+	return Allocator.Allocate();
 }
 
 void FCodeInfo::FreeAll()
 {
-	for (auto it : AllocatedList)
-		delete it;
+	Allocator.FreeAll();
+}
 
-	AllocatedList.clear();
+void FLabelNames::Reset()
+{
+	Index.clear();
+	SuffixCount.clear();
 }
 
-FLabelInfo* FLabelInfo::Allocate()
+void FLabelNames::Clear()
 {
-	FLabelInfo* pLabelInfo = new FLabelInfo;
-	AllocatedList.push_back(pLabelInfo);
-	return pLabelInfo;
+	Reset();
+	Pool.Clear();
+}
+
+FLabelInfo* FLabelNames::FindLabel(const char* pName) const
+{
+	const FStringHandle name = Pool.Find(pName);
+	if (name == 0)
+		return nullptr;
+
+	auto labelIt = Index.find(name);
+	return labelIt != Index.end() ? labelIt->second : nullptr;
+}
+
+FLabelInfo* FLabelInfo::Allocate(FLabelNames& names)
+{
+	FLabelInfo* pLabel = Allocator.Allocate();
+	pLabel->pNames = &names;
+	return pLabel;
 }
 
 FLabelInfo* FLabelInfo::Duplicate(const FLabelInfo* pSourceLabel)
@@ -44,41 +61,69 @@ FLabelInfo* FLabelInfo::Duplicate(const FLabelInfo* pSourceLabel)
 	if(pSourceLabel == nullptr)
 		return nullptr;
 
-	FLabelInfo* pDuplicateLabel = Allocate();
+	FLabelInfo* pDuplicateLabel = Allocate(*pSourceLabel->pNames);
 	*pDuplicateLabel = *pSourceLabel;
 	return pDuplicateLabel;
 }
 
 void FLabelInfo::FreeAll()
 {
-	for (auto it : AllocatedList)
-		delete it;
+	Allocator.FreeAll();
+}
 
-	AllocatedList.clear();
+bool FLabelInfo::EnsureUniqueName(void)
+{
+	auto& nameIndex = pNames->Index;
+	auto labelIt = nameIndex.find(Name);
+	if (labelIt == nameIndex.end())
+	{
+		nameIndex[Name] = this;
+		return false;
+	}
+	if (labelIt->second == this)
+		return false;
+
+	// add a postfix number until the name isn't used
+	const std::string baseName = GetName();
+	int& suffixNo = pNames->SuffixCount[Name];
+	char postFix[32];
+	do
+	{
+		snprintf(postFix, 32, "_%d", ++suffixNo);
+		Name = pNames->Pool.Intern(baseName + postFix);
+	} 
+	while (nameIndex.find(Name) != nameIndex.end());
+
+	nameIndex[Name] = this;
+	return true;
+}
+
+void FLabelInfo::RemoveName(void)
+{
+	auto labelIt = pNames->Index.find(Name);
+	if (labelIt != pNames->Index.end() && labelIt->second == this)
+		pNames->Index.erase(labelIt);
 }
 
 FCommentBlock* FCommentBlock::Allocate()
 {
-	FCommentBlock* pCommentBlock = new FCommentBlock;
-	AllocatedList.push_back(pCommentBlock);
-	return pCommentBlock;
+	return Allocator.Allocate();
 }
 
 void FCommentBlock::FreeAll()
 {
-	for (auto it : AllocatedList)
-		delete it;
-
-	AllocatedList.clear();
+	Allocator.FreeAll();
 }
 
 void FCodeAnalysisPage::Initialise()
 {
 	bUsed = false;
+	bStringsDirty = true;
 	
 	memset(Labels, 0, sizeof(Labels));
 	memset(CodeInfo, 0, sizeof(CodeInfo));
 	memset(CommentBlocks, 0, sizeof(CommentBlocks));
+	ResetDataReferences();
 
 	for (int addr = 0; addr < FCodeAnalysisPage::kPageSize; addr++)
 	{
@@ -87,6 +132,7 @@ void FCodeAnalysisPage::Initialise()
 		dataInfo.ByteSize = 1;
 		dataInfo.DataType = EDataType::Byte;
 	}
+	DataAccesses.Reset();
 }
 
 
@@ -98,12 +144,49 @@ void FCodeAnalysisPage::Reset(void)
 		CommentBlocks[addr] = nullptr;
 		CodeInfo[addr] = nullptr;
 		DataInfo[addr].Reset();
-		MachineState[addr] = nullptr;
 	}
+	MachineStates.clear();
 
 	Initialise();
 }
 
+void FCodeAnalysisPage::FDataAccessArrays::Reset()
+{
+	for (int addr = 0; addr < kPageSize; addr++)
+	{
+		ReadCount[addr] = 0;
+		LastFrameRead[addr] = -1;
+		WriteCount[addr] = 0;
+		LastFrameWritten[addr] = -1;
+		LastWriter[addr] = FAddressRef();
+	}
+}
+
+void FCodeAnalysisPage::SetMachineState(uint16_t pageAddr, FMachineState* pMachineState)
+{
+	if (pMachineState == nullptr)
+		MachineStates.erase(pageAddr);
+	else
+		MachineStates[pageAddr] = pMachineState;
+}
+
+FDataReferences& FCodeAnalysisPage::AddDataReferences(uint16_t pageAddr)
+{
+	uint16_t& entryNo = DataReferenceIndex[pageAddr];
+	if (entryNo == 0)
+	{
+		DataReferences.emplace_back();
+		entryNo = (uint16_t)DataReferences.size();
+	}
+	return DataReferences[entryNo - 1];
+}
+
+void FCodeAnalysisPage::ResetDataReferences()
+{
+	memset(DataReferenceIndex, 0, sizeof(DataReferenceIndex));
+	DataReferences.clear();
+}
+
 static const uint32_t kMagic = 0xc0de;
 static const uint32_t kVersionNo = 2;
 
@@ -280,20 +363,25 @@ bool FCodeAnalysisPage::ReadFromBuffer(FMemoryBuffer& buffer)
 }
 #endif
 
-void FCodeAnalysisPage::SetLabelAtAddress(const char* pLabelName, ELabelType type, uint16_t addr)
+// the page doesn't know its bank so the caller regenerates the global label lists when this returns true
+bool FCodeAnalysisPage::SetLabelAtAddress(FCodeAnalysisState& state, const char* pLabelName, ELabelType type, uint16_t addr)
 {
 	FLabelInfo* pLabel = Labels[addr];
 	if (pLabel == nullptr)
 	{
-		pLabel = FLabelInfo::Allocate();
+		pLabel = FLabelInfo::Allocate(state.GetLabelNames());
 		pLabel->InitialiseName(pLabelName);
-		Labels[addr] = pLabel;
-	}
-	else
-	{
-		pLabel->ChangeName(pLabelName);
 		pLabel->LabelType = type;
+		Labels[addr] = pLabel;
+		return true;
 	}
+
+	pLabel->ChangeName(pLabelName);
+	if (pLabel->LabelType == type)
+		return false;
+
+	pLabel->LabelType = type;
+	return true;
 }
 
 #if 0
@@ -4,12 +4,14 @@
 #include <string>
 //#include <map>
 #include <vector>
+#include <unordered_map>
 
 #include <Util/Misc.h>
 
 #include "CodeAnalyserTypes.h"
 
 class FMemoryBuffer;
+class FCodeAnalysisState;
 
 
 
@@ -28,17 +30,57 @@ struct FCodeAnalysisPage
 	//void WriteToBuffer(FMemoryBuffer& buffer);
 	//bool ReadFromBuffer(FMemoryBuffer& buffer);
 
-	void SetLabelAtAddress(const char* pLabelName, ELabelType type, uint16_t addr);
+	bool SetLabelAtAddress(FCodeAnalysisState& state, const char* pLabelName, ELabelType type, uint16_t addr);	// returns true if the global label lists need updating
+
+	FMachineState*	GetMachineState(uint16_t pageAddr) const
+	{
+		const auto it = MachineStates.find(pageAddr);
+		return it != MachineStates.end() ? it->second : nullptr;
+	}
+	void SetMachineState(uint16_t pageAddr, FMachineState* pMachineState);
+
+	const FDataReferences& GetDataReferences(uint16_t pageAddr) const
+	{
+		const uint16_t entryNo = DataReferenceIndex[pageAddr];
+		return entryNo != 0 ? DataReferences[entryNo - 1] : NoDataReferences;
+	}
+	FDataReferences& AddDataReferences(uint16_t pageAddr);
+	void ResetDataReferences();
+
 	static const int kPageSize = 1024;	// 1Kb page
 	static const int kPageShift = 10;	// 1Kb page
 	static const int kPageMask = kPageSize - 1;
+	static const int kWriteLineShift = 6;	// writes are tracked in 64 byte lines
+	static const int kNoWriteLines = kPageSize >> kWriteLineShift;
+
+	// Data access info the memory access path updates, in dense arrays apart from FDataInfo to keep the per tick working set small
+	struct FDataAccessArrays
+	{
+		void	Reset();
+
+		int				ReadCount[kPageSize];
+		int				LastFrameRead[kPageSize];	// -1 if never read
+		int				WriteCount[kPageSize];
+		int				LastFrameWritten[kPageSize];	// -1 if never written
+		FAddressRef		LastWriter[kPageSize];
+	};
 
 	bool			bUsed = false;	// has this page been used?
 	int16_t			PageId = -1;
+	uint32_t		ChangeGeneration = 0;	// analysis change generation this page was last modified in
+	bool			bStringsDirty = true;	// string cache needs to rescan this page
+	uint32_t		WriteGeneration = 0;	// write generation of the last write to the page
+	uint32_t		LineWriteGenerations[kNoWriteLines] = { 0 };
 	FLabelInfo*		Labels[kPageSize];
 	FCodeInfo*		CodeInfo[kPageSize];
 	FDataInfo		DataInfo[kPageSize];
+	FDataAccessArrays	DataAccesses;
 	FCommentBlock*	CommentBlocks[kPageSize];
 
-	FMachineState*	MachineState[kPageSize];
+	std::unordered_map<uint16_t, FMachineState*>	MachineStates;	// sparse, keyed by page offset - only a few addresses get a captured state
+
+	// sparse read & write references - only addresses accessed by code get an entry
+	uint16_t		DataReferenceIndex[kPageSize] = { 0 };	// 1 based entry in DataReferences, 0 for none
+	std::vector<FDataReferences>	DataReferences;
+	static const FDataReferences	NoDataReferences;
 };
\ No newline at end of file
@@ -39,29 +39,28 @@ void WritePageState(const FCodeAnalysisPage& page, FILE* fp)
 		if (pCodeInfoItem == nullptr || pCodeInfoItem->bSelfModifyingCode == true)
 		{
 			const FDataInfo* pDataInfo = &page.DataInfo[pageAddr];
+			const FDataReferences& dataRefs = page.GetDataReferences(pageAddr);
 
 			// check if we need to write
-			if (pDataInfo->Reads.GetReferences().empty() == false ||
-				pDataInfo->Writes.GetReferences().empty() == false ||
-				pDataInfo->LastWriter.IsValid())
+			if (dataRefs.IsEmpty() == false || page.DataAccesses.LastWriter[pageAddr].IsValid())
 			{
 				const uint16_t itemId = pageAddr | kDataId;
 				fwrite(&itemId, sizeof(itemId), 1, fp);
 
 				// Reads
-				tempU16 = (uint16_t)pDataInfo->Reads.GetReferences().size();
+				tempU16 = (uint16_t)dataRefs.Reads.GetReferences().size();
 				fwrite(&tempU16, sizeof(tempU16), 1, fp);
-				for (const auto& read : pDataInfo->Reads.GetReferences())
+				for (const auto& read : dataRefs.Reads.GetReferences())
 					fwrite(&read.Val, sizeof(read.Val), 1, fp);
 
 				// Writes
-				tempU16 = (uint16_t)pDataInfo->Writes.GetReferences().size();
+				tempU16 = (uint16_t)dataRefs.Writes.GetReferences().size();
 				fwrite(&tempU16, sizeof(tempU16), 1, fp);
-				for (const auto& write : pDataInfo->Writes.GetReferences())
+				for (const auto& write : dataRefs.Writes.GetReferences())
 					fwrite(&write.Val, sizeof(write.Val), 1, fp);
 
 				// Last Writer
-				fwrite(&pDataInfo->LastWriter.Val, sizeof(pDataInfo->LastWriter), 1, fp);
+				fwrite(&page.DataAccesses.LastWriter[pageAddr].Val, sizeof(FAddressRef), 1, fp);
 			}
 
 			pageAddr += pDataInfo->ByteSize;
@@ -105,31 +104,31 @@ void ReadPageState(FCodeAnalysisPage& page, FILE* fp)
 		}
 		else if (itemId & kDataId)
 		{
-			FDataInfo& dataItem = page.DataInfo[pageAddr];
+			FDataReferences& dataRefs = page.AddDataReferences(pageAddr);
 			uint16_t count;
 
 			// Reads
 			fread(&count, sizeof(count), 1, fp);
-			dataItem.Reads.Reset();
+			dataRefs.Reads.Reset();
 			for (int i = 0; i < count; i++)
 			{
 				FAddressRef ref;
 				fread(&ref.Val, sizeof(ref.Val), 1, fp);
-				dataItem.Reads.RegisterAccess(ref);
+				dataRefs.Reads.RegisterAccess(ref);
 			}
 
 			// Writes
 			fread(&count, sizeof(count), 1, fp);
-			dataItem.Writes.Reset();
+			dataRefs.Writes.Reset();
 			for (int i = 0; i < count; i++)
 			{
 				FAddressRef ref;
 				fread(&ref.Val, sizeof(ref.Val), 1, fp);
-				dataItem.Writes.RegisterAccess(ref);
+				dataRefs.Writes.RegisterAccess(ref);
 			}
 
 			// Last Writer
-			fread(&dataItem.LastWriter.Val, sizeof(dataItem.LastWriter.Val), 1, fp);
+			fread(&page.DataAccesses.LastWriter[pageAddr].Val, sizeof(FAddressRef), 1, fp);
 		}
 
 		fread(&itemId, sizeof(itemId), 1, fp);
@@ -67,6 +67,8 @@ void FFormatDataCommand::Do(FCodeAnalysisState& state)
 			pLabel->ChangeName(labelText.c_str());
 
 		pLabel->Global = true;
+		state.MarkPageChanged(addressRef);
+		state.UpdateGlobalLabelIndex(addressRef);
 	}
 
 	for (int itemNo = 0; itemNo < FormatOptions.NoItems; itemNo++)
@@ -78,6 +80,7 @@ void FFormatDataCommand::Do(FCodeAnalysisState& state)
 		pDataInfo->ByteSize = FormatOptions.ItemSize;
 		pDataInfo->DataType = FormatOptions.DataType;
 		pDataInfo->DisplayType = FormatOptions.DisplayType;
+		state.MarkPageChanged(addressRef);
 
 		if (FormatOptions.DataType == EDataType::CharacterMap)
 		{
@@ -5,10 +5,10 @@
 #include <chips/z80.h>
 
 #include <imgui.h>
+#include <misc/cpp/imgui_stdlib.h>
 #include "UI/CodeAnalyserUI.h"
-#include "Z80/Z80Disassembler.h"
-#include "6502/M6502Disassembler.h"
 #include <Util/GraphicsView.h>
+#include <Util/FileUtil.h>
 
 static const uint32_t	BPMask_Exec			= 0x0001;
 static const uint32_t	BPMask_DataWrite	= 0x0002;
@@ -18,6 +18,9 @@ static const uint32_t	BPMask_IOWrite		= 0x0010;
 static const uint32_t	BPMask_IRQ			= 0x0020;
 static const uint32_t	BPMask_NMI			= 0x0040;
 
+// breakpoint types that aren't looked up by address
+static const uint32_t	BPMask_NonAddress	= BPMask_IORead | BPMask_IOWrite | BPMask_IRQ | BPMask_NMI;
+
 void FDebugger::Init(FCodeAnalysisState* pCA)
 {
 	pCodeAnalysis = pCA;
@@ -38,156 +41,136 @@ void FDebugger::Init(FCodeAnalysisState* pCA)
 	}
     Watches.clear();
 	Stacks.clear();
+	ReverseExecution.Init(this, pCodeAnalysis);
 
 
 }
 
-void FDebugger::CPUTick(uint64_t pins)
+// bTickChecks enables the breakpoints & step modes that need checking every tick
+// it's off when there aren't any so the common case doesn't pay for them
+template <bool bTickChecks>
+void FDebugger::CPUTick(const FCPUTickPins& tick)
 {
-    const uint64_t risingPins = pins & (pins ^ LastTickPins);
-    int trapId = kTrapId_None;
-
-    uint16_t addr = 0;
-	bool bMemAccess = false;
-	bool bWrite = false;
-	bool bRead = false;
-	bool bNewOp = false;
-	bool bIORead = false;
-	bool bIOWrite = false;
-	bool bIrq = false;
-	bool bNMI = false;
-	uint32_t BPMaskCheck = 0;
-
-    if (CPUType == ECPUType::Z80)
-    {
-        addr = Z80_GET_ADDR(pins);
-
-        bMemAccess = !!((pins & Z80_CTRL_PIN_MASK) & Z80_MREQ);
-		bWrite = (risingPins & Z80_CTRL_PIN_MASK) == (Z80_MREQ | Z80_WR);
-		bRead = (risingPins & Z80_CTRL_PIN_MASK) == (Z80_MREQ | Z80_RD);
-        bNewOp = z80_opdone(pZ80);
-		bIORead = (pins & Z80_CTRL_PIN_MASK) == (Z80_IORQ | Z80_RD);
-		bIOWrite = (pins & Z80_CTRL_PIN_MASK) == (Z80_IORQ | Z80_WR);
-		bIrq = (pins & Z80_INT) && pZ80->iff1;
-		bNMI = risingPins & Z80_NMI;
-    }
-    else if (CPUType == ECPUType::M6502)
-    {
-		addr = M6502_GET_ADDR(pins);
-		bMemAccess = (pins & M6502_SYNC) == 0;
-		bRead = pins & M6502_RW;
-		bWrite = !bRead;
-		bNewOp =  pins & M6502_SYNC;
-		bIrq = risingPins & M6502_IRQ;
-		bNMI = risingPins & M6502_NMI;
-	}
-
-	// setup breakpoint mask to check
-	BPMaskCheck |= bWrite ? BPMask_DataWrite : 0;
-
-    const FAddressRef addrRef = pCodeAnalysis->AddressRefFromPhysicalAddress(addr);
+	const uint64_t pins = tick.Pins;
+	const uint16_t addr = tick.Addr;
+	int trapId = kTrapId_None;
 
-    if (bNewOp)
+    if (tick.bNewOp)
     {
         PC = pCodeAnalysis->AddressRefFromPhysicalAddress(pins & 0xffff);
+		const bool bReplayTarget = ReverseExecution.OnInstructionBoundary(pins, PC.Address, GetStackPointer());
 		trapId = OnInstructionExecuted(pins);
+		if (bReplayTarget)
+			trapId = kTrapId_Step;
 	}
 
-    // tick based stepping
-    switch (StepMode)
-    {
-        // This is ZX Spectrum specific - need to think of a generic way of doing it - large memory breakpoint?
-        case EDebugStepMode::ScreenWrite:
-        {
-            // break on screen memory write
-            if (bWrite && pCodeAnalysis->MemoryAnalyser.IsAddressInScreenMemory(addr))
-                trapId = kTrapId_Step;            
-        }
-        break;
-
-		case EDebugStepMode::IORead:
-		{
-			if (bIORead)
-				trapId = kTrapId_Step;
-		}
-		break;
+	// log IO reads so reverse execution can replay them
+	if (tick.bIORead)
+		ReverseExecution.OnIORead(addr, tick.Data);
 
-		case EDebugStepMode::IOWrite:
-		{
-			if (bIOWrite)
-				trapId = kTrapId_Step;
-		}
-		break;
+	if constexpr (bTickChecks)
+	{
+		// setup breakpoint mask to check
+		const uint32_t BPMaskCheck = tick.bMemWrite ? BPMask_DataWrite : 0;
 
-		case EDebugStepMode::Interrupt:
+		// tick based stepping
+		switch (StepMode)
 		{
-			if (bIrq)
-				trapId = kTrapId_Step;
-		}
-		break;
+			// This is ZX Spectrum specific - need to think of a generic way of doing it - large memory breakpoint?
+			case EDebugStepMode::ScreenWrite:
+			{
+				// break on screen memory write
+				if (tick.bMemWrite && pCodeAnalysis->MemoryAnalyser.IsAddressInScreenMemory(addr))
+					trapId = kTrapId_Step;            
+			}
+			break;
 
-		case EDebugStepMode::NMI:
-		{
-		}
-		break;
-        
-        default:
-            break;
-    }
+			case EDebugStepMode::IORead:
+			{
+				if (tick.bIORead)
+					trapId = kTrapId_Step;
+			}
+			break;
 
-    // iterate through data breakpoints
-	// this can slow down if there are a lot of BPs
-	// Do a mask check
-	if (BPMaskCheck & BreakpointMask)
-	{
-		for (int i = 0; i < Breakpoints.size(); i++)
-		{
-			const FBreakpoint& bp = Breakpoints[i];
+			case EDebugStepMode::IOWrite:
+			{
+				if (tick.bIOWrite)
+					trapId = kTrapId_Step;
+			}
+			break;
 
-			if (bp.bEnabled)
+			case EDebugStepMode::Interrupt:
 			{
-				switch (bp.Type)
-				{
-				case EBreakpointType::Data:
-					if (bWrite &&
-						addrRef.BankId == bp.Address.BankId &&
-						addrRef.Address >= bp.Address.Address &&
-						addrRef.Address < bp.Address.Address + bp.Size)
-					{
-						trapId = kTrapId_BpBase + i;
-					}
-					break;
+				if (tick.bIrq)
+					trapId = kTrapId_Step;
+			}
+			break;
 
-				case EBreakpointType::Irq:
-					if (bIrq)
-						trapId = kTrapId_BpBase + i;
-					break;
+			case EDebugStepMode::NMI:
+			{
+			}
+			break;
+        
+			default:
+				break;
+		}
 
-				case EBreakpointType::NMI:
-					if (bNMI)
-						trapId = kTrapId_BpBase + i;
-					break;
+		// iterate through data breakpoints
+		// Do a mask check, then only search the list if the address map says this address has a breakpoint
+		const FAddressRef addrRef = pCodeAnalysis->AddressRefFromPhysicalAddress(addr);
+		const bool bDataBPAddress = tick.bMemWrite && (BPMaskCheck & BreakpointMask) && DataBreakpointMap.IsSet(addrRef);
+		if (bDataBPAddress || ((BPMaskCheck & BreakpointMask) && (BreakpointMask & BPMask_NonAddress)))
+		{
+			for (int i = 0; i < Breakpoints.size(); i++)
+			{
+				const FBreakpoint& bp = Breakpoints[i];
 
-					// In/Out - only for Z80
-				case EBreakpointType::In:
-					if (bIORead)
+				if (bp.bEnabled)
+				{
+					switch (bp.Type)
 					{
-						const uint16_t mask = bp.Val;
-						if ((Z80_GET_ADDR(pins) & mask) == (bp.Address.Address & mask))
+					case EBreakpointType::Data:
+						if (bDataBPAddress &&
+							addrRef.BankId == bp.Address.BankId &&
+							addrRef.Address >= bp.Address.Address &&
+							addrRef.Address < bp.Address.Address + bp.Size)
+						{
+							if (OnBreakpointHit(i))
+								trapId = kTrapId_BpBase + i;
+						}
+						break;
+
+					case EBreakpointType::Irq:
+						if (tick.bIrq && OnBreakpointHit(i))
 							trapId = kTrapId_BpBase + i;
-					}
-					break;
+						break;
 
-				case EBreakpointType::Out:
-					if (bIOWrite)
-					{
-						const uint16_t mask = bp.Val;
-						if ((Z80_GET_ADDR(pins) & mask) == (bp.Address.Address & mask))
+					case EBreakpointType::NMI:
+						if (tick.bNMI && OnBreakpointHit(i))
 							trapId = kTrapId_BpBase + i;
+						break;
+
+						// In/Out - only for Z80
+					case EBreakpointType::In:
+						if (tick.bIORead)
+						{
+							const uint16_t mask = bp.Val;
+							if ((addr & mask) == (bp.Address.Address & mask) && OnBreakpointHit(i))
+								trapId = kTrapId_BpBase + i;
+						}
+						break;
+
+					case EBreakpointType::Out:
+						if (tick.bIOWrite)
+						{
+							const uint16_t mask = bp.Val;
+							if ((addr & mask) == (bp.Address.Address & mask) && OnBreakpointHit(i))
+								trapId = kTrapId_BpBase + i;
+						}
+						break;
+					default:
+						break;
 					}
-					break;
-                default:
-                    break;
 				}
 			}
 		}
@@ -198,9 +181,31 @@ void FDebugger::CPUTick(uint64_t pins)
         Break();
     }
 
+	bAtInstructionBoundary = tick.bNewOp;
     LastTickPins = pins;
 }
 
+template void FDebugger::CPUTick<false>(const FCPUTickPins& tick);
+template void FDebugger::CPUTick<true>(const FCPUTickPins& tick);
+
+// true if there are breakpoints or a step mode that need checking on every tick
+bool FDebugger::NeedsTickChecks() const
+{
+	switch (StepMode)
+	{
+	case EDebugStepMode::ScreenWrite:
+	case EDebugStepMode::IORead:
+	case EDebugStepMode::IOWrite:
+	case EDebugStepMode::Interrupt:
+	case EDebugStepMode::NMI:
+		return true;
+	default:
+		break;
+	}
+
+	return (BreakpointMask & ~BPMask_Exec) != 0;
+}
+
 int FDebugger::OnInstructionExecuted(uint64_t pins)
 {
 	int trapId = kTrapId_None;
@@ -221,26 +226,14 @@ int FDebugger::OnInstructionExecuted(uint64_t pins)
             break;
 		}
 	}
-	else if(BreakpointMask & BPMask_Exec)
+	else if((BreakpointMask & BPMask_Exec) && ExecBreakpointMap.IsSet(PC))
 	{
-		for (int i = 0; i < Breakpoints.size(); i++)
+		const auto bpIt = BreakpointIndex.find(PC.Val);
+		if (bpIt != BreakpointIndex.end())
 		{
-			const FBreakpoint& bp = Breakpoints[i];
-
-			if (bp.bEnabled)
-			{
-				switch (bp.Type)
-				{
-				case EBreakpointType::Exec:
-					if (PC == bp.Address)
-					{
-						trapId = kTrapId_BpBase + i;
-					}
-					break;
-                default:
-                    break;
-                }
-			}
+			const FBreakpoint& bp = Breakpoints[bpIt->second];
+			if (bp.bEnabled && bp.Type == EBreakpointType::Exec && OnBreakpointHit(bpIt->second))
+				trapId = kTrapId_BpBase + bpIt->second;
 		}
 	}
 
@@ -254,7 +247,7 @@ int FDebugger::OnInstructionExecuted(uint64_t pins)
 	else if(CPUType == ECPUType::M6502)
 		bIRQ = pM6502->brk_flags & M6502_BRK_IRQ;
 
-	if (bIRQ)
+	if (bIRQ && ReverseExecution.IsReplaying() == false)
 	{
 		FCPUFunctionCall callInfo;
 		callInfo.CallAddr = PC;
@@ -268,7 +261,8 @@ int FDebugger::OnInstructionExecuted(uint64_t pins)
 		//return UI_DBG_BP_BASE_TRAPID + 255;	//hack
 	}
 
-	FrameTrace.push_back(PC);
+	if (ReverseExecution.IsReplaying() == false)
+		FrameTrace.push_back(PC);
 
 	// update stack size
 	if (CPUType == ECPUType::Z80)
@@ -288,6 +282,81 @@ int FDebugger::OnInstructionExecuted(uint64_t pins)
 	return trapId;
 }
 
+// Called when an enabled breakpoint matches
+// Counts the hit then checks the hit count and condition, returns true if the machine should stop
+bool FDebugger::OnBreakpointHit(int bpIndex)
+{
+	FBreakpoint& bp = Breakpoints[bpIndex];
+
+	// reverse execution is re-running code that has already been counted
+	const bool bReplaying = ReverseExecution.IsReplaying();
+	if (bReplaying == false)
+	{
+		bp.HitCount++;
+		if (bp.HitCount < bp.BreakOnHit)
+			return false;
+	}
+
+	if (bp.Condition.IsEmpty() == false)
+	{
+		FConditionContext context;
+		context.CPUType = CPUType;
+		context.pZ80 = pZ80;
+		context.pM6502 = pM6502;
+		context.pCodeAnalysis = pCodeAnalysis;
+		context.PC = PC.Address;
+
+		if (bp.Condition.Evaluate(context) == 0)
+			return false;
+	}
+
+	// reverse execution is re-running code to find hits so just record it
+	if (bReplaying)
+	{
+		ReverseExecution.OnReplayBreakpointHit(bp.Type == EBreakpointType::Exec);
+		return false;
+	}
+
+	if (bp.bLogOnly)
+	{
+		WriteLogEntry(bp);
+		return false;
+	}
+
+	return true;
+}
+
+void FDebugger::WriteLogEntry(const FBreakpoint& bp)
+{
+	FLogpointEntry& entry = LogBuffer[LogBufferIndex];
+	entry.BreakpointAddress = bp.Address;
+	entry.PC = PC;
+	entry.FrameNo = pCodeAnalysis->CurrentFrameNo;
+	entry.HitCount = bp.HitCount;
+
+	if (CPUType == ECPUType::Z80)
+	{
+		entry.Registers[0] = pZ80->af;
+		entry.Registers[1] = pZ80->bc;
+		entry.Registers[2] = pZ80->de;
+		entry.Registers[3] = pZ80->hl;
+		entry.Registers[4] = pZ80->ix;
+		entry.Registers[5] = pZ80->iy;
+		entry.Registers[6] = pZ80->sp;
+	}
+	else if (CPUType == ECPUType::M6502)
+	{
+		entry.Registers[0] = pM6502->A;
+		entry.Registers[1] = pM6502->X;
+		entry.Registers[2] = pM6502->Y;
+		entry.Registers[3] = pM6502->S;
+		entry.Registers[4] = pM6502->P;
+	}
+
+	LogBufferIndex = (LogBufferIndex + 1) % kLogBufferSize;
+	NoLogEntries = std::min(NoLogEntries + 1, kLogBufferSize);
+}
+
 // called every machine frame
 // will get called in the middle of emulation
 void FDebugger::OnMachineFrameStart()
@@ -355,7 +424,7 @@ bool FDebugger::FrameTick(void)
 	return bDebuggerStopped;
 }
 
-static const uint32_t kVersionNo = 3;
+static const uint32_t kVersionNo = 4;
 
 // Load state - breakpoints, watches etc.
 void	FDebugger::LoadFromFile(FILE* fp)
@@ -385,7 +454,15 @@ void	FDebugger::LoadFromFile(FILE* fp)
 		fread(&bp.Type, sizeof(bp.Type), 1, fp);	// Type
 		fread(&bp.Size, sizeof(bp.Size), 1, fp);	// Size
 		fread(&bp.Val, sizeof(bp.Val), 1, fp);		// Val
+		if (versionNo > 3)
+		{
+			ReadStringFromFile(bp.ConditionText, fp);
+			fread(&bp.BreakOnHit, sizeof(bp.BreakOnHit), 1, fp);
+			fread(&bp.bLogOnly, sizeof(bp.bLogOnly), 1, fp);
+			bp.Condition.Compile(bp.ConditionText.c_str(), CPUType);
+		}
 	}
+	RebuildBreakpointTables();
 
 	// frame trace
 	if (versionNo > 1)
@@ -430,6 +507,9 @@ void	FDebugger::SaveToFile(FILE* fp)
 		fwrite(&bp.Type, sizeof(bp.Type), 1, fp);	// Type
 		fwrite(&bp.Size, sizeof(bp.Size), 1, fp);	// Size
 		fwrite(&bp.Val, sizeof(bp.Val), 1, fp);		// Val
+		WriteStringToFile(bp.ConditionText, fp);
+		fwrite(&bp.BreakOnHit, sizeof(bp.BreakOnHit), 1, fp);
+		fwrite(&bp.bLogOnly, sizeof(bp.bLogOnly), 1, fp);
 	}
 
 	// frame trace
@@ -464,55 +544,41 @@ void FDebugger::StepInto()
     bDebuggerStopped = false;
 }
 
-// check if the an instruction is a 'step over' op 
-static bool IsStepOverOpcode(ECPUType cpuType, uint8_t opcode)
+bool FDebugger::StepBack()
 {
-    if (cpuType == ECPUType::Z80)
-    {
-        switch (opcode)
-        {
-            // CALL nnnn 
-        case 0xCD:
-            // CALL cc,nnnn 
-        case 0xDC: case 0xFC: case 0xD4: case 0xC4:
-        case 0xF4: case 0xEC: case 0xE4: case 0xCC:
-            // DJNZ d 
-        case 0x10:
-			// TODO: LDIR & others
-            return true;
-        default:
-            return false;
-        }
-    }
-    else if (cpuType == ECPUType::M6502)
-    {
-        // on 6502, only JSR qualifies 
-        return opcode == 0x20;
-    }
-    else
-    {
-        return false;
-    }
+	return CanReverseStep() && ReverseExecution.StepBack(bAtInstructionBoundary);
 }
 
-void	FDebugger::StepOver()
+bool FDebugger::StepOverBack()
 {
-	//const ECPUType cpuType = pEmulator->CPUType;
+	return CanReverseStep() && ReverseExecution.StepOverBack(bAtInstructionBoundary, PC.Address, GetStackPointer());
+}
+
+bool FDebugger::ContinueBack()
+{
+	return CanReverseStep() && ReverseExecution.ContinueBack(bAtInstructionBoundary);
+}
+
+uint16_t FDebugger::GetStackPointer() const
+{
+	if (CPUType == ECPUType::Z80)
+		return pZ80->sp;
+	else if (CPUType == ECPUType::M6502)
+		return pM6502->S + 0x100;
+	return 0;
+}
 
-	uint8_t stepOpcode = 0;
+void	FDebugger::StepOver()
+{
 	// TODO: this one's a bit more tricky!
    
     bDebuggerStopped = false;
-    uint16_t nextPC = 0;
-	if (CPUType == ECPUType::Z80)
-		nextPC = Z80DisassembleGetNextPC(PC.Address, *pCodeAnalysis, stepOpcode);
-    else if (CPUType == ECPUType::M6502)
-		nextPC = M6502DisassembleGetNextPC(PC.Address, *pCodeAnalysis, stepOpcode);
+	const FDecodedInstruction decoded = GetDecodedInstruction(*pCodeAnalysis, PC.Address);
 
-    if (IsStepOverOpcode(CPUType, stepOpcode))
+    if (decoded.bStepOver)	// TODO: LDIR & others
     {
         StepMode = EDebugStepMode::StepOver;
-        StepOverPC = pCodeAnalysis->AddressRefFromPhysicalAddress(nextPC);
+        StepOverPC = pCodeAnalysis->AddressRefFromPhysicalAddress(PC.Address + decoded.Length);
     }
     else 
     {
@@ -552,6 +618,7 @@ bool FDebugger::AddExecBreakpoint(FAddressRef addr)
 		return false;
 
 	Breakpoints.emplace_back(addr, EBreakpointType::Exec);
+	RebuildBreakpointTables();
 	return true;
 }
 
@@ -561,21 +628,20 @@ bool FDebugger::AddDataBreakpoint(FAddressRef addr, uint16_t size)
 		return false;
 
 	Breakpoints.emplace_back(addr, EBreakpointType::Data,size);
+	RebuildBreakpointTables();
 	return true;
 }
 
 bool FDebugger::RemoveBreakpoint(FAddressRef addr)
 {
-	for (int i = 0; i < Breakpoints.size(); i++)
-	{
-		if (Breakpoints[i].Address == addr)
-		{
-			Breakpoints[i] = Breakpoints.back();
-			Breakpoints.pop_back();
-			return true;
-		}
-	}
-	return false;
+	const auto bpIt = BreakpointIndex.find(addr.Val);
+	if (bpIt == BreakpointIndex.end())
+		return false;
+
+	Breakpoints[bpIt->second] = Breakpoints.back();
+	Breakpoints.pop_back();
+	RebuildBreakpointTables();
+	return true;
 }
 
 bool FDebugger::ChangeBreakpointAddress(FAddressRef oldAddress, FAddressRef newAddress)
@@ -584,19 +650,49 @@ bool FDebugger::ChangeBreakpointAddress(FAddressRef oldAddress, FAddressRef newA
 	if(pBP == nullptr || IsAddressBreakpointed(newAddress))	// return false if either address is invalid
 		return false;
 	pBP->Address = newAddress;
+	RebuildBreakpointTables();
 	return true;
 }
 
 
+bool FDebugger::SetBreakpointCondition(FAddressRef addr, const char* pCondition)
+{
+	FBreakpoint* pBP = GetBreakpointForAddress(addr);
+	if (pBP == nullptr)
+		return false;
+	pBP->ConditionText = pCondition;
+	return pBP->Condition.Compile(pCondition, CPUType);
+}
+
 const FBreakpoint* FDebugger::GetBreakpointForAddress(FAddressRef addr) const
 {
+	const auto bpIt = BreakpointIndex.find(addr.Val);
+	return bpIt != BreakpointIndex.end() ? &Breakpoints[bpIt->second] : nullptr;
+}
+
+// Rebuild the address lookups - needs calling whenever a breakpoint is added, removed or moved
+// Enabled state is checked when the breakpoint is hit so that doesn't need a rebuild
+void FDebugger::RebuildBreakpointTables()
+{
+	ExecBreakpointMap.Clear();
+	DataBreakpointMap.Clear();
+	BreakpointIndex.clear();
+
 	for (int i = 0; i < Breakpoints.size(); i++)
 	{
-		if (Breakpoints[i].Address == addr)
-			return &Breakpoints[i];
-	}
+		const FBreakpoint& bp = Breakpoints[i];
+		BreakpointIndex[bp.Address.Val] = i;
 
-	return nullptr;
+		if (bp.Type == EBreakpointType::Exec)
+		{
+			ExecBreakpointMap.Set(bp.Address);
+		}
+		else if (bp.Type == EBreakpointType::Data)
+		{
+			for (int byteNo = 0; byteNo < bp.Size; byteNo++)
+				DataBreakpointMap.Set(FAddressRef(bp.Address.BankId, (uint16_t)(bp.Address.Address + byteNo)));
+		}
+	}
 }
 
 
@@ -721,7 +817,7 @@ void FDebugger::RegisterEvent(uint8_t type, FAddressRef pc, uint16_t address, ui
 {
 	std::vector<FEventTypeInfo>& eventTypeInfo = g_EventTypeInfo;
 
-	if (!eventTypeInfo[type].bEnabled)
+	if (!pCodeAnalysis->bRecordEvents || !eventTypeInfo[type].bEnabled)
 		return;
 
 	ScanlineEvents[scanlinePos] = type;
@@ -733,7 +829,10 @@ void FDebugger::RegisterEvent(uint8_t type, FAddressRef pc, uint16_t address, ui
 		FCodeInfo* pCodeInfo = state.GetCodeInfoForAddress(pc);
 
 		if (pCodeInfo != nullptr && pCodeInfo->Comment.empty())
+		{
 			pCodeInfo->Comment = GetEventName(type);
+			state.MarkPageChanged(pc);
+		}
 	}
 }
 
@@ -742,6 +841,11 @@ uint32_t FDebugger::GetEventColour(uint8_t type)
 	return g_EventTypeInfo[type].EventColour;
 }
 
+bool FDebugger::IsEventTypeEnabled(uint8_t type) const
+{
+	return type < g_EventTypeInfo.size() && g_EventTypeInfo[type].bEnabled;
+}
+
 const char* FDebugger::GetEventName(uint8_t type)
 {
 	return g_EventTypeInfo[type].EventName;
@@ -1099,12 +1203,16 @@ void FDebugger::DrawBreakpoints(void)
 	FCodeAnalysisViewState& viewState = state.GetFocussedViewState();
 
 	static ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit;
-	if (ImGui::BeginTable("Breakpoints", 4, flags))
+	if (ImGui::BeginTable("Breakpoints", 8, flags))
 	{
 		ImGui::TableSetupColumn("Enabled", ImGuiTableColumnFlags_WidthFixed, 60);
 		ImGui::TableSetupColumn("Address", ImGuiTableColumnFlags_WidthStretch);
 		ImGui::TableSetupColumn("Type", ImGuiTableColumnFlags_WidthFixed,50);
 		ImGui::TableSetupColumn("Size", ImGuiTableColumnFlags_WidthFixed,40);
+		ImGui::TableSetupColumn("Condition", ImGuiTableColumnFlags_WidthFixed, 160);
+		ImGui::TableSetupColumn("Hits", ImGuiTableColumnFlags_WidthFixed, 50);
+		ImGui::TableSetupColumn("Break On", ImGuiTableColumnFlags_WidthFixed, 80);
+		ImGui::TableSetupColumn("Log", ImGuiTableColumnFlags_WidthFixed, 30);
 		ImGui::TableHeadersRow();
 
 		for (auto& bp : Breakpoints)
@@ -1120,12 +1228,88 @@ void FDebugger::DrawBreakpoints(void)
 			ImGui::Text("%s", GetBreakpointTypeText(bp.Type));
 			ImGui::TableSetColumnIndex(3);
 			ImGui::Text("%d", bp.Size);
+			ImGui::TableSetColumnIndex(4);
+			ImGui::SetNextItemWidth(-1);
+			if (bp.Condition.HasError())
+				ImGui::PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.4f, 0.4f, 1.0f));
+			if (ImGui::InputText("##Condition", &bp.ConditionText))
+				bp.Condition.Compile(bp.ConditionText.c_str(), CPUType);
+			if (bp.Condition.HasError())
+			{
+				ImGui::PopStyleColor();
+				if (ImGui::IsItemHovered())
+					ImGui::SetTooltip("%s", bp.Condition.GetErrorText().c_str());
+			}
+			ImGui::TableSetColumnIndex(5);
+			ImGui::Text("%d", bp.HitCount);
+			if (ImGui::IsItemClicked())
+				bp.HitCount = 0;
+			ImGui::TableSetColumnIndex(6);
+			ImGui::SetNextItemWidth(-1);
+			ImGui::InputInt("##BreakOnHit", &bp.BreakOnHit, 0);
+			ImGui::TableSetColumnIndex(7);
+			ImGui::Checkbox("##Log", &bp.bLogOnly);
 			ImGui::PopID();
 		}
 		ImGui::EndTable();
 	}
 }
 
+void FDebugger::DrawLog(void)
+{
+	FCodeAnalysisState& state = *pCodeAnalysis;
+	FCodeAnalysisViewState& viewState = state.GetFocussedViewState();
+
+	if (ImGui::Button("Clear"))
+		ClearLog();
+	ImGui::SameLine();
+	ImGui::Text("%d entries", NoLogEntries);
+
+	static ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_ScrollY;
+	if (ImGui::BeginTable("Log", 4, flags))
+	{
+		ImGui::TableSetupScrollFreeze(0, 1);
+		ImGui::TableSetupColumn("Frame", ImGuiTableColumnFlags_WidthFixed, 50);
+		ImGui::TableSetupColumn("Hit", ImGuiTableColumnFlags_WidthFixed, 50);
+		ImGui::TableSetupColumn("PC", ImGuiTableColumnFlags_WidthFixed, 120);
+		ImGui::TableSetupColumn("Registers", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableHeadersRow();
+
+		ImGuiListClipper clipper;
+		clipper.Begin(NoLogEntries);
+		while (clipper.Step())
+		{
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+			{
+				const FLogpointEntry& entry = GetLogEntry(i);
+				ImGui::PushID(i);
+				ImGui::TableNextRow();
+				ImGui::TableSetColumnIndex(0);
+				ImGui::Text("%d", entry.FrameNo);
+				ImGui::TableSetColumnIndex(1);
+				ImGui::Text("%d", entry.HitCount);
+				ImGui::TableSetColumnIndex(2);
+				ImGui::Text("%s", NumStr(entry.PC.Address));
+				DrawAddressLabel(state, viewState, entry.PC);
+				ImGui::TableSetColumnIndex(3);
+				if (CPUType == ECPUType::Z80)
+				{
+					ImGui::Text("AF:%04X BC:%04X DE:%04X HL:%04X IX:%04X IY:%04X SP:%04X",
+						entry.Registers[0], entry.Registers[1], entry.Registers[2], entry.Registers[3],
+						entry.Registers[4], entry.Registers[5], entry.Registers[6]);
+				}
+				else if (CPUType == ECPUType::M6502)
+				{
+					ImGui::Text("A:%02X X:%02X Y:%02X S:%02X P:%02X",
+						entry.Registers[0], entry.Registers[1], entry.Registers[2], entry.Registers[3], entry.Registers[4]);
+				}
+				ImGui::PopID();
+			}
+		}
+		ImGui::EndTable();
+	}
+}
+
 // Generic Event render functions
 void EventShowPixValue(FCodeAnalysisState& state, const FEvent& event)
 {
@@ -1187,6 +1371,8 @@ void FDebugger::DrawEvents(void)
 	std::vector<FEventTypeInfo>& eventTypeInfo = g_EventTypeInfo;
 	FCodeAnalysisState& state = *pCodeAnalysis;
 
+	ImGui::Checkbox("Record", &state.bRecordEvents);
+	ImGui::SameLine();
 	if (ImGui::Button("Clear"))
 		ClearEvents();
 	ImGui::SameLine();
@@ -1198,7 +1384,10 @@ void FDebugger::DrawEvents(void)
 		{
 			FCodeInfo* pCodeInfo = state.GetCodeInfoForAddress(event.PC);
 			if(pCodeInfo != nullptr && pCodeInfo->Comment.empty())
+			{
 				pCodeInfo->Comment = GetEventName(event.Type);
+				state.MarkPageChanged(event.PC);
+			}
 		}
 	}
 	//disabled for now as it's a bit dangerous
@@ -1334,6 +1523,12 @@ void FDebugger::DrawUI(void)
 			ImGui::EndTabItem();
 		}
 		
+        if (ImGui::BeginTabItem("Log"))
+		{
+			DrawLog();
+			ImGui::EndTabItem();
+		}
+
         if (ImGui::BeginTabItem("Watches"))
 		{
 			DrawWatches();
@@ -1370,6 +1565,12 @@ void FDebugger::DrawUI(void)
 			ImGui::EndTabItem();
 		}
 
+		if (ImGui::BeginTabItem("Reverse"))
+		{
+			ReverseExecution.DrawUI();
+			ImGui::EndTabItem();
+		}
+
 		ImGui::EndTabBar();
 	}
 }
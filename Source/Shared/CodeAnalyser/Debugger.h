@@ -1,10 +1,13 @@
 #pragma once
 
 #include <CodeAnalyser/CodeAnalyserTypes.h>
+#include <CodeAnalyser/BreakpointCondition.h>
+#include <CodeAnalyser/ReverseExecution.h>
 
 #include <chips/z80.h>
 #include <chips/m6502.h>
 #include <vector>
+#include <unordered_map>
 
 #include <stdio.h>
 
@@ -57,6 +60,54 @@ struct FBreakpoint
 	EBreakpointType	Type = EBreakpointType::None;
 	bool			bEnabled = true;
 	uint16_t		Size = 1;
+
+	// Optional condition, hit count & logging
+	std::string				ConditionText;
+	FBreakpointCondition	Condition;		// compiled from ConditionText
+	int						HitCount = 0;	// number of times hit, whether or not the condition was true
+	int						BreakOnHit = 0;	// don't break until the hit count reaches this
+	bool					bLogOnly = false;	// logpoint - record an entry in the log instead of breaking
+};
+
+// Entry in the logpoint ring buffer - raw values are stored and only formatted for display
+struct FLogpointEntry
+{
+	FAddressRef		BreakpointAddress;
+	FAddressRef		PC;
+	int				FrameNo = 0;
+	int				HitCount = 0;
+	uint16_t		Registers[7] = { 0 };	// Z80: AF BC DE HL IX IY SP, 6502: A X Y S P
+};
+
+// Per bank bitmap of addresses that have a breakpoint on them
+// lets the per tick checks be a lookup rather than a search of all the breakpoints
+class FBreakpointAddressMap
+{
+public:
+	void	Clear() { BankBits.clear(); }
+	void	Set(FAddressRef addr)
+	{
+		if (addr.BankId < 0)
+			return;
+		if (addr.BankId >= (int)BankBits.size())
+			BankBits.resize(addr.BankId + 1);
+		std::vector<uint64_t>& bits = BankBits[addr.BankId];
+		if (bits.empty())
+			bits.resize(kAddressSpaceSize / 64, 0);
+		bits[addr.Address >> 6] |= 1ull << (addr.Address & 63);
+	}
+
+	bool	IsSet(FAddressRef addr) const
+	{
+		if (addr.BankId < 0 || addr.BankId >= (int)BankBits.size())
+			return false;
+		const std::vector<uint64_t>& bits = BankBits[addr.BankId];
+		return bits.empty() == false && (bits[addr.Address >> 6] & (1ull << (addr.Address & 63))) != 0;
+	}
+
+private:
+	static const int kAddressSpaceSize = 1 << 16;
+	std::vector<std::vector<uint64_t>>	BankBits;	// only allocated for banks that have breakpoints
 };
 
 struct FWatch : public FAddressRef
@@ -99,12 +150,44 @@ struct FEvent
 
 typedef void (*ShowEventInfoCB)(FCodeAnalysisState& state, const FEvent& event);
 
+// Analysis features that run on every CPU tick
+// Machine tick functions are specialised on these so the ones that are switched off cost nothing
+enum ETickFeature : uint32_t
+{
+	TickFeature_DataAccesses		= 1 << 0,	// register memory reads & writes with the analyser
+	TickFeature_Events				= 1 << 1,	// record debugger events
+	TickFeature_Breakpoints			= 1 << 2,	// data/IO/interrupt breakpoints & tick based step modes
+	TickFeature_IOAnalysis			= 1 << 3,	// IO analyser & machine IO devices
+	TickFeature_ScreenWriteEvents	= 1 << 4,	// screen memory write events
+
+	TickFeature_All					= (1 << 5) - 1,
+	TickFeature_NoCombinations		= TickFeature_All + 1
+};
+
+// CPU pins decoded once per tick and shared by the machine, the analyser & the debugger
+struct FCPUTickPins
+{
+	uint64_t	Pins = 0;
+	uint64_t	RisingPins = 0;	// pins that have gone high this tick
+	uint16_t	Addr = 0;
+	uint8_t		Data = 0;
+	bool		bMemWrite = false;	// start of a memory write
+	bool		bIORead = false;
+	bool		bIOWrite = false;
+	bool		bNewOp = false;
+	bool		bIrq = false;
+	bool		bNMI = false;
+};
+
 
 class FDebugger
 {
 public:
 	void	Init(FCodeAnalysisState* pCodeAnalysis);
-	void	CPUTick(uint64_t pins);
+	FCPUTickPins	DecodeTickPins(uint64_t pins) const { return DecodeTickPins(pins, LastTickPins); }
+	FCPUTickPins	DecodeTickPins(uint64_t pins, uint64_t lastPins) const;
+	template <bool bTickChecks> void CPUTick(const FCPUTickPins& tick);
+	bool	NeedsTickChecks() const;
 	int		OnInstructionExecuted(uint64_t pins);
 	void	OnMachineFrameStart();
 	void	OnMachineFrameEnd();
@@ -125,13 +208,27 @@ public:
 	void	StepIOWrite();
 	void	SetPC(FAddressRef newPC) { PC = newPC; }
 
+	// Reverse execution
+	bool	CanReverseStep() const { return bDebuggerStopped && ReverseExecution.IsAvailable() && ReverseExecution.HasHistory(); }
+	bool	StepBack();
+	bool	StepOverBack();
+	bool	ContinueBack();
+	bool	IsReplaying() const { return ReverseExecution.IsReplaying(); }
+	FReverseExecution& GetReverseExecution() { return ReverseExecution; }
+
 	// Breakpoints
 	bool	AddExecBreakpoint(FAddressRef addr);
 	bool	AddDataBreakpoint(FAddressRef addr, uint16_t size);
 	bool	RemoveBreakpoint(FAddressRef addr);
 	bool	ChangeBreakpointAddress(FAddressRef oldAddress,FAddressRef newAddress);
+	bool	SetBreakpointCondition(FAddressRef addr, const char* pCondition);
 	const FBreakpoint* GetBreakpointForAddress(FAddressRef addr) const;
 	FBreakpoint* GetBreakpointForAddress(FAddressRef addr) { return const_cast<FBreakpoint*>(const_cast<const FDebugger*>(this)->GetBreakpointForAddress(addr)); }
+	// Logpoints
+	int		GetNoLogEntries() const { return NoLogEntries; }
+	const FLogpointEntry& GetLogEntry(int index) const { return LogBuffer[(LogBufferIndex - NoLogEntries + index + kLogBufferSize) % kLogBufferSize]; }	// 0 is the oldest
+	void	ClearLog() { NoLogEntries = 0; LogBufferIndex = 0; }
+
 	// Watches
 	void	AddWatch(FWatch watch);
 	bool	RemoveWatch(FWatch watch);
@@ -146,6 +243,7 @@ public:
 	const uint8_t* GetScanlineEvents() const { return ScanlineEvents; }
 	uint32_t GetEventColour(uint8_t type);
 	const char* GetEventName(uint8_t type);
+	bool IsEventTypeEnabled(uint8_t type) const;
 	void ClearEvents();
 
 	// Frame Trace
@@ -177,9 +275,14 @@ public:
 	void	DrawWatches(void);
 	void	DrawBreakpoints(void);
 	void	DrawEvents(void);
+	void	DrawLog(void);
 	void	DrawUI(void);
 private:
 	int		GetFrameTraceItemIndex(FAddressRef address);
+	uint16_t	GetStackPointer() const;
+	void	RebuildBreakpointTables();
+	bool	OnBreakpointHit(int bpIndex);
+	void	WriteLogEntry(const FBreakpoint& bp);
 
 private:
 	FCodeAnalysisState*	pCodeAnalysis = nullptr;
@@ -190,13 +293,23 @@ private:
 	uint64_t		LastTickPins = 0;
 	FAddressRef		PC;
 	bool			bDebuggerStopped = false;
+	bool			bAtInstructionBoundary = true;	// false if we stopped part way through an instruction
 	EDebugStepMode	StepMode = EDebugStepMode::None;
 	FAddressRef		StepOverPC;
 
 	std::vector<FBreakpoint>	Breakpoints;
 	uint32_t					BreakpointMask = 0;
+	FBreakpointAddressMap		ExecBreakpointMap;
+	FBreakpointAddressMap		DataBreakpointMap;
+	std::unordered_map<uint32_t, int>	BreakpointIndex;	// address ref value to index in Breakpoints
+
+	static const int			kLogBufferSize = 1024;
+	FLogpointEntry				LogBuffer[kLogBufferSize];
+	int							LogBufferIndex = 0;	// next entry to write
+	int							NoLogEntries = 0;
 	std::vector<FWatch>			Watches;
 	FWatch						SelectedWatch;
+	FReverseExecution			ReverseExecution;
 	std::vector<FAddressRef>	FrameTrace;
 	std::vector<FEvent>			EventTrace;
 	uint8_t						ScanlineEvents[320] = {0};
@@ -216,5 +329,36 @@ private:
 	uint16_t				StackMax = 0;
 };
 
+// lastPins is the previous tick, for machines that don't call per tick
+inline FCPUTickPins FDebugger::DecodeTickPins(uint64_t pins, uint64_t lastPins) const
+{
+	FCPUTickPins tick;
+	tick.Pins = pins;
+	tick.RisingPins = pins & (pins ^ lastPins);
+
+	if (CPUType == ECPUType::Z80)
+	{
+		tick.Addr = Z80_GET_ADDR(pins);
+		tick.Data = Z80_GET_DATA(pins);
+		tick.bMemWrite = (tick.RisingPins & Z80_CTRL_PIN_MASK) == (Z80_MREQ | Z80_WR);
+		tick.bIORead = (pins & Z80_CTRL_PIN_MASK) == (Z80_IORQ | Z80_RD);
+		tick.bIOWrite = (pins & Z80_CTRL_PIN_MASK) == (Z80_IORQ | Z80_WR);
+		tick.bNewOp = z80_opdone(pZ80);
+		tick.bIrq = (pins & Z80_INT) && pZ80->iff1;
+		tick.bNMI = tick.RisingPins & Z80_NMI;
+	}
+	else if (CPUType == ECPUType::M6502)
+	{
+		tick.Addr = M6502_GET_ADDR(pins);
+		tick.Data = M6502_GET_DATA(pins);
+		tick.bMemWrite = (pins & M6502_RW) == 0;
+		tick.bNewOp = pins & M6502_SYNC;
+		tick.bIrq = tick.RisingPins & M6502_IRQ;
+		tick.bNMI = tick.RisingPins & M6502_NMI;
+	}
+
+	return tick;
+}
+
 void EventShowPixValue(FCodeAnalysisState& state, const FEvent& event);
 void EventShowAttrValue(FCodeAnalysisState& state, const FEvent& event);
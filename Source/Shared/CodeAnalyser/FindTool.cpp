@@ -2,6 +2,7 @@
 
 #include "CodeAnalyser.h"
 #include <imgui.h>
+#include <algorithm>
 #include <misc/cpp/imgui_stdlib.h>
 
 #include "UI/CodeAnalyserUI.h"
@@ -20,6 +21,15 @@ static void HelpMarker(const char* desc)
 	}
 }
 
+// hex digits & '?' for wildcard bytes
+static int HexWildcardCharFilter(ImGuiInputTextCallbackData* pData)
+{
+	const ImWchar c = pData->EventChar;
+	if ((c >= '0' && c <= '9') || (c >= 'A' && c <= 'F') || c == '?')
+		return 0;
+	return 1;
+}
+
 FFindTool::FFindTool()
 {
 	pCurFinder = &ByteFinder;
@@ -32,6 +42,7 @@ void FFindTool::Init(FCodeAnalysisState* ptrCodeAnalysis)
 	WordFinder.Init(ptrCodeAnalysis);
 	TextFinder.Init(ptrCodeAnalysis);
 	ByteSequenceFinder.Init(ptrCodeAnalysis);
+	ValueFinder.Init(ptrCodeAnalysis);
 }
 
 void FFindTool::Reset()
@@ -40,6 +51,12 @@ void FFindTool::Reset()
 	WordFinder.Reset();
 	TextFinder.Reset();
 	ByteSequenceFinder.Reset();
+	ValueFinder.Reset();
+}
+
+void FFindTool::OnMachineFrameEnd()
+{
+	ValueFinder.OnMachineFrameEnd();
 }
 
 void FFindTool::DrawUI()
@@ -66,9 +83,20 @@ void FFindTool::DrawUI()
 			SearchType = ESearchType::SearchText;
 			ImGui::EndTabItem();
 		}
+		if (ImGui::BeginTabItem("Value Scan"))
+		{
+			SearchType = ESearchType::SearchValueScan;
+			ImGui::EndTabItem();
+		}
 		ImGui::EndTabBar();
 	}
 
+	if (SearchType == ESearchType::SearchValueScan)
+	{
+		DrawValueScanUI();
+		return;
+	}
+
 #if 0
 	if (ImGui::RadioButton("Single Value", SearchType == ESearchType::SearchSingleValue))
 	{
@@ -210,10 +238,10 @@ void FFindTool::DrawUI()
 	{
 		ImGui::Text("Hex Values");
 		ImGui::SameLine();
-		HelpMarker("Enter hexadecimal values to search for. For example, '1BAFCD' will search for the byte sequence {1B, AF, CD}.");
+		HelpMarker("Enter hexadecimal values to search for. For example, '1BAFCD' will search for the byte sequence {1B, AF, CD}.\nUse '??' to match any byte, '1B??CD' will match {1B, 00, CD}, {1B, 01, CD} etc.");
 		ImGui::SameLine();
 		ImGui::SetNextItemWidth(ImGui::GetFontSize() * 16);
-		ImGui::InputText("##hexvalues", ByteSequenceFinder.SearchText, FByteSequenceFinder::kSearchTextSize, ImGuiInputTextFlags_CharsHexadecimal | ImGuiInputTextFlags_CharsUppercase);
+		ImGui::InputText("##hexvalues", ByteSequenceFinder.SearchText, FByteSequenceFinder::kSearchTextSize, ImGuiInputTextFlags_CallbackCharFilter | ImGuiInputTextFlags_CharsUppercase, HexWildcardCharFilter);
 	}
 
 	// sam. I wanted to use ImGuiInputTextFlags_EnterReturnsTrue here to do the search when enter is pressed but
@@ -345,6 +373,98 @@ void FFindTool::DrawUI()
 	}
 }
 
+void FFindTool::DrawValueScanUI()
+{
+	static const size_t kMaxListedCandidates = 1000;
+	FCodeAnalysisViewState& viewState = pCodeAnalysis->GetFocussedViewState();
+
+	if (ValueFinder.IsActive() == false)
+	{
+		if (pCodeAnalysis->Config.bShowBanks)
+			ImGui::Checkbox("Search Address Space Only", &Options.bSearchPhysicalOnly);
+		ImGui::Checkbox("Search ROM", &Options.bSearchROM);
+
+		ImGui::TextWrapped("Every byte starts as a candidate. Play until the value changes, then filter on how it changed.");
+		if (ImGui::Button("Start"))
+			ValueFinder.Start(Options.bSearchROM, Options.bSearchPhysicalOnly);
+		return;
+	}
+
+	for (int filterNo = 0; filterNo < (int)EValueFilter::EqualTo; filterNo++)
+	{
+		if (filterNo > 0)
+			ImGui::SameLine();
+		if (ImGui::Button(GetValueFilterName((EValueFilter)filterNo)))
+			ValueFinder.ApplyFilter((EValueFilter)filterNo);
+	}
+
+	ImGui::SetNextItemWidth(ImGui::GetFontSize() * 6);
+	ImGui::InputInt("##filtervalue", &ValueFilterValue);
+	ImGui::SameLine();
+	if (ImGui::Button("Equal To"))
+		ValueFinder.ApplyFilter(EValueFilter::EqualTo, ValueFilterValue);
+	ImGui::SameLine();
+	if (ImGui::Button("Delta Of"))
+		ValueFinder.ApplyFilter(EValueFilter::DeltaOf, ValueFilterValue);
+
+	ImGui::Checkbox("Filter Every Frame", &ValueFinder.bAutoFilter);
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(ImGui::GetFontSize() * 8);
+	if (ImGui::BeginCombo("##autofilter", GetValueFilterName(ValueFinder.AutoFilter)))
+	{
+		for (int filterNo = 0; filterNo < (int)EValueFilter::Count; filterNo++)
+		{
+			if (ImGui::Selectable(GetValueFilterName((EValueFilter)filterNo), ValueFinder.AutoFilter == (EValueFilter)filterNo))
+				ValueFinder.AutoFilter = (EValueFilter)filterNo;
+		}
+		ImGui::EndCombo();
+	}
+	ValueFinder.AutoFilterValue = ValueFilterValue;
+	ImGui::SameLine();
+	if (ImGui::Button("Reset"))
+	{
+		ValueFinder.Reset();
+		return;
+	}
+
+	ImGui::Text("%d candidates after %d passes", (int)ValueFinder.GetNoCandidates(), ValueFinder.GetNoPasses());
+	if (ValueFinder.GetNoCandidates() > kMaxListedCandidates)
+		return;
+
+	ValueFinder.GetCandidates(ValueCandidates, kMaxListedCandidates);
+	static const ImGuiTableFlags flags = ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit | ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollY;
+	if (ImGui::BeginTable("ValueCandidatesTable", 3, flags))
+	{
+		const float textWidth = ImGui::CalcTextSize("A").x;
+		ImGui::TableSetupColumn("Address", ImGuiTableColumnFlags_WidthFixed, textWidth * 40);
+		ImGui::TableSetupColumn("Value", ImGuiTableColumnFlags_WidthFixed, textWidth * 6);
+		ImGui::TableSetupColumn("Previous", ImGuiTableColumnFlags_WidthStretch);
+		ImGui::TableHeadersRow();
+
+		ImGuiListClipper clipper((int)ValueCandidates.size());
+		while (clipper.Step())
+		{
+			for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++)
+			{
+				const FAddressRef addr = ValueCandidates[i];
+				ImGui::PushID(i);
+				ImGui::TableNextRow();
+				ImGui::TableNextColumn();
+				ShowDataItemActivity(*pCodeAnalysis, addr);
+				ImGui::Text("    %s", NumStr(addr.Address));
+				ImGui::SameLine();
+				DrawAddressLabel(*pCodeAnalysis, viewState, addr);
+				ImGui::TableNextColumn();
+				ImGui::Text("%d", pCodeAnalysis->ReadByte(addr));
+				ImGui::TableNextColumn();
+				ImGui::Text("%d", ValueFinder.GetPreviousValue(addr));
+				ImGui::PopID();
+			}
+		}
+		ImGui::EndTable();
+	}
+}
+
 void FFinder::Init(FCodeAnalysisState* ptrCodeAnalysis)
 {
 	pCodeAnalysis = ptrCodeAnalysis;
@@ -397,13 +517,15 @@ void FFinder::ProcessMatch(FAddressRef addr, const FSearchOptions& opt)
 		{
 			if (!opt.bSearchUnaccessed)
 			{
-				if (pDataInfo->LastFrameRead == -1 && pDataInfo->LastFrameWritten == -1)
+				const FCodeAnalysisPage* pPage = pCodeAnalysis->GetPageForAddress(addr);
+				const uint16_t pageAddr = addr.Address & FCodeAnalysisPage::kPageMask;
+				if (pPage->DataAccesses.LastFrameRead[pageAddr] == -1 && pPage->DataAccesses.LastFrameWritten[pageAddr] == -1)
 					bAddResult = false;
 			}
 
 			if (!opt.bSearchUnreferenced)
 			{
-				if (pDataInfo->Reads.IsEmpty() && pDataInfo->Writes.IsEmpty())
+				if (pCodeAnalysis->GetDataReferencesForAddress(addr).IsEmpty())
 				{
 					bAddResult = false;
 				}
@@ -428,13 +550,7 @@ void FFinder::ProcessMatch(FAddressRef addr, const FSearchOptions& opt)
 
 void FFinder::RemoveUnchangedResults()
 {
-	for (std::vector<FAddressRef>::iterator it = SearchResults.begin(); it != SearchResults.end(); )
-	{
-		if (!HasValueChanged(*it))
-			it = SearchResults.erase(it);
-		else
-			++it;
-	}
+	SearchResults.erase(std::remove_if(SearchResults.begin(), SearchResults.end(), [this](FAddressRef addr) { return HasValueChanged(addr) == false; }), SearchResults.end());
 }
 
 //---------------------------------------------------------------------------------------------------------------------
@@ -500,9 +616,16 @@ void FByteSequenceFinder::Find(const FSearchOptions& opt)
 		int res;
 		while (pCurBuf < pEnd)
 		{
-			if (sscanf(pCurBuf, "%02X", &res) == 1)
+			if (pCurBuf[0] == '?' && pCurBuf[1] == '?')
+			{
+				SearchBytes[NumSearchBytes] = 0;
+				SearchMask[NumSearchBytes] = 0;
+				NumSearchBytes++;
+			}
+			else if (sscanf(pCurBuf, "%02X", &res) == 1)
 			{
 				SearchBytes[NumSearchBytes] = (uint8_t)res;
+				SearchMask[NumSearchBytes] = 0xff;
 				NumSearchBytes++;
 			}
 			pCurBuf += 2;
@@ -514,7 +637,7 @@ void FByteSequenceFinder::Find(const FSearchOptions& opt)
 
 std::vector<FAddressRef> FByteSequenceFinder::FindAllMatchesInBanks(const FSearchOptions& opt)
 {
-	return pCodeAnalysis->FindAllMemoryPatterns(SearchBytes, NumSearchBytes, opt.bSearchROM, opt.bSearchPhysicalOnly);
+	return pCodeAnalysis->FindAllMemoryPatterns(SearchBytes, NumSearchBytes, opt.bSearchROM, opt.bSearchPhysicalOnly, SearchMask);
 }
 
 bool FByteSequenceFinder::HasValueChanged(FAddressRef addr) const
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CodeAnalyserTypes.h"
+#include "ValueFinder.h"
 
 #include <cinttypes>
 #include <vector>
@@ -103,6 +104,7 @@ public:
 	virtual const char* GetValueString(FAddressRef addr, ENumberDisplayMode numberMode) const override;
 	char SearchText[kSearchTextSize] = "";
 	uint8_t SearchBytes[kMaxByteCount];
+	uint8_t SearchMask[kMaxByteCount];	// 0 for '??' wildcard bytes
 	int NumSearchBytes = 0;
 };
 
@@ -111,6 +113,7 @@ enum ESearchType
 	SearchSingleValue,		// single value - byte or word
 	SearchByteSequence,	// sequence of bytes
 	SearchText,			// text string
+	SearchValueScan,	// narrow down a variable by how it changes
 };
 
 enum ESearchDataType
@@ -127,8 +130,11 @@ public:
 	void Init(FCodeAnalysisState* ptrCodeAnalysis);
 	void DrawUI();
 	void Reset();
+	void OnMachineFrameEnd();
 
 private:
+	void DrawValueScanUI();
+
 	FSearchOptions Options;
 	ESearchType SearchType = ESearchType::SearchSingleValue;
 	ESearchDataType DataSize = ESearchDataType::SearchByte;
@@ -142,5 +148,9 @@ private:
 	FTextFinder TextFinder;
 	FByteSequenceFinder ByteSequenceFinder;
 
+	FValueFinder ValueFinder;
+	int ValueFilterValue = 0;
+	std::vector<FAddressRef> ValueCandidates;	// shown when there are few enough
+
 	FCodeAnalysisState* pCodeAnalysis = nullptr;
 };
@@ -4,6 +4,9 @@
 
 #include <imgui.h>
 #include "UI/CodeAnalyserUI.h"
+#include "Util/MemoryDiff.h"
+
+#include <algorithm>
 
 
 
@@ -11,30 +14,26 @@ void FMemoryAnalyser::Init(FCodeAnalysisState* ptrCodeAnalysis)
 {
 	pCodeAnalysis = ptrCodeAnalysis;
 
-	const auto& banks = pCodeAnalysis->GetBanks();
-	for(const FCodeAnalysisBank& bank : banks)
-	{
-		FBankMemory& bankMem = DiffSnapshotMemoryBanks[bank.Id];
-		bankMem.BankId = bank.Id;
-		bankMem.SizeBytes = bank.GetSizeBytes();
-		bankMem.pMemory = new uint8_t[bankMem.SizeBytes];
-	}
-
 	FindTool.Init(ptrCodeAnalysis);
+	StringCache.Init(ptrCodeAnalysis);
 }
 
 void FMemoryAnalyser::Shutdown()
 {
-	for (auto& bankMemIt : DiffSnapshotMemoryBanks)
-	{
-		delete[] bankMemIt.second.pMemory;
-	}
-	DiffSnapshotMemoryBanks.clear();
+	DiffSnapshots.clear();
+	DiffChangedLocations.clear();
+	StringCache.Shutdown();
 }
 
 void FMemoryAnalyser::FrameTick(void)
 {
+	StringCache.Update();
+}
 
+// the value finder filters against the last machine frame so it doesn't run while the debugger is stopped
+void FMemoryAnalyser::OnMachineFrameEnd(void)
+{
+	FindTool.OnMachineFrameEnd();
 }
 
 void FMemoryAnalyser::DrawUI(void)
@@ -63,73 +62,177 @@ void FMemoryAnalyser::DrawUI(void)
 }
 
 
-void FMemoryAnalyser::DrawMemoryDiffUI(void)
+// Snapshots hold all the RAM banks so they can be compared whatever is paged in
+int FMemoryAnalyser::TakeDiffSnapshot(void)
 {
-	FCodeAnalysisViewState& viewState = pCodeAnalysis->GetFocussedViewState();
-	
-	if (ImGui::Button("SnapShot"))
+	if (DiffSnapshots.size() == kMaxDiffSnapshots)	// lose the oldest
 	{
-		// Capture banks
-		for (auto& memBankIt : DiffSnapshotMemoryBanks)
-		{
-			FBankMemory& memBank = memBankIt.second;
-			const FCodeAnalysisBank* pBank = pCodeAnalysis->GetBank(memBank.BankId);
+		DiffSnapshots.erase(DiffSnapshots.begin());
+		DiffBaseSnapshot = std::max(DiffBaseSnapshot - 1, 0);
+		DiffCompareSnapshot = std::max(DiffCompareSnapshot - 1, -1);
+	}
 
-			if (pBank->bReadOnly)	// skip ROM banks
-				continue;
+	FMemorySnapshot& snapshot = DiffSnapshots.emplace_back();
+	char name[32];
+	snprintf(name, sizeof(name), "Snapshot %d", ++NoSnapshotsTaken);
+	snapshot.Name = name;
 
-			if (bDiffPhysicalMemory == false || pBank->IsMapped())
-			{
-				assert(pBank != nullptr);
-				assert(pBank->GetSizeBytes() == memBank.SizeBytes);
+	for (const FCodeAnalysisBank& bank : pCodeAnalysis->GetBanks())
+	{
+		if (bank.bReadOnly)	// skip ROM banks
+			continue;
 
-				memcpy(memBank.pMemory, pBank->Memory, memBank.SizeBytes);
+		FBankMemory& bankMem = snapshot.Banks.emplace_back();
+		bankMem.BankId = bank.Id;
+		bankMem.Memory.assign(bank.Memory, bank.Memory + bank.GetSizeBytes());
+	}
+
+	return (int)DiffSnapshots.size() - 1;
+}
+
+const uint8_t* FMemoryAnalyser::GetDiffMemory(int snapshotNo, int16_t bankId) const
+{
+	if (snapshotNo == -1)
+	{
+		const FCodeAnalysisBank* pBank = pCodeAnalysis->GetBank(bankId);
+		return pBank != nullptr ? pBank->Memory : nullptr;
+	}
+
+	for (const FBankMemory& bankMem : DiffSnapshots[snapshotNo].Banks)
+	{
+		if (bankMem.BankId == bankId)
+			return bankMem.Memory.data();
+	}
+	return nullptr;
+}
+
+// Banks are diffed into runs of changed bytes, then the screen & ROM areas are cut out of the runs of mapped banks
+void FMemoryAnalyser::DiffMemory(int baseSnapshot, int compareSnapshot, std::vector<FAddressRef>& outChangedLocations)
+{
+	outChangedLocations.clear();
+	NoDiffRanges = 0;
+	if (baseSnapshot < 0 || baseSnapshot >= (int)DiffSnapshots.size() || compareSnapshot >= (int)DiffSnapshots.size())
+		return;
+
+	std::vector<FMemoryDiffRange> ranges;
+	for (const FBankMemory& baseBank : DiffSnapshots[baseSnapshot].Banks)
+	{
+		const FCodeAnalysisBank* pBank = pCodeAnalysis->GetBank(baseBank.BankId);
+		const uint8_t* pCompareMemory = GetDiffMemory(compareSnapshot, baseBank.BankId);
+		if (pBank == nullptr || pCompareMemory == nullptr)
+			continue;
+		if (bDiffPhysicalMemory && pBank->IsMapped() == false)
+			continue;
+
+		ranges.clear();
+		::DiffMemory(baseBank.Memory.data(), pCompareMemory, baseBank.Memory.size(), ranges);
+
+		const int bankAddress = pBank->GetMappedAddress();
+		if (pBank->IsMapped())
+		{
+			const int bankEnd = bankAddress + (int)baseBank.Memory.size();
+			auto excludeArea = [&](const FPhysicalMemoryRange& area)
+			{
+				const int start = std::max<int>(area.Start, bankAddress);
+				const int end = std::min<int>(area.End + 1, bankEnd);
+				if (area.End > area.Start && start < end)
+					ExcludeFromDiffRanges(ranges, start - bankAddress, end - start);
+			};
+
+			if (bDiffVideoMem == false)
+				excludeArea(ScreenMemory);
+			if (bDiffROMAreas == false)
+			{
+				for (const FPhysicalMemoryRange& romArea : ROMAreas)
+					excludeArea(romArea);
 			}
 		}
 
-		bSnapshotAvailable = true;
+		NoDiffRanges += (int)ranges.size();
+		for (const FMemoryDiffRange& range : ranges)
+		{
+			for (uint32_t offset = range.Start; offset < range.Start + range.Size; offset++)
+				outChangedLocations.push_back(FAddressRef(pBank->Id, (uint16_t)(bankAddress + offset)));
+		}
+	}
+}
+
+static const char* GetSnapshotName(const std::vector<FMemorySnapshot>& snapshots, int snapshotNo)
+{
+	return snapshotNo == -1 ? "Current Memory" : snapshots[snapshotNo].Name.c_str();
+}
+
+void FMemoryAnalyser::DrawMemoryDiffUI(void)
+{
+	FCodeAnalysisViewState& viewState = pCodeAnalysis->GetFocussedViewState();
+	
+	if (ImGui::Button("SnapShot"))
+	{
+		const int snapshotNo = TakeDiffSnapshot();
+		if (DiffSnapshots.size() > 1)	// compare the previous snapshot with this one
+		{
+			DiffBaseSnapshot = snapshotNo - 1;
+			DiffCompareSnapshot = snapshotNo;
+		}
+		else	// only one snapshot so compare it with current memory
+		{
+			DiffBaseSnapshot = snapshotNo;
+			DiffCompareSnapshot = -1;
+		}
 		DiffChangedLocations.clear();
+		NoDiffRanges = 0;
 	}
 
-	if (bSnapshotAvailable)
+	if (DiffSnapshots.empty() == false)
 	{
 		ImGui::SameLine();
-
 		if (ImGui::Button("Diff"))
+			DiffMemory(DiffBaseSnapshot, DiffCompareSnapshot, DiffChangedLocations);
+		ImGui::SameLine();
+		if (ImGui::Button("Clear Snapshots"))
 		{
+			DiffSnapshots.clear();
 			DiffChangedLocations.clear();
-
-			for (auto& memBankIt : DiffSnapshotMemoryBanks)
-			{
-				FBankMemory& memBank = memBankIt.second;
-				const FCodeAnalysisBank* pBank = pCodeAnalysis->GetBank(memBank.BankId);
-
-				if (bDiffPhysicalMemory == false || pBank->IsMapped())
-				{
-					assert(pBank != nullptr);
-					assert(pBank->GetSizeBytes() == memBank.SizeBytes);
-
-					if (pBank->bReadOnly)	// skip ROM banks
-						continue;
-
-					for (uint16_t addrOffset = 0; addrOffset < memBank.SizeBytes; addrOffset++)
-					{
-						uint16_t address = pBank->GetMappedAddress() + addrOffset;
-						if (ScreenMemory.InRange(address) == false || bDiffVideoMem)
-						{
-							if (pBank->Memory[addrOffset] != memBank.pMemory[addrOffset])
-								DiffChangedLocations.push_back(FAddressRef(pBank->Id, address));
-						}
-					}
-				}
-			}
+			DiffBaseSnapshot = 0;
+			DiffCompareSnapshot = -1;
+			NoDiffRanges = 0;
 		}
 	}
 
 	ImGui::SameLine();
 	ImGui::Checkbox("Include video memory", &bDiffVideoMem);
 	ImGui::SameLine();
+	ImGui::Checkbox("Include ROM areas", &bDiffROMAreas);
+	ImGui::SameLine();
 	ImGui::Checkbox("Physical memory", &bDiffPhysicalMemory);
+
+	if (DiffSnapshots.empty())
+		return;
+
+	// pick what to compare
+	ImGui::SetNextItemWidth(150.0f);
+	if (ImGui::BeginCombo("Base", GetSnapshotName(DiffSnapshots, DiffBaseSnapshot)))
+	{
+		for (int snapshotNo = 0; snapshotNo < (int)DiffSnapshots.size(); snapshotNo++)
+		{
+			if (ImGui::Selectable(GetSnapshotName(DiffSnapshots, snapshotNo), DiffBaseSnapshot == snapshotNo))
+				DiffBaseSnapshot = snapshotNo;
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(150.0f);
+	if (ImGui::BeginCombo("Compare To", GetSnapshotName(DiffSnapshots, DiffCompareSnapshot)))
+	{
+		for (int snapshotNo = -1; snapshotNo < (int)DiffSnapshots.size(); snapshotNo++)
+		{
+			if (ImGui::Selectable(GetSnapshotName(DiffSnapshots, snapshotNo), DiffCompareSnapshot == snapshotNo))
+				DiffCompareSnapshot = snapshotNo;
+		}
+		ImGui::EndCombo();
+	}
+	ImGui::SameLine();
+	ImGui::Text("%d bytes changed in %d ranges", (int)DiffChangedLocations.size(), NoDiffRanges);
 	
 	ImGuiWindowFlags window_flags = ImGuiWindowFlags_HorizontalScrollbar;
 	//if (ImGui::BeginChild("DiffedMemory", ImVec2(0, 0), true, window_flags))
@@ -163,19 +266,23 @@ void FMemoryAnalyser::DrawMemoryDiffUI(void)
 					ImGui::Text("%s", NumStr(changedAddr.Address));
 					DrawAddressLabel(*pCodeAnalysis, viewState, changedAddr);
 
-					// Snapshot value
+					// Snapshot values
+					const FCodeAnalysisBank* pBank = pCodeAnalysis->GetBank(changedAddr.BankId);
+					const uint16_t bankOffset = changedAddr.Address - pBank->GetMappedAddress();
+					const uint8_t* pOldMemory = GetDiffMemory(DiffBaseSnapshot, changedAddr.BankId);
+					const uint8_t* pNewMemory = GetDiffMemory(DiffCompareSnapshot, changedAddr.BankId);
 					ImGui::TableSetColumnIndex(1);
-					const uint8_t oldValue = DiffSnapshotMemoryBanks[changedAddr.BankId].pMemory[changedAddr.Address];
-					ImGui::Text("%s", NumStr(oldValue));
+					if (pOldMemory != nullptr)
+						ImGui::Text("%s", NumStr(pOldMemory[bankOffset]));
 
-					// Current value
 					ImGui::TableSetColumnIndex(2);
-					ImGui::Text("%s", NumStr(pCodeAnalysis->ReadByte(changedAddr)));
+					if (pNewMemory != nullptr)
+						ImGui::Text("%s", NumStr(pNewMemory[bankOffset]));
 
 					// Code address that last wrote to value
 					ImGui::TableSetColumnIndex(3);
 					ImGui::Text("");
-					DrawAddressLabel(*pCodeAnalysis, viewState, pDataInfo->LastWriter);
+					DrawAddressLabel(*pCodeAnalysis, viewState, pCodeAnalysis->GetLastWriterForAddress(changedAddr));
 
 					ImGui::PopID();
 				}
@@ -189,14 +296,20 @@ void FMemoryAnalyser::DrawMemoryDiffUI(void)
 void FMemoryAnalyser::DrawStringSearchUI()
 {
 	FCodeAnalysisState& state = *pCodeAnalysis;
-	if (ImGui::Button("Search"))
+	bool bRefresh = StringCache.GetGeneration() != FoundStringsGeneration;	// keep the list up to date with the cache
+	bRefresh |= ImGui::Checkbox("Search ROM", &bSearchStringsInROM);
+	ImGui::SameLine();
+	bRefresh |= ImGui::Checkbox("Physical Memory", &bSearchStringsPhysicalMemOnly);
+	if (bRefresh)
 	{
-		FoundStrings = state.FindAllStrings(bSearchStringsInROM, bSearchStringsPhysicalMemOnly);
+		StringCache.GetStrings(FoundStrings, bSearchStringsInROM, bSearchStringsPhysicalMemOnly);
+		FoundStringsGeneration = StringCache.GetGeneration();
 	}
 	ImGui::SameLine();
-	ImGui::Checkbox("Search ROM", &bSearchStringsInROM);
-	ImGui::SameLine();
-	ImGui::Checkbox("Physical Memory", &bSearchStringsPhysicalMemOnly);
+	if (StringCache.IsScanning())
+		ImGui::Text("Scanning...");
+	else
+		ImGui::Text("%d strings", (int)FoundStrings.size());
 
 	// list strings
 	static ImGuiTableFlags tableFLags = ImGuiTableFlags_SizingFixedFit 
@@ -3,9 +3,11 @@
 #include <cinttypes>
 #include <vector>
 #include <map>
+#include <string>
 
 #include "CodeAnalyserTypes.h"
 #include "FindTool.h"
+#include "StringCache.h"
 
 class FCodeAnalysisState;
 
@@ -22,9 +24,15 @@ struct FPhysicalMemoryRange
 // used for diffing memory banks
 struct FBankMemory
 {
-	int16_t		BankId = -1;
-	uint16_t	SizeBytes = 0;
-	uint8_t* pMemory = nullptr;
+	int16_t					BankId = -1;
+	std::vector<uint8_t>	Memory;
+};
+
+// copy of the RAM banks to diff against
+struct FMemorySnapshot
+{
+	std::string					Name;
+	std::vector<FBankMemory>	Banks;
 };
 
 class FMemoryAnalyser
@@ -33,6 +41,7 @@ public:
 	void	Init(FCodeAnalysisState* pCodeAnalysis);
 	void	Shutdown();
 	void	FrameTick(void);
+	void	OnMachineFrameEnd(void);
 	void	DrawUI(void);
 
 	void	ClearROMAreas(void) { ROMAreas.clear(); }
@@ -40,7 +49,13 @@ public:
 
 	void	SetScreenMemoryArea(uint16_t start, uint16_t end) { ScreenMemory = { start,end }; }
 	bool	IsAddressInScreenMemory(uint16_t addr) const { return ScreenMemory.InRange(addr); }
+
+	FStringCache&	GetStringCache() { return StringCache; }
+	// Memory diff, between two snapshots or a snapshot & the current memory
+	int		TakeDiffSnapshot(void);	// returns the snapshot's index
+	void	DiffMemory(int baseSnapshot, int compareSnapshot, std::vector<FAddressRef>& outChangedLocations);	// -1 compares with current memory
 private:
+	const uint8_t*	GetDiffMemory(int snapshotNo, int16_t bankId) const;
 	void	DrawMemoryDiffUI(void);
 	void	DrawStringSearchUI(void);
 
@@ -52,17 +67,24 @@ private:
 	std::vector<FPhysicalMemoryRange>	ROMAreas;
 	FPhysicalMemoryRange	ScreenMemory;
 
-	// Physical Memory Diff
+	// Memory Diff
+	static const int			kMaxDiffSnapshots = 8;
 	bool						bDiffPhysicalMemory = true;
 	bool						bDiffVideoMem = false;
-	bool						bSnapshotAvailable = false;
-	std::map<int16_t,FBankMemory>	DiffSnapshotMemoryBanks;
+	bool						bDiffROMAreas = false;
+	std::vector<FMemorySnapshot>	DiffSnapshots;
+	int							NoSnapshotsTaken = 0;
+	int							DiffBaseSnapshot = 0;
+	int							DiffCompareSnapshot = -1;	// -1 is the current memory
+	int							NoDiffRanges = 0;
 	std::vector<FAddressRef>	DiffChangedLocations;
 
 	FFindTool					FindTool;
 
 	// String find
+	FStringCache				StringCache;
 	bool						bSearchStringsInROM = true;
 	bool						bSearchStringsPhysicalMemOnly = false;
+	int							FoundStringsGeneration = -1;	// string cache generation FoundStrings was taken from
 	std::vector<FFoundString>	FoundStrings;
 };
\ No newline at end of file
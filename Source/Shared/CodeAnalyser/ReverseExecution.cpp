@@ -0,0 +1,313 @@
+#include "ReverseExecution.h"
+
+#include "CodeAnalyser.h"
+#include "Debugger.h"
+#include "Z80/Z80Disassembler.h"
+#include "6502/M6502Disassembler.h"
+
+#include <imgui.h>
+#include <algorithm>
+
+// upper limit on how many checkpoints we'll search back through for reverse step over/continue
+static const int kMaxScanSegments = 16;
+
+void FReverseExecution::Init(FDebugger* pDbg, FCodeAnalysisState* pCA)
+{
+	pDebugger = pDbg;
+	pCodeAnalysis = pCA;
+	Reset();
+}
+
+void FReverseExecution::Reset()
+{
+	InstructionCount = 0;
+	HistoryEndCount = 0;
+	NextCheckpointCount = 0;
+	Checkpoints.clear();
+	IOReads.clear();
+	ReplayMode = EReverseReplayMode::None;
+	ReplayTrace.clear();
+	ReplayHits.clear();
+}
+
+bool FReverseExecution::OnInstructionBoundary(uint64_t pins, uint16_t pc, uint16_t sp)
+{
+	InstructionCount++;
+
+	if (ReplayMode != EReverseReplayMode::None)
+	{
+		if (ReplayMode == EReverseReplayMode::ScanTrace)
+			ReplayTrace.push_back({ InstructionCount, pc, sp });
+
+		return InstructionCount == ReplayTargetCount;
+	}
+
+	HistoryEndCount = InstructionCount;
+
+	if (pMachine != nullptr && InstructionCount >= NextCheckpointCount)
+		TakeCheckpoint(pins, pc, sp);
+
+	return false;
+}
+
+void FReverseExecution::OnIORead(uint16_t port, uint8_t value)
+{
+	if (pMachine == nullptr || ReplayMode != EReverseReplayMode::None)
+		return;
+
+	IOReads.push_back({ InstructionCount, port, value });
+}
+
+void FReverseExecution::OnReplayBreakpointHit(bool bAtInstructionBoundary)
+{
+	if (ReplayMode != EReverseReplayMode::ScanBreakpoints)
+		return;
+
+	// hits part way through an instruction go to the end of that instruction
+	ReplayHits.push_back(bAtInstructionBoundary ? InstructionCount : InstructionCount + 1);
+}
+
+bool FReverseExecution::GetRecordedIORead(uint16_t port, uint8_t& outValue)
+{
+	while (IOReadCursor < IOReads.size() && IOReads[IOReadCursor].InstructionCount < InstructionCount)
+		IOReadCursor++;
+
+	if (IOReadCursor == IOReads.size())
+		return false;
+
+	const FIORead& ioRead = IOReads[IOReadCursor];
+	if (ioRead.InstructionCount != InstructionCount || ioRead.Port != port)
+		return false;
+
+	outValue = ioRead.Value;
+	IOReadCursor++;
+	return true;
+}
+
+void FReverseExecution::TakeCheckpoint(uint64_t pins, uint16_t pc, uint16_t sp)
+{
+	// reuse the state buffer of the oldest checkpoint
+	std::vector<uint8_t> stateBuffer;
+	while ((int)Checkpoints.size() >= MaxCheckpoints)
+	{
+		stateBuffer = std::move(Checkpoints.front().State);
+		Checkpoints.pop_front();
+	}
+
+	// IO reads before the oldest checkpoint can't be replayed
+	const uint64_t oldestCount = Checkpoints.empty() ? InstructionCount : Checkpoints.front().InstructionCount;
+	while (IOReads.empty() == false && IOReads.front().InstructionCount < oldestCount)
+		IOReads.pop_front();
+
+	stateBuffer.resize(pMachine->GetMachineStateSize());
+	pMachine->SaveMachineState(stateBuffer.data(), pins);
+
+	FCheckpoint& checkpoint = Checkpoints.emplace_back();
+	checkpoint.InstructionCount = InstructionCount;
+	checkpoint.PC = pc;
+	checkpoint.SP = sp;
+	checkpoint.State = std::move(stateBuffer);
+
+	NextCheckpointCount = InstructionCount + CheckpointInterval;
+}
+
+// Index of the latest checkpoint at or before the given instruction, -1 if there isn't one
+int FReverseExecution::FindCheckpoint(uint64_t instructionCount) const
+{
+	const auto it = std::upper_bound(Checkpoints.begin(), Checkpoints.end(), instructionCount,
+		[](uint64_t count, const FCheckpoint& checkpoint) { return count < checkpoint.InstructionCount; });
+
+	return (int)(it - Checkpoints.begin()) - 1;
+}
+
+// Restore a checkpoint and re-execute up to the target instruction
+void FReverseExecution::Replay(int checkpointIndex, uint64_t targetCount, EReverseReplayMode mode)
+{
+	const FCheckpoint& checkpoint = Checkpoints[checkpointIndex];
+
+	pMachine->RestoreMachineState(checkpoint.State.data());
+	InstructionCount = checkpoint.InstructionCount;
+	IOReadCursor = std::lower_bound(IOReads.begin(), IOReads.end(), InstructionCount,
+		[](const FIORead& ioRead, uint64_t count) { return ioRead.InstructionCount < count; }) - IOReads.begin();
+
+	ReplayTrace.clear();
+	ReplayHits.clear();
+	if (mode == EReverseReplayMode::ScanTrace)
+		ReplayTrace.push_back({ checkpoint.InstructionCount, checkpoint.PC, checkpoint.SP });
+
+	if (targetCount > InstructionCount)
+	{
+		ReplayMode = mode;
+		ReplayTargetCount = targetCount;
+		pDebugger->Continue();
+		pMachine->ReplayUntilStopped();
+		ReplayMode = EReverseReplayMode::None;
+	}
+
+	pDebugger->Break();
+}
+
+// Anything after the given instruction is no longer valid once execution continues from it
+void FReverseExecution::DiscardHistoryAfter(uint64_t instructionCount)
+{
+	while (Checkpoints.empty() == false && Checkpoints.back().InstructionCount > instructionCount)
+		Checkpoints.pop_back();
+	while (IOReads.empty() == false && IOReads.back().InstructionCount >= instructionCount)
+		IOReads.pop_back();
+
+	NextCheckpointCount = Checkpoints.empty() ? 0 : Checkpoints.back().InstructionCount + CheckpointInterval;
+	HistoryEndCount = instructionCount;
+}
+
+bool FReverseExecution::SeekTo(uint64_t instructionCount)
+{
+	if (pMachine == nullptr || pDebugger->IsStopped() == false || instructionCount > HistoryEndCount)
+		return false;
+
+	const int checkpointIndex = FindCheckpoint(instructionCount);
+	if (checkpointIndex < 0)
+		return false;
+
+	Replay(checkpointIndex, instructionCount, EReverseReplayMode::Seek);
+	DiscardHistoryAfter(instructionCount);
+	return true;
+}
+
+bool FReverseExecution::StepBack(bool bAtInstructionBoundary)
+{
+	if (InstructionCount == 0)
+		return false;
+
+	// if we stopped part way through an instruction then go back to its start
+	return SeekTo(bAtInstructionBoundary ? InstructionCount - 1 : InstructionCount);
+}
+
+static uint16_t GetFallThroughPC(FCodeAnalysisState& state, uint16_t pc)
+{
+	uint8_t opcode = 0;
+	if (state.CPUInterface->CPUType == ECPUType::Z80)
+		return Z80DisassembleGetNextPC(pc, state, opcode);
+	else if (state.CPUInterface->CPUType == ECPUType::M6502)
+		return M6502DisassembleGetNextPC(pc, state, opcode);
+	return pc;
+}
+
+// Step back over a call
+// If the previous instruction returned to here then go back to the instruction that made the call, or was interrupted
+bool FReverseExecution::StepOverBack(bool bAtInstructionBoundary, uint16_t pc, uint16_t sp)
+{
+	if (bAtInstructionBoundary == false || InstructionCount == 0)
+		return StepBack(bAtInstructionBoundary);
+
+	const uint64_t startCount = InstructionCount;
+	uint64_t targetCount = startCount - 1;
+	uint64_t segmentEnd = startCount;
+	int checkpointIndex = FindCheckpoint(startCount - 1);
+
+	for (int segmentNo = 0; segmentNo < kMaxScanSegments && checkpointIndex >= 0; segmentNo++)
+	{
+		Replay(checkpointIndex, segmentEnd, EReverseReplayMode::ScanTrace);
+		int traceIndex = (int)ReplayTrace.size() - 1;
+
+		if (segmentNo == 0)
+		{
+			// ReplayTrace.back() is where we started
+			const FTraceEntry& prevEntry = ReplayTrace[traceIndex - 1];
+			const bool bReturned = prevEntry.SP < sp && GetFallThroughPC(*pCodeAnalysis, prevEntry.PC) != pc;
+			if (bReturned == false)
+				break;
+			traceIndex -= 2;
+		}
+
+		// look back for where the stack pointer was last at this level
+		bool bFinished = false;
+		for (; traceIndex >= 0; traceIndex--)
+		{
+			const FTraceEntry& entry = ReplayTrace[traceIndex];
+			if (entry.SP < sp)
+				continue;
+
+			if (entry.SP == sp && (entry.PC == pc || GetFallThroughPC(*pCodeAnalysis, entry.PC) == pc))
+				targetCount = entry.InstructionCount;
+			bFinished = true;
+			break;
+		}
+
+		if (bFinished)
+			break;
+
+		segmentEnd = Checkpoints[checkpointIndex].InstructionCount;
+		checkpointIndex--;
+	}
+
+	return SeekTo(targetCount);
+}
+
+// Go back to the last breakpoint hit before the current instruction
+bool FReverseExecution::ContinueBack(bool bAtInstructionBoundary)
+{
+	if (InstructionCount == 0)
+		return false;
+
+	const uint64_t startCount = InstructionCount;
+	const uint64_t limit = bAtInstructionBoundary ? startCount - 1 : startCount;
+	uint64_t segmentEnd = limit;
+	int checkpointIndex = FindCheckpoint(limit);
+
+	for (int segmentNo = 0; segmentNo < kMaxScanSegments && checkpointIndex >= 0; segmentNo++)
+	{
+		Replay(checkpointIndex, segmentEnd, EReverseReplayMode::ScanBreakpoints);
+
+		bool bFound = false;
+		uint64_t hitCount = 0;
+		for (uint64_t hit : ReplayHits)
+		{
+			if (hit <= limit)
+			{
+				hitCount = std::max(hitCount, hit);
+				bFound = true;
+			}
+		}
+
+		if (bFound)
+			return SeekTo(hitCount);
+
+		segmentEnd = Checkpoints[checkpointIndex].InstructionCount;
+		checkpointIndex--;
+	}
+
+	// no hit found - go back to where we were
+	SeekTo(startCount);
+	return false;
+}
+
+size_t FReverseExecution::GetMemoryUsage() const
+{
+	size_t usage = IOReads.size() * sizeof(FIORead);
+	for (const FCheckpoint& checkpoint : Checkpoints)
+		usage += checkpoint.State.size();
+	return usage;
+}
+
+void FReverseExecution::DrawUI()
+{
+	if (pMachine == nullptr)
+	{
+		ImGui::Text("Reverse execution is not supported on this machine");
+		return;
+	}
+
+	ImGui::Text("Instruction: %llu", (unsigned long long)InstructionCount);
+	ImGui::Text("History: %llu instructions, %d checkpoints, %dKB",
+		(unsigned long long)(InstructionCount - GetOldestInstructionCount()), (int)Checkpoints.size(), (int)(GetMemoryUsage() / 1024));
+
+	ImGui::SetNextItemWidth(120.0f);
+	if (ImGui::InputInt("Checkpoint Interval", &CheckpointInterval, 1000, 10000))
+	{
+		CheckpointInterval = std::max(CheckpointInterval, 1000);
+		NextCheckpointCount = Checkpoints.empty() ? 0 : Checkpoints.back().InstructionCount + CheckpointInterval;
+	}
+	ImGui::SetNextItemWidth(120.0f);
+	if (ImGui::InputInt("Max Checkpoints", &MaxCheckpoints))
+		MaxCheckpoints = std::min(std::max(MaxCheckpoints, 2), 1024);
+}
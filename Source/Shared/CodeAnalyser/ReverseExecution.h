@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class FDebugger;
+class FCodeAnalysisState;
+
+// Implemented by machines that can save & restore their entire state
+// Reverse execution restores a checkpoint and re-executes from there
+class IReverseExecutionMachine
+{
+public:
+	virtual size_t	GetMachineStateSize() const = 0;
+	virtual void	SaveMachineState(void* pDest, uint64_t pins) = 0;	// called at an instruction boundary mid execution
+	virtual void	RestoreMachineState(const void* pSrc) = 0;
+
+	// execute until the debugger stops, IO reads should be fed from FReverseExecution::GetRecordedIORead
+	virtual void	ReplayUntilStopped() = 0;
+};
+
+enum class EReverseReplayMode
+{
+	None,
+	Seek,				// just run to the target instruction
+	ScanTrace,			// record PC & SP of each instruction
+	ScanBreakpoints,	// record breakpoint hits
+};
+
+// Reverse stepping
+// Machine state is checkpointed every CheckpointInterval instructions and IO reads are logged.
+// Going back to an instruction restores the nearest checkpoint before it and re-executes up to it,
+// so a seek never re-executes more than CheckpointInterval instructions.
+class FReverseExecution
+{
+public:
+	void	Init(FDebugger* pDebugger, FCodeAnalysisState* pCodeAnalysis);
+	void	SetMachine(IReverseExecutionMachine* pNewMachine) { pMachine = pNewMachine; Reset(); }
+	void	Reset();	// throw away the history - call when the machine state is changed outside of execution
+
+	bool	IsAvailable() const { return pMachine != nullptr; }
+	bool	IsReplaying() const { return ReplayMode != EReverseReplayMode::None; }
+	bool	HasHistory() const { return Checkpoints.empty() == false && InstructionCount > Checkpoints.front().InstructionCount; }
+
+	// called by the debugger during execution
+	// returns true if a replay has reached its target and the machine should stop
+	bool	OnInstructionBoundary(uint64_t pins, uint16_t pc, uint16_t sp);
+	void	OnIORead(uint16_t port, uint8_t value);
+	void	OnReplayBreakpointHit(bool bAtInstructionBoundary);
+
+	// called by the machine when replaying
+	bool	GetRecordedIORead(uint16_t port, uint8_t& outValue);
+
+	// bAtInstructionBoundary is false if the machine was stopped part way through an instruction
+	bool	StepBack(bool bAtInstructionBoundary);
+	bool	StepOverBack(bool bAtInstructionBoundary, uint16_t pc, uint16_t sp);
+	bool	ContinueBack(bool bAtInstructionBoundary);
+	bool	SeekTo(uint64_t instructionCount);
+
+	uint64_t	GetInstructionCount() const { return InstructionCount; }
+	uint64_t	GetOldestInstructionCount() const { return Checkpoints.empty() ? InstructionCount : Checkpoints.front().InstructionCount; }
+	size_t		GetMemoryUsage() const;
+	void		SetCheckpointInterval(int interval) { CheckpointInterval = interval; }
+
+	void	DrawUI();
+
+private:
+	struct FCheckpoint
+	{
+		uint64_t				InstructionCount = 0;
+		uint16_t				PC = 0;
+		uint16_t				SP = 0;
+		std::vector<uint8_t>	State;
+	};
+
+	struct FIORead
+	{
+		uint64_t	InstructionCount;
+		uint16_t	Port;
+		uint8_t		Value;
+	};
+
+	struct FTraceEntry
+	{
+		uint64_t	InstructionCount;
+		uint16_t	PC;
+		uint16_t	SP;
+	};
+
+	void	TakeCheckpoint(uint64_t pins, uint16_t pc, uint16_t sp);
+	int		FindCheckpoint(uint64_t instructionCount) const;
+	void	Replay(int checkpointIndex, uint64_t targetCount, EReverseReplayMode mode);
+	void	DiscardHistoryAfter(uint64_t instructionCount);
+
+	FDebugger*					pDebugger = nullptr;
+	FCodeAnalysisState*			pCodeAnalysis = nullptr;
+	IReverseExecutionMachine*	pMachine = nullptr;
+
+	uint64_t					InstructionCount = 0;
+	uint64_t					HistoryEndCount = 0;	// latest instruction we can seek to
+	uint64_t					NextCheckpointCount = 0;
+	int							CheckpointInterval = 20000;	// instructions
+	int							MaxCheckpoints = 64;
+	std::deque<FCheckpoint>		Checkpoints;	// ordered by instruction count
+	std::deque<FIORead>			IOReads;		// ordered by instruction count
+
+	EReverseReplayMode			ReplayMode = EReverseReplayMode::None;
+	uint64_t					ReplayTargetCount = 0;
+	size_t						IOReadCursor = 0;
+	std::vector<FTraceEntry>	ReplayTrace;
+	std::vector<uint64_t>		ReplayHits;	// instruction counts to seek to for each breakpoint hit
+};
@@ -0,0 +1,229 @@
+#include "StringCache.h"
+
+#include "CodeAnalyser.h"
+
+#include <chrono>
+
+// string character tests - in CodeAnalyser.cpp
+bool IsVowel(char c);
+bool IsValidStringChar(char c);
+
+// rescans with more dirty pages than this go on a worker thread
+static const int kAsyncScanPages = 32;
+
+// the scan skips code, anything formatted as other than bytes or text & anything that's been written to
+static bool CanHoldString(const FCodeAnalysisBank& bank, size_t bankOffset)
+{
+	const FCodeAnalysisPage& page = bank.Pages[bankOffset >> FCodeAnalysisPage::kPageShift];
+	const int pageOffset = bankOffset & FCodeAnalysisPage::kPageMask;
+	const FDataInfo& dataInfo = page.DataInfo[pageOffset];
+
+	return page.CodeInfo[pageOffset] == nullptr
+		&& (dataInfo.DataType == EDataType::Byte || dataInfo.DataType == EDataType::Text)
+		&& page.DataAccesses.LastFrameWritten[pageOffset] == -1;
+}
+
+// offsets are into the snapshot
+static bool IsStringByte(const FStringCache::FBankSnapshot& snapshot, size_t offset)
+{
+	return snapshot.bCanHoldString[offset] && IsValidStringChar(snapshot.Memory[offset] & 0x7f);
+}
+
+// end of the string run starting at offset, a character with the high bit set ends a string
+static size_t GetStringRunEnd(const FStringCache::FBankSnapshot& snapshot, size_t offset)
+{
+	while (offset < snapshot.Memory.size() && IsStringByte(snapshot, offset))
+	{
+		if (snapshot.Memory[offset++] & 0x80)
+			break;
+	}
+	return offset;
+}
+
+static FStringCache::FPageStrings ScanPage(const FStringCache::FBankSnapshot& snapshot, int pageNo)
+{
+	FStringCache::FPageStrings pageStrings;
+	const size_t pageStart = (size_t)pageNo * FCodeAnalysisPage::kPageSize - snapshot.BankOffset;
+	const size_t pageEnd = pageStart + FCodeAnalysisPage::kPageSize;
+	size_t offset = pageStart;
+
+	// skip the rest of a string started in an earlier page
+	if (offset > 0 && IsStringByte(snapshot, offset - 1) && (snapshot.Memory[offset - 1] & 0x80) == 0)
+		offset = GetStringRunEnd(snapshot, offset);
+
+	while (offset < pageEnd)
+	{
+		if (IsStringByte(snapshot, offset) == false)
+		{
+			offset++;
+			continue;
+		}
+
+		const size_t stringEnd = GetStringRunEnd(snapshot, offset);
+		std::string foundString;
+		int vowelCount = 0;
+		for (size_t charOffset = offset; charOffset < stringEnd; charOffset++)
+		{
+			const char c = snapshot.Memory[charOffset] & 0x7f;
+			if (IsVowel(c))
+				vowelCount++;
+			foundString.push_back(c);
+		}
+
+		// Run through (simple) acceptance filter
+		if (foundString.size() > 2 && vowelCount > 0)
+			pageStrings.Strings.push_back({ (uint16_t)(snapshot.BankOffset + offset), std::move(foundString) });
+
+		offset = stringEnd;
+	}
+
+	pageStrings.Overhang = (int)(offset - pageEnd);
+	return pageStrings;
+}
+
+static std::vector<FStringCache::FScanResult> ScanSnapshots(std::vector<FStringCache::FBankSnapshot> snapshots)
+{
+	std::vector<FStringCache::FScanResult> results;
+	for (const FStringCache::FBankSnapshot& snapshot : snapshots)
+	{
+		for (int pageNo : snapshot.Pages)
+			results.push_back({ snapshot.BankId, pageNo, ScanPage(snapshot, pageNo) });
+	}
+	return results;
+}
+
+void FStringCache::Shutdown()
+{
+	if (ScanJob.valid())
+		ScanJob.wait();
+	ScanJob = {};
+	BankPages.clear();
+}
+
+void FStringCache::Update(bool bWaitForScan)
+{
+	if (ScanJob.valid())
+	{
+		if (bWaitForScan == false && ScanJob.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			return;
+
+		std::vector<FScanResult> results = ScanJob.get();
+		ApplyResults(results);
+	}
+
+	std::vector<FBankSnapshot> snapshots;
+	int noDirtyPages = 0;
+
+	for (FCodeAnalysisBank& bank : pCodeAnalysis->GetBanks())
+	{
+		std::vector<FPageStrings>& pages = BankPages[bank.Id];
+		pages.resize(bank.NoPages);
+
+		// pages whose strings run on into a rescanned page need rescanning too
+		std::vector<int> dirtyPages;
+		bool bNextPageRescanned = false;
+		for (int pageNo = bank.NoPages - 1; pageNo >= 0; pageNo--)
+		{
+			FCodeAnalysisPage& page = bank.Pages[pageNo];
+			if (page.bStringsDirty || (bNextPageRescanned && pages[pageNo].Overhang > 0))
+			{
+				page.bStringsDirty = false;
+				dirtyPages.push_back(pageNo);
+				bNextPageRescanned = true;
+			}
+			else
+			{
+				bNextPageRescanned = false;
+			}
+		}
+
+		// snapshot each run of dirty pages
+		noDirtyPages += (int)dirtyPages.size();
+		for (size_t runEnd = 0; runEnd < dirtyPages.size(); )
+		{
+			size_t runStart = runEnd++;
+			while (runEnd < dirtyPages.size() && dirtyPages[runEnd] == dirtyPages[runEnd - 1] - 1)
+				runEnd++;
+			TakeSnapshot(bank, dirtyPages[runEnd - 1], dirtyPages[runStart], snapshots.emplace_back());
+		}
+	}
+
+	if (snapshots.empty())
+		return;
+
+	if (noDirtyPages > kAsyncScanPages && bWaitForScan == false)
+	{
+		ScanJob = std::async(std::launch::async, ScanSnapshots, std::move(snapshots));
+	}
+	else
+	{
+		std::vector<FScanResult> results = ScanSnapshots(std::move(snapshots));
+		ApplyResults(results);
+	}
+}
+
+void FStringCache::GetStrings(std::vector<FFoundString>& outStrings, bool bROM, bool bPhysicalOnly) const
+{
+	outStrings.clear();
+
+	for (const FCodeAnalysisBank& bank : pCodeAnalysis->GetBanks())
+	{
+		if (bank.bReadOnly && bROM == false)
+			continue;
+		if (bank.IsMapped() == false && bPhysicalOnly)
+			continue;
+
+		const auto bankIt = BankPages.find(bank.Id);
+		if (bankIt == BankPages.end())
+			continue;
+
+		const uint16_t baseAddress = bank.GetMappedAddress();
+		for (const FPageStrings& pageStrings : bankIt->second)
+		{
+			for (const FCachedString& cachedString : pageStrings.Strings)
+				outStrings.push_back({ FAddressRef(bank.Id, (uint16_t)(baseAddress + cachedString.BankOffset)), cachedString.String });
+		}
+	}
+}
+
+void FStringCache::TakeSnapshot(const FCodeAnalysisBank& bank, int firstPage, int lastPage, FBankSnapshot& outSnapshot) const
+{
+	const size_t sizeBytes = bank.GetSizeBytes();
+	const size_t runStart = (size_t)firstPage * FCodeAnalysisPage::kPageSize;
+	size_t start = runStart > 0 ? runStart - 1 : 0;	// to see if a string runs in from the page before
+	size_t end = (size_t)(lastPage + 1) * FCodeAnalysisPage::kPageSize;
+
+	// take in the rest of a string running off the last page & the byte that ends it
+	while (end < sizeBytes && CanHoldString(bank, end - 1) && IsValidStringChar(bank.Memory[end - 1] & 0x7f) && (bank.Memory[end - 1] & 0x80) == 0)
+		end++;
+
+	outSnapshot.BankId = bank.Id;
+	outSnapshot.BankOffset = start;
+	outSnapshot.Memory.assign(bank.Memory + start, bank.Memory + end);
+	outSnapshot.bCanHoldString.resize(end - start);
+	for (size_t offset = start; offset < end; offset++)
+		outSnapshot.bCanHoldString[offset - start] = CanHoldString(bank, offset);
+
+	for (int pageNo = firstPage; pageNo <= lastPage; pageNo++)
+		outSnapshot.Pages.push_back(pageNo);
+}
+
+// the generation only moves on when a rescan finds different strings
+void FStringCache::ApplyResults(std::vector<FScanResult>& results)
+{
+	bool bChanged = false;
+	for (FScanResult& result : results)
+	{
+		std::vector<FPageStrings>& pages = BankPages[result.BankId];
+		if (result.PageNo >= (int)pages.size())
+			continue;
+
+		FPageStrings& pageStrings = pages[result.PageNo];
+		if (pageStrings.Strings != result.PageStrings.Strings)
+			bChanged = true;
+		pageStrings = std::move(result.PageStrings);
+	}
+
+	if (bChanged)
+		Generation++;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "CodeAnalyserTypes.h"
+
+#include <cinttypes>
+#include <future>
+#include <map>
+#include <string>
+#include <vector>
+
+class FCodeAnalysisState;
+struct FCodeAnalysisBank;
+
+// Strings found in memory, cached per 1K page
+// A string belongs to the page its first character is in & can run on into the following pages.
+// Pages are rescanned when they're flagged as dirty - by the first write to a byte or a change to the analysis.
+// Big rescans, like the first one after a game loads, are done on a worker thread from a copy of the banks.
+class FStringCache
+{
+public:
+	void	Init(FCodeAnalysisState* ptrCodeAnalysis) { pCodeAnalysis = ptrCodeAnalysis; }
+	void	Shutdown();
+	void	Update(bool bWaitForScan = false);	// rescan dirty pages
+
+	bool	IsScanning() const { return ScanJob.valid(); }
+	int		GetGeneration() const { return Generation; }	// moves on whenever the cached strings change
+	void	GetStrings(std::vector<FFoundString>& outStrings, bool bROM, bool bPhysicalOnly) const;
+
+	// a copy of a run of dirty pages & which of their bytes can hold strings, so they can be scanned off the main thread
+	// it takes in the byte before the run & any string running off its end
+	struct FBankSnapshot
+	{
+		int16_t					BankId = -1;
+		size_t					BankOffset = 0;	// bank offset of the first byte copied
+		std::vector<uint8_t>	Memory;
+		std::vector<uint8_t>	bCanHoldString;
+		std::vector<int>		Pages;	// pages to scan
+	};
+
+	struct FCachedString
+	{
+		uint16_t	BankOffset = 0;
+		std::string	String;
+
+		bool operator==(const FCachedString& other) const { return BankOffset == other.BankOffset && String == other.String; }
+	};
+
+	struct FPageStrings
+	{
+		std::vector<FCachedString>	Strings;
+		int		Overhang = 0;	// how far the last string runs past the end of the page
+	};
+
+	struct FScanResult
+	{
+		int16_t		BankId = -1;
+		int			PageNo = 0;
+		FPageStrings	PageStrings;
+	};
+
+private:
+	void	TakeSnapshot(const FCodeAnalysisBank& bank, int firstPage, int lastPage, FBankSnapshot& outSnapshot) const;
+	void	ApplyResults(std::vector<FScanResult>& results);
+
+	FCodeAnalysisState*		pCodeAnalysis = nullptr;
+	std::map<int16_t, std::vector<FPageStrings>>	BankPages;
+	std::future<std::vector<FScanResult>>	ScanJob;
+	int		Generation = 0;
+};
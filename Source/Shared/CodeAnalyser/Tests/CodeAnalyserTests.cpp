@@ -2,6 +2,11 @@
 
 #include "CodeAnalyser/CodeAnalyserTypes.h"
 #include "CodeAnalyser/CodeAnalysisPage.h"
+#include "CodeAnalyser/BreakpointCondition.h"
+#include "CodeAnalyser/Debugger.h"
+#include "Util/StringPool.h"
+#include "Util/MemorySearch.h"
+#include "Util/MemoryDiff.h"
 
 #include <gtest/gtest.h>
 
@@ -27,6 +32,245 @@ TEST(CodeAnalyserTest, Enums)
 	EXPECT_EQ((int)ELabelType::Text, 3);
 }
 
+TEST(CodeAnalyserTest, FItemReferenceTracker)
+{
+	FItemReferenceTracker tracker;
+	EXPECT_EQ(tracker.IsEmpty(), true);
+
+	// register enough unique references to go through inline, list and hashed storage
+	const int kNoRefs = FItemReferenceTracker::kHashThreshold * 2;
+	for (int pass = 0; pass < 2; pass++)	// second pass should find the duplicates
+	{
+		for (int i = 0; i < kNoRefs; i++)
+		{
+			tracker.RegisterAccess(FAddressRef(0, (uint16_t)(0x8000 + i * 3)));
+			if (pass == 0)
+				EXPECT_EQ(tracker.NumReferences(), i + 1);
+		}
+	}
+	EXPECT_EQ(tracker.NumReferences(), kNoRefs);
+
+	// iteration order should be registration order
+	int refNo = 0;
+	for (const FAddressRef& ref : tracker.GetReferences())
+		EXPECT_EQ(ref, FAddressRef(0, (uint16_t)(0x8000 + refNo++ * 3)));
+
+	FItemReferenceTracker copy = tracker;
+	EXPECT_EQ(copy.NumReferences(), kNoRefs);
+	tracker.Reset();
+	EXPECT_EQ(tracker.IsEmpty(), true);
+	EXPECT_EQ(copy.GetReferences()[kNoRefs - 1], FAddressRef(0, (uint16_t)(0x8000 + (kNoRefs - 1) * 3)));
+}
+
+TEST(CodeAnalyserTest, FStringPool)
+{
+	FStringPool pool;
+	EXPECT_EQ(pool.Intern(""), 0u);
+	EXPECT_STREQ(pool.Get(0), "");
+
+	const FStringHandle label = pool.Intern("label");
+	EXPECT_NE(label, 0u);
+	EXPECT_EQ(pool.Intern(std::string("label")), label);	// same string, same handle
+	EXPECT_EQ(pool.Find("label"), label);
+	EXPECT_EQ(pool.Find("missing"), 0u);
+
+	// enough strings to need several blocks, including one bigger than a block
+	const std::string bigString(100 * 1024, 'x');
+	const FStringHandle big = pool.Intern(bigString);
+	for (int i = 0; i < 10000; i++)
+		pool.Intern("label_" + std::to_string(i));
+
+	EXPECT_STREQ(pool.Get(label), "label");
+	EXPECT_EQ(bigString, pool.Get(big));
+	EXPECT_STREQ(pool.Get(pool.Find("label_9999")), "label_9999");
+
+	pool.Clear();
+	EXPECT_EQ(pool.Find("label"), 0u);
+}
+
+TEST(CodeAnalyserTest, MemorySearch)
+{
+	uint8_t memory[64] = { 0 };
+	const uint8_t seq[] = { 0x00, 0x3e, 0x12, 0xcd };
+	memcpy(memory + 4, seq, sizeof(seq));
+	memcpy(memory + 60, seq, sizeof(seq));	// right at the end
+	memory[30] = 0x3e;	// anchor byte with no match
+
+	FMemoryPattern pattern;
+	pattern.pBytes = seq;
+	pattern.Size = sizeof(seq);
+	std::vector<uint32_t> matches;
+	FindPatternMatches(memory, sizeof(memory), pattern, matches);
+	EXPECT_EQ(matches, std::vector<uint32_t>({ 4, 60 }));
+
+	// wildcard the operand
+	memcpy(memory + 20, seq, sizeof(seq));
+	memory[22] = 0x34;
+	const uint8_t mask[] = { 0xff, 0xff, 0x00, 0xff };
+	pattern.pMask = mask;
+	matches.clear();
+	FindPatternMatches(memory, sizeof(memory), pattern, matches);
+	EXPECT_EQ(matches, std::vector<uint32_t>({ 4, 20, 60 }));
+
+	// enough blocks to search on several threads, results per block in order
+	std::vector<uint8_t> bigBlock(512 * 1024, 0);
+	memcpy(&bigBlock[1000], seq, sizeof(seq));
+	memcpy(&bigBlock[bigBlock.size() - sizeof(seq)], seq, sizeof(seq));
+	std::vector<FMemoryBlock> blocks(4, { bigBlock.data(), bigBlock.size() });
+	blocks[2] = { memory, sizeof(memory) };
+	std::vector<std::vector<uint32_t>> blockMatches;
+	FindPatternMatchesInBlocks(blocks, pattern, blockMatches);
+	ASSERT_EQ(blockMatches.size(), 4u);
+	EXPECT_EQ(blockMatches[0], std::vector<uint32_t>({ 1000, (uint32_t)bigBlock.size() - 4 }));
+	EXPECT_EQ(blockMatches[2], std::vector<uint32_t>({ 4, 20, 60 }));
+	EXPECT_EQ(blockMatches[3], blockMatches[0]);
+}
+
+TEST(CodeAnalyserTest, MemoryDiff)
+{
+	std::vector<uint8_t> oldMemory(200, 0);
+	std::vector<uint8_t> newMemory(oldMemory);
+	newMemory[10] = 1;
+	for (int i = 60; i < 70; i++)	// run across a 64 byte block boundary
+		newMemory[i] = 2;
+	newMemory[199] = 3;	// in the tail after the last whole block
+
+	std::vector<FMemoryDiffRange> ranges;
+	DiffMemory(oldMemory.data(), newMemory.data(), newMemory.size(), ranges);
+	EXPECT_EQ(ranges, std::vector<FMemoryDiffRange>({ { 10, 1 }, { 60, 10 }, { 199, 1 } }));
+
+	ExcludeFromDiffRanges(ranges, 62, 4);
+	EXPECT_EQ(ranges, std::vector<FMemoryDiffRange>({ { 10, 1 }, { 60, 2 }, { 66, 4 }, { 199, 1 } }));
+	ExcludeFromDiffRanges(ranges, 0, 100);
+	EXPECT_EQ(ranges, std::vector<FMemoryDiffRange>({ { 199, 1 } }));
+}
+
+TEST(CodeAnalyserTest, FItemSlabAllocator)
+{
+	static int noDestroyed = 0;
+	struct FTestItem
+	{
+		~FTestItem() { noDestroyed++; }
+		std::string	Text = "item";
+	};
+
+	FItemSlabAllocator<FTestItem> allocator;
+	const int kNoItems = (int)FItemSlabAllocator<FTestItem>::kSlabSize * 2 + 10;
+	FTestItem* pFirst = allocator.Allocate();
+	EXPECT_EQ(allocator.Allocate(), pFirst + 1);	// packed together
+	for (int i = 2; i < kNoItems; i++)
+		allocator.Allocate()->Text = std::to_string(i);
+	EXPECT_EQ(allocator.GetNoAllocated(), (size_t)kNoItems);
+	EXPECT_EQ(pFirst->Text, "item");
+
+	allocator.FreeAll();
+	EXPECT_EQ(noDestroyed, kNoItems);
+	EXPECT_EQ(allocator.GetNoAllocated(), 0u);
+	EXPECT_EQ(allocator.Allocate(), pFirst);	// slabs get reused
+}
+
+TEST(CodeAnalyserTest, BreakpointCondition)
+{
+	z80_t cpu;
+	memset(&cpu, 0, sizeof(cpu));
+	cpu.a = 0x10;
+	cpu.hl = 0x4000;
+
+	FConditionContext context;
+	context.CPUType = ECPUType::Z80;
+	context.pZ80 = &cpu;
+	context.PC = 0x8000;
+
+	FBreakpointCondition condition;
+	EXPECT_EQ(condition.Compile("a == $10 && hl >= 0x4000", ECPUType::Z80), true);
+	EXPECT_EQ(condition.Evaluate(context), 1);
+	EXPECT_EQ(condition.Compile("(A + 2) * 3 - (pc >> 12)", ECPUType::Z80), true);	// registers are case insensitive
+	EXPECT_EQ(condition.Evaluate(context), (0x10 + 2) * 3 - 8);
+	EXPECT_EQ(condition.Compile("!(a & 1) || b", ECPUType::Z80), true);
+	EXPECT_EQ(condition.Evaluate(context), 1);
+
+	// arithmetic wraps & compares signed
+	EXPECT_EQ(condition.Compile("1 << 31 < 0", ECPUType::Z80), true);
+	EXPECT_EQ(condition.Evaluate(context), 1);
+	EXPECT_EQ(condition.Compile("-(1 << 31)", ECPUType::Z80), true);
+	EXPECT_EQ(condition.Evaluate(context), INT32_MIN);
+	EXPECT_EQ(condition.Compile("(1 << 31) / -1", ECPUType::Z80), true);
+	EXPECT_EQ(condition.Evaluate(context), INT32_MIN);
+	EXPECT_EQ(condition.Compile("-7 / 2 == -3 && -7 >> 1 == -4", ECPUType::Z80), true);
+	EXPECT_EQ(condition.Evaluate(context), 1);
+
+	// errors
+	EXPECT_EQ(condition.Compile("a ==", ECPUType::Z80), false);
+	EXPECT_EQ(condition.HasError(), true);
+	EXPECT_EQ(condition.Compile("x == 1", ECPUType::Z80), false);	// not a Z80 register
+	EXPECT_EQ(condition.Compile("(a == 1", ECPUType::Z80), false);
+	EXPECT_EQ(condition.Compile("", ECPUType::Z80), true);
+	EXPECT_EQ(condition.IsEmpty(), true);
+}
+
+// Machine whose state depends on every previous instruction and on IO input
+class FTestReverseMachine : public IReverseExecutionMachine
+{
+public:
+	size_t	GetMachineStateSize() const override { return sizeof(Value); }
+	void	SaveMachineState(void* pDest, uint64_t pins) override { memcpy(pDest, &Value, sizeof(Value)); }
+	void	RestoreMachineState(const void* pSrc) override { memcpy(&Value, pSrc, sizeof(Value)); }
+	void	ReplayUntilStopped() override
+	{
+		while (pDebugger->IsStopped() == false)
+			ExecuteInstruction();
+	}
+
+	void	ExecuteInstruction()
+	{
+		uint8_t input = (uint8_t)(LiveInput++ * 7);	// live input changes so replays must use the recorded values
+		FReverseExecution& reverse = pDebugger->GetReverseExecution();
+		if (reverse.IsReplaying())
+			EXPECT_EQ(reverse.GetRecordedIORead(0xfe, input), true);
+		else
+			reverse.OnIORead(0xfe, input);
+
+		Value = Value * 31 + input;
+		if (reverse.OnInstructionBoundary(0, 0, 0))
+			pDebugger->Break();
+	}
+
+	FDebugger*	pDebugger = nullptr;
+	uint32_t	Value = 1;
+	int			LiveInput = 0;
+};
+
+TEST(CodeAnalyserTest, ReverseExecution)
+{
+	FDebugger debugger;
+	FTestReverseMachine machine;
+	machine.pDebugger = &debugger;
+	FReverseExecution& reverse = debugger.GetReverseExecution();
+	reverse.Init(&debugger, nullptr);
+	reverse.SetMachine(&machine);
+	reverse.SetCheckpointInterval(16);
+
+	std::vector<uint32_t> values;	// value after each instruction
+	values.push_back(machine.Value);
+	for (int i = 0; i < 100; i++)
+	{
+		machine.ExecuteInstruction();
+		values.push_back(machine.Value);
+	}
+	debugger.Break();
+	EXPECT_EQ(reverse.GetInstructionCount(), 100);
+
+	EXPECT_EQ(reverse.StepBack(true), true);
+	EXPECT_EQ(reverse.GetInstructionCount(), 99);
+	EXPECT_EQ(machine.Value, values[99]);
+	EXPECT_EQ(debugger.IsStopped(), true);
+
+	EXPECT_EQ(reverse.SeekTo(37), true);
+	EXPECT_EQ(machine.Value, values[37]);
+	EXPECT_EQ(reverse.SeekTo(50), false);	// history after 37 has gone
+	EXPECT_EQ(reverse.SeekTo(0), false);	// before the first checkpoint
+}
+
 bool RunCodeAnalyserTests(void)
 {
 	return true;
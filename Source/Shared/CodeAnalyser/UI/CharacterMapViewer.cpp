@@ -59,8 +59,9 @@ void DrawColourInfoComboBox(EColourInfo* pValue)
 	}
 }
 
-void DrawCharacterSetComboBox(FCodeAnalysisState& state, FAddressRef& addr)
+bool DrawCharacterSetComboBox(FCodeAnalysisState& state, FAddressRef& addr)
 {
+	bool bChanged = false;
 	const FCharacterSet* pCharSet = addr.IsValid() ? GetCharacterSetFromAddress(addr) : nullptr;
 	const FLabelInfo* pLabel = pCharSet != nullptr ? state.GetLabelForAddress(addr) : nullptr;
 
@@ -70,6 +71,7 @@ void DrawCharacterSetComboBox(FCodeAnalysisState& state, FAddressRef& addr)
 	{
 		if (ImGui::Selectable("None", addr.IsValid() == false))
 		{
+			bChanged |= addr.IsValid();
 			addr = FAddressRef();
 		}
 
@@ -81,12 +83,15 @@ void DrawCharacterSetComboBox(FCodeAnalysisState& state, FAddressRef& addr)
 				continue;
 			if (ImGui::Selectable(pSetLabel->GetName(), addr == pCharSet->Params.Address))
 			{
+				bChanged |= addr != pCharSet->Params.Address;
 				addr = pCharSet->Params.Address;
 			}
 		}
 
 		ImGui::EndCombo();
 	}
+
+	return bChanged;
 }
 
 void DrawCharacterSetViewer(FCodeAnalysisState& state, FCodeAnalysisViewState& viewState)
@@ -237,9 +242,12 @@ void DrawCharacterMap(FCharacterMapViewerUIState& uiState, FCodeAnalysisState& s
 		for (int x = 0; x < params.Width; x++)
 		{
 			const uint8_t val = state.ReadByte(physAddress + byte);
-			FDataInfo* pDataInfo = state.GetReadDataInfoForAddress(physAddress + byte);
-			const int framesSinceWritten = pDataInfo->LastFrameWritten == -1 ? 255 : state.CurrentFrameNo - pDataInfo->LastFrameWritten;
-			const int framesSinceRead = pDataInfo->LastFrameRead == -1 ? 255 : state.CurrentFrameNo - pDataInfo->LastFrameRead;
+			const uint16_t charAddress = physAddress + byte;
+			const FCodeAnalysisPage* pPage = state.GetReadPage(charAddress);
+			const int lastFrameWritten = pPage->DataAccesses.LastFrameWritten[charAddress & FCodeAnalysisPage::kPageMask];
+			const int lastFrameRead = pPage->DataAccesses.LastFrameRead[charAddress & FCodeAnalysisPage::kPageMask];
+			const int framesSinceWritten = lastFrameWritten == -1 ? 255 : state.CurrentFrameNo - lastFrameWritten;
+			const int framesSinceRead = lastFrameRead == -1 ? 255 : state.CurrentFrameNo - lastFrameRead;
 			const int wBrightVal = (255 - std::min(framesSinceWritten << 3, 255)) & 0xff;
 			const int rBrightVal = (255 - std::min(framesSinceRead << 3, 255)) & 0xff;
 
@@ -355,12 +363,12 @@ void DrawCharacterMap(FCharacterMapViewerUIState& uiState, FCodeAnalysisState& s
 	{
 		// Show data reads & writes
 		// 
-		FDataInfo* pDataInfo = state.GetDataInfoForAddress(uiState.SelectedCharAddress);
+		const FDataReferences& dataRefs = state.GetDataReferencesForAddress(uiState.SelectedCharAddress);
 		// List Data accesses
-		if (pDataInfo->Reads.IsEmpty() == false)
+		if (dataRefs.Reads.IsEmpty() == false)
 		{
 			ImGui::Text("Reads:");
-			for (const auto& reader : pDataInfo->Reads.GetReferences())
+			for (const auto& reader : dataRefs.Reads.GetReferences())
 			{
 				ShowCodeAccessorActivity(state, reader);
 
@@ -370,10 +378,10 @@ void DrawCharacterMap(FCharacterMapViewerUIState& uiState, FCodeAnalysisState& s
 			}
 		}
 
-		if (pDataInfo->Writes.IsEmpty() == false)
+		if (dataRefs.Writes.IsEmpty() == false)
 		{
 			ImGui::Text("Writes:");
-			for (const auto& writer : pDataInfo->Writes.GetReferences())
+			for (const auto& writer : dataRefs.Writes.GetReferences())
 			{
 				ShowCodeAccessorActivity(state, writer);
 
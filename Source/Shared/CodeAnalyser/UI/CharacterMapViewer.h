@@ -8,7 +8,7 @@ struct FCodeAnalysisViewState;
 
 void DrawMaskInfoComboBox(EMaskInfo* pValue);
 void DrawColourInfoComboBox(EColourInfo* pValue);
-void DrawCharacterSetComboBox(FCodeAnalysisState& state, FAddressRef& addr);
+bool DrawCharacterSetComboBox(FCodeAnalysisState& state, FAddressRef& addr);	// returns true if changed
 
 class FCharacterMapViewer : public FViewerBase
 {
@@ -56,17 +56,15 @@ int GetItemIndexForAddress(const FCodeAnalysisState &state, FAddressRef addr)
 {
 	const FCodeAnalysisBank* pBank = state.GetBank(addr.BankId);
 
-	int index = -1;
-
 	assert(pBank != nullptr);
-	
-	for (int i = 0; i < (int)pBank->ItemList.size(); i++)
-	{
-		if (pBank->ItemList[i].IsValid() && pBank->ItemList[i].AddressRef.Address > addr.Address)
-			return index;
-		index = i;
-	}
-	return -1;
+
+	// item list is sorted by address - find the last item at or before the address
+	const auto it = std::upper_bound(pBank->ItemList.begin(), pBank->ItemList.end(), addr.Address,
+		[](uint16_t address, const FCodeAnalysisItem& item) { return address < item.AddressRef.Address; });
+
+	if (it == pBank->ItemList.end())
+		return -1;
+	return (int)(it - pBank->ItemList.begin()) - 1;
 }
 
 
@@ -313,22 +311,29 @@ void DrawLabelInfo(FCodeAnalysisState &state, FCodeAnalysisViewState& viewState,
 void DrawLabelDetails(FCodeAnalysisState &state, FCodeAnalysisViewState& viewState,const FCodeAnalysisItem& item )
 {
 	FLabelInfo* pLabelInfo = static_cast<FLabelInfo*>(item.Item);
-	std::string LabelText = pLabelInfo->GetName();
-	if (ImGui::InputText("Name", &LabelText))
-	{
-		if (LabelText.empty())
-			LabelText = pLabelInfo->GetName();
 
+	// edit a copy of the name & only rename the label when the edit's finished
+	static const FLabelInfo* pEditedLabel = nullptr;
+	static std::string LabelText;
+	if (pEditedLabel != pLabelInfo)
+		LabelText = pLabelInfo->GetName();
+
+	ImGui::InputText("Name", &LabelText);
+	if (ImGui::IsItemDeactivatedAfterEdit() && LabelText.empty() == false)
+	{
 		pLabelInfo->ChangeName(LabelText.c_str());
+		state.MarkPageChanged(item.AddressRef);
 	}
+	pEditedLabel = ImGui::IsItemActive() ? pLabelInfo : nullptr;
 
 	if(ImGui::Checkbox("Global", &pLabelInfo->Global))
 	{
+		state.MarkPageChanged(item.AddressRef);
 		if (pLabelInfo->LabelType == ELabelType::Code && pLabelInfo->Global == true)
 			pLabelInfo->LabelType = ELabelType::Function;
 		if (pLabelInfo->LabelType == ELabelType::Function && pLabelInfo->Global == false)
 			pLabelInfo->LabelType = ELabelType::Code;
-		GenerateGlobalInfo(state);
+		state.UpdateGlobalLabelIndex(item.AddressRef);
 	}
 
 	ImGui::Text("References:");
@@ -425,6 +430,7 @@ void ProcessKeyCommands(FCodeAnalysisState& state, FCodeAnalysisViewState& viewS
 				else
 					pDataItem->DataType = EDataType::Byte;
 				//pDataItem->bShowBinary = !pDataItem->bShowBinary;
+				state.SetCodeAnalysisDirty(cursorItem.AddressRef);
 			}
 		}
 		else if (ImGui::IsKeyPressed(state.KeyConfig[(int)EKey::AddLabel]))
@@ -467,9 +473,16 @@ void ProcessKeyCommands(FCodeAnalysisState& state, FCodeAnalysisViewState& viewS
 		}
 	}
 
+	// shift + step keys go backwards
+	const bool bReverse = ImGui::GetIO().KeyShift && state.Debugger.CanReverseStep();
+
 	if (ImGui::IsKeyPressed(state.KeyConfig[(int)EKey::BreakContinue]))
 	{
-		if (state.Debugger.IsStopped())
+		if (bReverse)
+		{
+			state.Debugger.ContinueBack();
+		}
+		else if (state.Debugger.IsStopped())
 		{
 			state.Debugger.Continue();
 			//viewState.TrackPCFrame = true;
@@ -481,11 +494,17 @@ void ProcessKeyCommands(FCodeAnalysisState& state, FCodeAnalysisViewState& viewS
 	}
 	else if (ImGui::IsKeyPressed(state.KeyConfig[(int)EKey::StepOver]))
 	{
-		state.Debugger.StepOver();
+		if (bReverse)
+			state.Debugger.StepOverBack();
+		else
+			state.Debugger.StepOver();
 	}
 	else if (ImGui::IsKeyPressed(state.KeyConfig[(int)EKey::StepInto]))
 	{
-		state.Debugger.StepInto();
+		if (bReverse)
+			state.Debugger.StepBack();
+		else
+			state.Debugger.StepInto();
 	}
 	else if (ImGui::IsKeyPressed(state.KeyConfig[(int)EKey::StepFrame]))
 	{
@@ -509,6 +528,7 @@ void UpdatePopups(FCodeAnalysisState& state, FCodeAnalysisViewState& viewState)
 		ImGui::SetKeyboardFocusHere();
 		if (ImGui::InputText("##comment", &cursorItem.Item->Comment, ImGuiInputTextFlags_EnterReturnsTrue))
 		{
+			state.MarkPageChanged(cursorItem.AddressRef);
 			ImGui::CloseCurrentPopup();
 		}
 		ImGui::SetItemDefaultFocus();
@@ -536,6 +556,7 @@ void UpdatePopups(FCodeAnalysisState& state, FCodeAnalysisViewState& viewState)
 		if (ImGui::InputText("##comment", &LabelText, ImGuiInputTextFlags_EnterReturnsTrue))
 		{
 			pLabel->ChangeName(LabelText.c_str());
+			state.MarkPageChanged(cursorItem.AddressRef);
 			ImGui::CloseCurrentPopup();
 		}
 		ImGui::SetItemDefaultFocus();
@@ -550,6 +571,7 @@ struct FItemListBuilder
 	std::vector<FCodeAnalysisItem>&	ItemList;
 	int16_t				BankId = -1;
 	int					CurrAddr = 0;
+	FCommentLine::FAllocator*	pCommentLineAllocator = nullptr;
 	FCommentBlock*		ViewStateCommentBlocks[FCodeAnalysisState::kNoViewStates] = { nullptr };
 
 };
@@ -560,14 +582,13 @@ void ExpandCommentBlock(FCodeAnalysisState& state, FItemListBuilder& builder, FC
 	std::stringstream stringStream(pCommentBlock->Comment);
 	std::string line;
 	FCommentLine* pFirstLine = nullptr;
-	FCodeAnalysisBank* pBank = state.GetBank(builder.BankId);
 
 	while (std::getline(stringStream, line, '\n'))
 	{
 		if (line.empty() || line[0] == '@')	// skip lines starting with @ - we might want to create items from them in future
 			continue;
 
-		FCommentLine* pLine = pBank->CommentLineAllocator.Allocate();
+		FCommentLine* pLine = builder.pCommentLineAllocator->Allocate();
 		pLine->Comment = line;
 		//pLine->Address = addr;
 		builder.ItemList.emplace_back(pLine, builder.BankId, builder.CurrAddr);
@@ -583,21 +604,24 @@ void ExpandCommentBlock(FCodeAnalysisState& state, FItemListBuilder& builder, FC
 	}
 }
 
-void UpdateItemListForBank(FCodeAnalysisState& state, FCodeAnalysisBank& bank)
+// Add the items for one page of a bank to the item list
+// overhang is how far the previous page's last item runs into this page, returns the same for this page
+int BuildItemListForPage(FCodeAnalysisState& state, FCodeAnalysisBank& bank, int bankPageNo, int overhang, std::vector<FCodeAnalysisItem>& itemList)
 {
-	bank.ItemList.clear();
-	bank.CommentLineAllocator.FreeAll();
-	FItemListBuilder listBuilder(bank.ItemList);
+	FCodeAnalysisBank::FPageItemRange& pageRange = bank.PageItemRanges[bankPageNo];
+	pageRange.CommentLineAllocator.FreeAll();
+	FItemListBuilder listBuilder(itemList);
 	listBuilder.BankId = bank.Id;
+	listBuilder.pCommentLineAllocator = &pageRange.CommentLineAllocator;
 
-	const int16_t page = bank.PrimaryMappedPage;
-	const uint16_t bankPhysAddr = page * FCodeAnalysisPage::kPageSize;
-	int nextItemAddress = 0;
+	FCodeAnalysisPage& page = bank.Pages[bankPageNo];
+	const uint16_t bankPhysAddr = bank.GetMappedAddress();
+	const int pageStart = bankPageNo * FCodeAnalysisPage::kPageSize;
+	int nextItemAddress = pageStart + overhang;
 
-	for (int bankAddr = 0; bankAddr < bank.NoPages * FCodeAnalysisPage::kPageSize; bankAddr++)
+	for (int pageAddr = 0; pageAddr < FCodeAnalysisPage::kPageSize; pageAddr++)
 	{
-		FCodeAnalysisPage& page = bank.Pages[bankAddr >> FCodeAnalysisPage::kPageShift];
-		const uint16_t pageAddr = bankAddr & FCodeAnalysisPage::kPageMask;
+		const int bankAddr = pageStart + pageAddr;
 		listBuilder.CurrAddr = bankPhysAddr + bankAddr;
 
 		FCommentBlock* pCommentBlock = page.CommentBlocks[pageAddr];
@@ -611,7 +635,6 @@ void UpdateItemListForBank(FCodeAnalysisState& state, FCodeAnalysisBank& bank)
 		// check if we have gone past this item
 		if (bankAddr >= nextItemAddress)
 		{
-			//FCodeInfo* pCodeInfo = state.GetCodeInfoForAddress(listBuilder.CurrAddr);
 			FCodeInfo* pCodeInfo = page.CodeInfo[pageAddr];
 			if (pCodeInfo != nullptr && pCodeInfo->bDisabled == false)
 			{
@@ -620,20 +643,91 @@ void UpdateItemListForBank(FCodeAnalysisState& state, FCodeAnalysisBank& bank)
 			}
 			else // code and data are mutually exclusive
 			{
-				//FDataInfo* pDataInfo = state.GetReadDataInfoForAddress(listBuilder.CurrAddr);
-				FDataInfo* pDataInfo = &page.DataInfo[pageAddr]; 
-				if (pDataInfo != nullptr)
-				{
-					if (pDataInfo->DataType != EDataType::Blob && pDataInfo->DataType != EDataType::ScreenPixels)	// not sure why we want this
-						nextItemAddress = bankAddr + pDataInfo->ByteSize;
-					else
-						nextItemAddress = bankAddr + 1;
+				FDataInfo* pDataInfo = &page.DataInfo[pageAddr];
+				if (pDataInfo->DataType != EDataType::Blob && pDataInfo->DataType != EDataType::ScreenPixels)	// not sure why we want this
+					nextItemAddress = bankAddr + pDataInfo->ByteSize;
+				else
+					nextItemAddress = bankAddr + 1;
 
-					listBuilder.ItemList.emplace_back(pDataInfo, listBuilder.BankId, listBuilder.CurrAddr);
-				}
+				listBuilder.ItemList.emplace_back(pDataInfo, listBuilder.BankId, listBuilder.CurrAddr);
 			}
 		}
 	}
+
+	return std::max(nextItemAddress - (pageStart + FCodeAnalysisPage::kPageSize), 0);
+}
+
+void UpdateItemListForBank(FCodeAnalysisState& state, FCodeAnalysisBank& bank)
+{
+	bank.ItemList.clear();
+	bank.PageItemRanges.resize(bank.NoPages);
+
+	int overhang = 0;
+	for (int pageNo = 0; pageNo < bank.NoPages; pageNo++)
+	{
+		FCodeAnalysisBank::FPageItemRange& pageRange = bank.PageItemRanges[pageNo];
+		pageRange.FirstItem = (int)bank.ItemList.size();
+		overhang = BuildItemListForPage(state, bank, pageNo, overhang, bank.ItemList);
+		pageRange.NoItems = (int)bank.ItemList.size() - pageRange.FirstItem;
+		pageRange.Overhang = overhang;
+		pageRange.bDirty = false;
+	}
+}
+
+// replace count items at start with newItems
+static void SpliceItems(std::vector<FCodeAnalysisItem>& itemList, int start, int count, const std::vector<FCodeAnalysisItem>& newItems)
+{
+	const int noCommon = std::min(count, (int)newItems.size());
+	std::copy(newItems.begin(), newItems.begin() + noCommon, itemList.begin() + start);
+	if (count > noCommon)
+		itemList.erase(itemList.begin() + start + noCommon, itemList.begin() + start + count);
+	else
+		itemList.insert(itemList.begin() + start + noCommon, newItems.begin() + noCommon, newItems.end());
+}
+
+// Rebuild the dirty pages of a bank and splice them into the bank's item list
+// bUpdateGlobalList: splice them into the state's item list too
+void UpdateDirtyPagesForBank(FCodeAnalysisState& state, FCodeAnalysisBank& bank, bool bUpdateGlobalList)
+{
+	std::vector<FCodeAnalysisItem> pageItems;
+
+	for (int pageNo = 0; pageNo < bank.NoPages; pageNo++)
+	{
+		FCodeAnalysisBank::FPageItemRange& pageRange = bank.PageItemRanges[pageNo];
+		if (pageRange.bDirty == false)
+			continue;
+
+		pageItems.clear();
+		const int overhangIn = pageNo > 0 ? bank.PageItemRanges[pageNo - 1].Overhang : 0;
+		const int overhang = BuildItemListForPage(state, bank, pageNo, overhangIn, pageItems);
+
+		// last item has changed size so the next page starts somewhere else
+		if (overhang != pageRange.Overhang && pageNo + 1 < bank.NoPages)
+			bank.PageItemRanges[pageNo + 1].bDirty = true;
+
+		const int sizeChange = (int)pageItems.size() - pageRange.NoItems;
+		SpliceItems(bank.ItemList, pageRange.FirstItem, pageRange.NoItems, pageItems);
+
+		if (bUpdateGlobalList)
+		{
+			// bank could be in there more than once
+			for (int i = 0; i < (int)state.ItemListBanks.size(); i++)
+			{
+				if (state.ItemListBanks[i].BankId != bank.Id)
+					continue;
+
+				SpliceItems(state.ItemList, state.ItemListBanks[i].FirstItem + pageRange.FirstItem, pageRange.NoItems, pageItems);
+				for (int j = i + 1; j < (int)state.ItemListBanks.size(); j++)
+					state.ItemListBanks[j].FirstItem += sizeChange;
+			}
+		}
+
+		pageRange.NoItems = (int)pageItems.size();
+		pageRange.Overhang = overhang;
+		pageRange.bDirty = false;
+		for (int i = pageNo + 1; i < bank.NoPages; i++)
+			bank.PageItemRanges[i].FirstItem += sizeChange;
+	}
 }
 
 void UpdateItemList(FCodeAnalysisState &state)
@@ -641,47 +735,46 @@ void UpdateItemList(FCodeAnalysisState &state)
 	// build item list - not every frame please!
 	if (state.IsCodeAnalysisDataDirty() )
 	{
-		const float line_height = ImGui::GetTextLineHeight();
-		
-		state.ItemList.clear();
-		//FCommentLine::FreeAll();	// recycle comment lines
-
-		//int nextItemAddress = 0;
+		bool bRebuildGlobalList = state.HasMemoryBeenRemapped() || state.ItemListBanks.empty();
 
 		auto& banks = state.GetBanks();
 		for (auto& bank : banks)
 		{
-			if (bank.bIsDirty || bank.ItemList.empty())
+			if (bank.bIsDirty || (int)bank.PageItemRanges.size() != bank.NoPages)
 			{
 				UpdateItemListForBank(state, bank);
 				bank.bIsDirty = false;
+				bRebuildGlobalList = true;
 			}
 		}
-		int pageNo = 0;
 
-		while (pageNo < FCodeAnalysisState::kNoPagesInAddressSpace)
+		// only the pages that have changed get rebuilt
+		for (auto& bank : banks)
+			UpdateDirtyPagesForBank(state, bank, bRebuildGlobalList == false);
+
+		if (bRebuildGlobalList)
 		{
-			int16_t bankId = state.GetBankFromAddress(pageNo * FCodeAnalysisPage::kPageSize);
-			FCodeAnalysisBank* pBank = state.GetBank(bankId);
-			if (pBank != nullptr)
+			state.ItemList.clear();
+			state.ItemListBanks.clear();
+
+			int pageNo = 0;
+			while (pageNo < FCodeAnalysisState::kNoPagesInAddressSpace)
 			{
-				state.ItemList.insert(state.ItemList.end(), pBank->ItemList.begin(), pBank->ItemList.end());
-				/*const uint16_t bankAddrStart = pageNo * FCodeAnalysisPage::kPageSize;
-				for (const auto& bankItem : pBank->ItemList)
+				int16_t bankId = state.GetBankFromAddress(pageNo * FCodeAnalysisPage::kPageSize);
+				FCodeAnalysisBank* pBank = state.GetBank(bankId);
+				if (pBank != nullptr)
 				{
-					FCodeAnalysisItem& item = state.ItemList.emplace_back(bankItem);
-					item.AddressRef.Address += bankAddrStart;
-				}*/
-				pageNo += pBank->NoPages;
-			}
-			else
-			{
-				pageNo++;
+					state.ItemListBanks.push_back({ bankId, (int)state.ItemList.size() });
+					state.ItemList.insert(state.ItemList.end(), pBank->ItemList.begin(), pBank->ItemList.end());
+					pageNo += pBank->NoPages;
+				}
+				else
+				{
+					pageNo++;
+				}
 			}
 		}
 
-		// Maybe this needs to follow the same algorithm as the main view?
-		//ImGui::SetScrollY(state.GetFocussedViewState().CursorItemIndex * line_height);
 		state.ClearDirtyStatus();
 
 		if (state.HasMemoryBeenRemapped())
@@ -985,7 +1078,7 @@ static const std::vector<std::pair<const char*, EDataItemDisplayType>> g_Display
 bool DrawDataDisplayTypeCombo(const char* pLabel, EDataItemDisplayType& displayType, const FCodeAnalysisState& state)
 {
 
-	return DrawEnumCombo<EDataItemDisplayType>(pLabel, displayType, g_DisplayTypes, [state](EDataItemDisplayType type){ return IsDisplayTypeSupported(type,state);});
+	return DrawEnumCombo<EDataItemDisplayType>(pLabel, displayType, g_DisplayTypes, [&state](EDataItemDisplayType type){ return IsDisplayTypeSupported(type,state);});
 #if 0
 	const int index = (int)displayType;
 	const char* operandTypes[] = { "Unknown", "Pointer", "JumpAddress", "Decimal", "Hex", "Binary",
@@ -1280,6 +1373,28 @@ void DrawDebuggerButtons(FCodeAnalysisState &state, FCodeAnalysisViewState& view
 	{
 		state.Debugger.StepScreenWrite();
 	}
+	if (state.Debugger.GetReverseExecution().IsAvailable())
+	{
+		ImGui::BeginDisabled(state.Debugger.CanReverseStep() == false);
+		if (ImGui::Button("Continue Back (Shift+F5)"))
+		{
+			state.Debugger.ContinueBack();
+			viewState.TrackPCFrame = true;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Step Over Back (Shift+F10)"))
+		{
+			state.Debugger.StepOverBack();
+			viewState.TrackPCFrame = true;
+		}
+		ImGui::SameLine();
+		if (ImGui::Button("Step Back (Shift+F11)"))
+		{
+			state.Debugger.StepBack();
+			viewState.TrackPCFrame = true;
+		}
+		ImGui::EndDisabled();
+	}
 	ImGui::SameLine();
 	if (ImGui::Button("<<< Trace"))
 	{
@@ -221,8 +221,7 @@ void DrawCodeInfo(FCodeAnalysisState& state, FCodeAnalysisViewState& viewState,
 
 			if (pCodeInfo->bSelfModifyingCode)
 			{
-				FDataInfo* pOperandData = state.GetWriteDataInfoForAddress(physAddress + i);
-				if (pOperandData->Writes.IsEmpty() == false)
+				if (state.GetWriteDataReferencesForAddress(physAddress + i).Writes.IsEmpty() == false)
 				{
 					// Change the colour if this is self modifying code and the byte has been modified.
 					bByteModified = true;
@@ -275,7 +274,10 @@ void DrawCodeDetails(FCodeAnalysisState& state, FCodeAnalysisViewState& viewStat
 	const uint16_t physAddress = item.AddressRef.Address;
 
 	if (DrawOperandTypeCombo("Operand Type", pCodeInfo))
+	{
 		pCodeInfo->Text.clear();	// clear for a rewrite
+		state.SetCodeAnalysisDirty(item.AddressRef);
+	}
 
 	if (state.Config.bShowBanks && pCodeInfo->OperandType == EOperandType::Pointer)
 	{
@@ -315,11 +317,11 @@ void DrawCodeDetails(FCodeAnalysisState& state, FCodeAnalysisViewState& viewStat
 
 		for (int i = 1; i < pCodeInfo->ByteSize; i++)
 		{
-			FDataInfo* pOperandData = state.GetWriteDataInfoForAddress(physAddress + i);
-			if (pOperandData->Writes.IsEmpty() == false)
+			const FDataReferences& operandRefs = state.GetWriteDataReferencesForAddress(physAddress + i);
+			if (operandRefs.Writes.IsEmpty() == false)
 			{
 				ImGui::Text("Operand Writes:");
-				for (const auto& writer : pOperandData->Writes.GetReferences())
+				for (const auto& writer : operandRefs.Writes.GetReferences())
 				{
 					DrawCodeAddress(state, viewState, writer);
 				}
@@ -377,10 +377,11 @@ void EditWordDataItem(FCodeAnalysisState& state, uint16_t address)
 
 void ShowDataItemActivity(FCodeAnalysisState& state, FAddressRef addr)
 {
-	const FDataInfo* pDataInfo = state.GetDataInfoForAddress(addr);
-	//const FDataInfo* pWriteDataInfo = state.GetWriteDataInfoForAddress(addr);
-	const int framesSinceWritten = pDataInfo->LastFrameWritten == -1 ? 255 : state.CurrentFrameNo - pDataInfo->LastFrameWritten;
-	const int framesSinceRead = pDataInfo->LastFrameRead == -1 ? 255 : state.CurrentFrameNo - pDataInfo->LastFrameRead;
+	const FCodeAnalysisPage* pPage = state.GetPageForAddress(addr);
+	const int lastFrameWritten = pPage->DataAccesses.LastFrameWritten[addr.Address & FCodeAnalysisPage::kPageMask];
+	const int lastFrameRead = pPage->DataAccesses.LastFrameRead[addr.Address & FCodeAnalysisPage::kPageMask];
+	const int framesSinceWritten = lastFrameWritten == -1 ? 255 : state.CurrentFrameNo - lastFrameWritten;
+	const int framesSinceRead = lastFrameRead == -1 ? 255 : state.CurrentFrameNo - lastFrameRead;
 	const int wBrightVal = (255 - std::min(framesSinceWritten << 2, 255)) & 0xff;
 	const int rBrightVal = (255 - std::min(framesSinceRead << 2, 255)) & 0xff;
 	float offset = 0;
@@ -675,10 +676,12 @@ void DrawDataValueGraphWord(FCodeAnalysisState& state, FAddressRef addressRef)
 }
 
 
-void DrawDataAccesses(FCodeAnalysisState& state, FCodeAnalysisViewState& viewState, FDataInfo* pDataInfo)
+void DrawDataAccesses(FCodeAnalysisState& state, FCodeAnalysisViewState& viewState, FAddressRef addr, FDataInfo* pDataInfo)
 {
+	const FDataReferences& dataRefs = state.GetDataReferencesForAddress(addr);
+
 	// List Data accesses
-	if (pDataInfo->Reads.IsEmpty() == false)
+	if (dataRefs.Reads.IsEmpty() == false)
 	{
 		static std::string commentTxt;
 		static bool bOverride = false;
@@ -696,7 +699,7 @@ void DrawDataAccesses(FCodeAnalysisState& state, FCodeAnalysisViewState& viewSta
 		}
 
 		ImGui::Text("Reads:");
-		for (const auto& reader : pDataInfo->Reads.GetReferences())
+		for (const auto& reader : dataRefs.Reads.GetReferences())
 		{
 			ShowCodeAccessorActivity(state, reader);
 
@@ -710,13 +713,16 @@ void DrawDataAccesses(FCodeAnalysisState& state, FCodeAnalysisViewState& viewSta
 				if (pCodeInfo)
 				{
 					if (pCodeInfo->Comment.empty() || bOverride)
+					{
 						pCodeInfo->Comment = commentTxt;
+						state.MarkPageChanged(reader);
+					}
 				}
 			}
 		}
 	}
 
-	if (pDataInfo->Writes.IsEmpty() == false)
+	if (dataRefs.Writes.IsEmpty() == false)
 	{
 		static std::string commentTxt;
 		static bool bOverride = false;
@@ -734,7 +740,7 @@ void DrawDataAccesses(FCodeAnalysisState& state, FCodeAnalysisViewState& viewSta
 		}
 
 		ImGui::Text("Writes:");
-		for (const auto& writer : pDataInfo->Writes.GetReferences())
+		for (const auto& writer : dataRefs.Writes.GetReferences())
 		{
 			ShowCodeAccessorActivity(state, writer);
 
@@ -748,14 +754,17 @@ void DrawDataAccesses(FCodeAnalysisState& state, FCodeAnalysisViewState& viewSta
 				if (pCodeInfo)
 				{
 					if (pCodeInfo->Comment.empty() || bOverride)
+					{
 						pCodeInfo->Comment = commentTxt;
+						state.MarkPageChanged(writer);
+					}
 				}
 			}
 		}
 	}
 
 	// last writer to address
-	const FAddressRef lastWriter = pDataInfo->LastWriter;
+	const FAddressRef lastWriter = state.GetLastWriterForAddress(addr);
 	if (lastWriter.IsValid())
 	{
 		ImGui::Text("Last Writer: ");
@@ -772,7 +781,8 @@ void DrawDataDetails(FCodeAnalysisState& state, FCodeAnalysisViewState& viewStat
 	ImGui::Text("Display Mode:");
 	ImGui::SameLine();
 	ImGui::SetNextItemWidth(120.0f);
-	DrawDataDisplayTypeCombo("##dataOperand",pDataInfo->DisplayType,state);
+	if (DrawDataDisplayTypeCombo("##dataOperand",pDataInfo->DisplayType,state))
+		state.SetCodeAnalysisDirty(item.AddressRef);
 	switch (pDataInfo->DataType)
 	{
 	case EDataType::Byte:
@@ -861,10 +871,12 @@ void DrawDataDetails(FCodeAnalysisState& state, FCodeAnalysisViewState& viewStat
 
 	case EDataType::CharacterMap:
 	{
-		DrawCharacterSetComboBox(state, pDataInfo->CharSetAddress);
 		const char* format = "%02X";
 		int flags = ImGuiInputTextFlags_EnterReturnsTrue | ImGuiInputTextFlags_CharsHexadecimal;
-		ImGui::InputScalar("Null Character", ImGuiDataType_U8, &pDataInfo->EmptyCharNo,0,0,format,flags);
+		bool bChanged = DrawCharacterSetComboBox(state, pDataInfo->CharSetAddress);
+		bChanged |= ImGui::InputScalar("Null Character", ImGuiDataType_U8, &pDataInfo->EmptyCharNo,0,0,format,flags);
+		if (bChanged)
+			state.SetCodeAnalysisDirty(item.AddressRef);
 	}
 	break;
 #if 0
@@ -930,6 +942,6 @@ void DrawDataDetails(FCodeAnalysisState& state, FCodeAnalysisViewState& viewStat
 		break;
 	}
 
-	DrawDataAccesses(state, viewState, pDataInfo);
+	DrawDataAccesses(state, viewState, item.AddressRef, pDataInfo);
 }
 
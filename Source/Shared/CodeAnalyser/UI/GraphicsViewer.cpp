@@ -149,18 +149,19 @@ uint32_t GetHeatmapColourForMemoryAddress(const FCodeAnalysisPage& page, uint16_
 			return 0xFF00FFFF;	// yellow code
 	}
 
-	const FDataInfo& dataInfo = page.DataInfo[pageAddress];
+	const int lastFrameWritten = page.DataAccesses.LastFrameWritten[pageAddress];
+	const int lastFrameRead = page.DataAccesses.LastFrameRead[pageAddress];
 
-	if (dataInfo.LastFrameWritten != -1)
+	if (lastFrameWritten != -1)
 	{
-		const int framesSinceWritten = currentFrameNo - dataInfo.LastFrameWritten;
+		const int framesSinceWritten = currentFrameNo - lastFrameWritten;
 		if (framesSinceWritten < frameThreshold)
 			return 0xFF0000FF; // red
 	}
 
-	if (dataInfo.LastFrameRead != -1)
+	if (lastFrameRead != -1)
 	{
-		const int framesSinceRead = currentFrameNo - dataInfo.LastFrameRead;
+		const int framesSinceRead = currentFrameNo - lastFrameRead;
 		if (framesSinceRead < frameThreshold)
 			return 0xFF00FF00;	// green
 	}
@@ -62,9 +62,11 @@ void FMemoryAccessGrid::DrawAtInternal(float x, float y)
 			if(curCharAddress.IsValid() == false)
 				continue;
 
-			FDataInfo* pDataInfo = state.GetDataInfoForAddress(curCharAddress);
-			const int framesSinceWritten = pDataInfo->LastFrameWritten == -1 ? 255 : state.CurrentFrameNo - pDataInfo->LastFrameWritten;
-			const int framesSinceRead = pDataInfo->LastFrameRead == -1 ? 255 : state.CurrentFrameNo - pDataInfo->LastFrameRead;
+			const FCodeAnalysisPage* pPage = state.GetPageForAddress(curCharAddress);
+			const int lastFrameWritten = pPage->DataAccesses.LastFrameWritten[curCharAddress.Address & FCodeAnalysisPage::kPageMask];
+			const int lastFrameRead = pPage->DataAccesses.LastFrameRead[curCharAddress.Address & FCodeAnalysisPage::kPageMask];
+			const int framesSinceWritten = lastFrameWritten == -1 ? 255 : state.CurrentFrameNo - lastFrameWritten;
+			const int framesSinceRead = lastFrameRead == -1 ? 255 : state.CurrentFrameNo - lastFrameRead;
 			const int wBrightVal = (255 - std::min(framesSinceWritten << 3, 255)) & 0xff;
 			const int rBrightVal = (255 - std::min(framesSinceRead << 3, 255)) & 0xff;
 			const float xp = pos.x + (x * rectSize);
@@ -180,12 +182,12 @@ void FMemoryAccessGrid::DrawAtInternal(float x, float y)
 		ImGui::Text("Address: %s", NumStr(SelectedCharAddress.Address));
 		DrawAddressLabel(state,state.GetFocussedViewState(),SelectedCharAddress);
 		// Show data reads & writes
-		FDataInfo* pDataInfo = state.GetDataInfoForAddress(SelectedCharAddress);
+		const FDataReferences& dataRefs = state.GetDataReferencesForAddress(SelectedCharAddress);
 		// List Data accesses
-		if (pDataInfo->Reads.IsEmpty() == false)
+		if (dataRefs.Reads.IsEmpty() == false)
 		{
 			ImGui::Text("Reads:");
-			for (const auto& reader : pDataInfo->Reads.GetReferences())
+			for (const auto& reader : dataRefs.Reads.GetReferences())
 			{
 				ShowCodeAccessorActivity(state, reader);
 
@@ -195,10 +197,10 @@ void FMemoryAccessGrid::DrawAtInternal(float x, float y)
 			}
 		}
 
-		if (pDataInfo->Writes.IsEmpty() == false)
+		if (dataRefs.Writes.IsEmpty() == false)
 		{
 			ImGui::Text("Writes:");
-			for (const auto& writer : pDataInfo->Writes.GetReferences())
+			for (const auto& writer : dataRefs.Writes.GetReferences())
 			{
 				ShowCodeAccessorActivity(state, writer);
 
@@ -60,9 +60,10 @@ void FOverviewViewer::CalculateStats()
 			}
 			else
 			{
-				const FDataInfo& dataInfo = bank.Pages[bankAddress >> FCodeAnalysisPage::kPageShift].DataInfo[bankAddress & FCodeAnalysisPage::kPageMask];
-				const bool bRead = dataInfo.LastFrameRead != -1;
-				const bool bWrite = dataInfo.LastFrameWritten != -1;
+				const FCodeAnalysisPage& page = bank.Pages[bankAddress >> FCodeAnalysisPage::kPageShift];
+				const FDataInfo& dataInfo = page.DataInfo[bankAddress & FCodeAnalysisPage::kPageMask];
+				const bool bRead = page.DataAccesses.LastFrameRead[bankAddress & FCodeAnalysisPage::kPageMask] != -1;
+				const bool bWrite = page.DataAccesses.LastFrameWritten[bankAddress & FCodeAnalysisPage::kPageMask] != -1;
 				if(bank.bReadOnly)
 				{
 					Stats.ReadOnlyDataCount++;
@@ -0,0 +1,168 @@
+#include "ValueFinder.h"
+
+#include "CodeAnalyser.h"
+
+#include <cassert>
+#include <string.h>
+
+const char* GetValueFilterName(EValueFilter filter)
+{
+	switch (filter)
+	{
+	case EValueFilter::Changed:		return "Changed";
+	case EValueFilter::Unchanged:	return "Unchanged";
+	case EValueFilter::Increased:	return "Increased";
+	case EValueFilter::Decreased:	return "Decreased";
+	case EValueFilter::EqualTo:		return "Equal To";
+	case EValueFilter::DeltaOf:		return "Delta Of";
+	default:						return "";
+	}
+}
+
+static int CountBits(uint64_t bits)
+{
+	bits = bits - ((bits >> 1) & 0x5555555555555555ull);
+	bits = (bits & 0x3333333333333333ull) + ((bits >> 2) & 0x3333333333333333ull);
+	bits = (bits + (bits >> 4)) & 0x0f0f0f0f0f0f0f0full;
+	return (int)((bits * 0x0101010101010101ull) >> 56);
+}
+
+// Clear the candidates that fail the test, 64 bytes at a time
+// The inner loop is branch free so the compiler can vectorise it, words with no candidates left are skipped.
+template <typename TTest>
+static size_t FilterCandidates(const uint8_t* pMemory, const uint8_t* pPrevious, uint64_t* pCandidates, size_t noWords, TTest test)
+{
+	size_t noCandidates = 0;
+	for (size_t wordNo = 0; wordNo < noWords; wordNo++)
+	{
+		uint64_t candidates = pCandidates[wordNo];
+		if (candidates == 0)
+			continue;
+
+		const uint8_t* pCur = pMemory + wordNo * 64;
+		const uint8_t* pPrev = pPrevious + wordNo * 64;
+		uint64_t passed = 0;
+		for (int byteNo = 0; byteNo < 64; byteNo++)
+			passed |= (uint64_t)test(pCur[byteNo], pPrev[byteNo]) << byteNo;
+
+		candidates &= passed;
+		pCandidates[wordNo] = candidates;
+		noCandidates += CountBits(candidates);
+	}
+	return noCandidates;
+}
+
+void FValueFinder::Start(bool bROM, bool bPhysicalOnly)
+{
+	Reset();
+
+	for (const FCodeAnalysisBank& bank : pCodeAnalysis->GetBanks())
+	{
+		if (bank.bReadOnly && bROM == false)
+			continue;
+		if (bank.IsMapped() == false && bPhysicalOnly)
+			continue;
+
+		const size_t sizeBytes = bank.GetSizeBytes();
+		assert((sizeBytes & 63) == 0);
+
+		FBankCandidates& bankCandidates = Banks.emplace_back();
+		bankCandidates.BankId = bank.Id;
+		bankCandidates.Candidates.assign(sizeBytes / 64, ~0ull);
+		bankCandidates.PreviousMemory.assign(bank.Memory, bank.Memory + sizeBytes);
+		NoCandidates += sizeBytes;
+	}
+}
+
+void FValueFinder::Reset()
+{
+	Banks.clear();
+	NoCandidates = 0;
+	NoPasses = 0;
+	bAutoFilter = false;
+}
+
+void FValueFinder::ApplyFilter(EValueFilter filter, int value)
+{
+	const uint8_t byteValue = (uint8_t)value;	// deltas wrap like the machine's arithmetic
+	NoCandidates = 0;
+
+	for (FBankCandidates& bankCandidates : Banks)
+	{
+		const FCodeAnalysisBank* pBank = pCodeAnalysis->GetBank(bankCandidates.BankId);
+		const uint8_t* pMemory = pBank->Memory;
+		const uint8_t* pPrevious = bankCandidates.PreviousMemory.data();
+		uint64_t* pCandidates = bankCandidates.Candidates.data();
+		const size_t noWords = bankCandidates.Candidates.size();
+
+		switch (filter)
+		{
+		case EValueFilter::Changed:
+			NoCandidates += FilterCandidates(pMemory, pPrevious, pCandidates, noWords, [](uint8_t cur, uint8_t prev) { return cur != prev; });
+			break;
+		case EValueFilter::Unchanged:
+			NoCandidates += FilterCandidates(pMemory, pPrevious, pCandidates, noWords, [](uint8_t cur, uint8_t prev) { return cur == prev; });
+			break;
+		case EValueFilter::Increased:
+			NoCandidates += FilterCandidates(pMemory, pPrevious, pCandidates, noWords, [](uint8_t cur, uint8_t prev) { return cur > prev; });
+			break;
+		case EValueFilter::Decreased:
+			NoCandidates += FilterCandidates(pMemory, pPrevious, pCandidates, noWords, [](uint8_t cur, uint8_t prev) { return cur < prev; });
+			break;
+		case EValueFilter::EqualTo:
+			NoCandidates += FilterCandidates(pMemory, pPrevious, pCandidates, noWords, [byteValue](uint8_t cur, uint8_t prev) { return cur == byteValue; });
+			break;
+		case EValueFilter::DeltaOf:
+			NoCandidates += FilterCandidates(pMemory, pPrevious, pCandidates, noWords, [byteValue](uint8_t cur, uint8_t prev) { return (uint8_t)(cur - prev) == byteValue; });
+			break;
+		default:
+			break;
+		}
+
+		memcpy(bankCandidates.PreviousMemory.data(), pMemory, bankCandidates.PreviousMemory.size());
+	}
+
+	NoPasses++;
+}
+
+void FValueFinder::OnMachineFrameEnd()
+{
+	if (bAutoFilter && IsActive())
+		ApplyFilter(AutoFilter, AutoFilterValue);
+}
+
+void FValueFinder::GetCandidates(std::vector<FAddressRef>& outCandidates, size_t maxCandidates) const
+{
+	outCandidates.clear();
+
+	for (const FBankCandidates& bankCandidates : Banks)
+	{
+		const uint16_t baseAddress = pCodeAnalysis->GetBank(bankCandidates.BankId)->GetMappedAddress();
+		for (size_t wordNo = 0; wordNo < bankCandidates.Candidates.size(); wordNo++)
+		{
+			uint64_t candidates = bankCandidates.Candidates[wordNo];
+			while (candidates != 0)
+			{
+				if (outCandidates.size() == maxCandidates)
+					return;
+
+				const int bitNo = CountBits((candidates & (~candidates + 1)) - 1);	// lowest set bit
+				candidates &= candidates - 1;
+				outCandidates.push_back(FAddressRef(bankCandidates.BankId, (uint16_t)(baseAddress + wordNo * 64 + bitNo)));
+			}
+		}
+	}
+}
+
+uint8_t FValueFinder::GetPreviousValue(FAddressRef addr) const
+{
+	for (const FBankCandidates& bankCandidates : Banks)
+	{
+		if (bankCandidates.BankId == addr.BankId)
+		{
+			const uint16_t baseAddress = pCodeAnalysis->GetBank(addr.BankId)->GetMappedAddress();
+			return bankCandidates.PreviousMemory[(uint16_t)(addr.Address - baseAddress)];
+		}
+	}
+	return 0;
+}
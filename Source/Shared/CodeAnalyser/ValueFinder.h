@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CodeAnalyserTypes.h"
+
+#include <cinttypes>
+#include <vector>
+
+class FCodeAnalysisState;
+
+enum class EValueFilter
+{
+	Changed,
+	Unchanged,
+	Increased,
+	Decreased,
+	EqualTo,	// value is N
+	DeltaOf,	// value has changed by N
+
+	Count
+};
+
+const char* GetValueFilterName(EValueFilter filter);
+
+// Incremental value finder for tracking down variables such as lives, energy & score
+// Every byte of the searched banks starts as a candidate, each bank has a candidate bitset & a copy of its memory.
+// A filter pass compares memory against the copy from the previous pass, clears the candidates that fail & takes a new copy.
+class FValueFinder
+{
+public:
+	void	Init(FCodeAnalysisState* ptrCodeAnalysis) { pCodeAnalysis = ptrCodeAnalysis; }
+	void	Start(bool bROM, bool bPhysicalOnly);
+	void	Reset();
+	void	ApplyFilter(EValueFilter filter, int value = 0);
+	void	OnMachineFrameEnd();
+
+	bool	IsActive() const { return Banks.empty() == false; }
+	size_t	GetNoCandidates() const { return NoCandidates; }
+	int		GetNoPasses() const { return NoPasses; }
+	void	GetCandidates(std::vector<FAddressRef>& outCandidates, size_t maxCandidates) const;
+	uint8_t	GetPreviousValue(FAddressRef addr) const;
+
+	// filter applied every machine frame while set
+	bool			bAutoFilter = false;
+	EValueFilter	AutoFilter = EValueFilter::Unchanged;
+	int				AutoFilterValue = 0;
+
+private:
+	struct FBankCandidates
+	{
+		int16_t					BankId = -1;
+		std::vector<uint64_t>	Candidates;	// bit per byte
+		std::vector<uint8_t>	PreviousMemory;
+	};
+
+	FCodeAnalysisState*				pCodeAnalysis = nullptr;
+	std::vector<FBankCandidates>	Banks;
+	size_t							NoCandidates = 0;
+	int								NoPasses = 0;
+};
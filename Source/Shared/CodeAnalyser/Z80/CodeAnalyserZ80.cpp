@@ -3,6 +3,7 @@
 #include <cassert>
 
 #include "chips/z80.h"
+#include "Z80Disassembler.h"
 
 
 bool CheckPointerIndirectionInstructionZ80(FCodeAnalysisState& state, uint16_t pc, uint16_t* out_addr)
@@ -228,139 +229,157 @@ bool CheckStopInstructionZ80(FCodeAnalysisState& state, uint16_t pc)
 	}
 }
 
-bool RegisterCodeExecutedZ80(FCodeAnalysisState& state, uint16_t pc, uint16_t oldpc)
+// Decode what's needed when the instruction is executed
+// returns false if the result can't be cached
+bool DecodeInstructionZ80(FCodeAnalysisState& state, uint16_t pc, FDecodedInstruction& instr)
 {
-	const ICPUInterface* pCPUInterface = state.CPUInterface;
-	FDebugger& debugger = state.Debugger;
-	const uint8_t opcode = pCPUInterface->ReadByte(pc);
-	const uint8_t oldOpcode = pCPUInterface->ReadByte(oldpc);
-	const z80_t* pCPU = static_cast<z80_t*>(state.CPUInterface->GetCPUEmulator());
-
-	std::vector<FCPUFunctionCall>&	callStack = state.Debugger.GetCallstack();
-
-	//const FZ80InternalState& cpuState = pCPU->internal_state;
-
-	bool bPushInstruction = false;
-	
-	// check current op code
-	switch (opcode)
+	uint16_t operandAddr = 0;
+	if (CheckJumpInstructionZ80(state, pc, &operandAddr))
+		instr.bJump = true;
+	else if (CheckPointerRefInstructionZ80(state, pc, &operandAddr))
+		instr.bPointerRef = true;
+	instr.OperandAddress = operandAddr;
+
+	uint8_t stepOpcode = 0;
+	instr.Opcode = state.ReadByte(pc);
+	instr.Length = (uint8_t)(Z80DisassembleGetNextPC(pc, state, stepOpcode) - pc);
+
+	switch (instr.Opcode)
 	{
 		// Stack
-		case 0x31:	// LD SP,NN
-			{
-				const uint16_t newSP = state.ReadWord(pc + 1);
-				debugger.RegisterNewStackPointer(newSP,state.AddressRefFromPhysicalAddress(pc));
-			}
-			break;
-		case 0xF9:	// LD SP,HL
-			debugger.RegisterNewStackPointer(pCPU->hl, state.AddressRefFromPhysicalAddress(pc));
-			break;
-		case 0xc5:	// PUSH BC
-		case 0xd5:	// PUSH DE
-		case 0xe5:	// PUSH HL
-		case 0xf5:	// PUSH AF
-			bPushInstruction = true;
+	case 0x31:	// LD SP,NN
+		instr.StackEffect = EInstructionStackEffect::SetSPImmediate;
+		break;
+	case 0xF9:	// LD SP,HL
+		instr.StackEffect = EInstructionStackEffect::SetSPFromHL;
+		break;
+	case 0xc5:	// PUSH BC
+	case 0xd5:	// PUSH DE
+	case 0xe5:	// PUSH HL
+	case 0xf5:	// PUSH AF
+		instr.StackEffect = EInstructionStackEffect::Push;
 		break;
 
-		
-		
 		// Call functions
 		/* CALL nnnn */
-		case 0xCD:
-			/* CALL cc,nnnn */
-		case 0xDC: case 0xFC: case 0xD4: case 0xC4:
-		case 0xF4: case 0xEC: case 0xE4: case 0xCC:
-			bPushInstruction = true;
+	case 0xCD:
+		/* CALL cc,nnnn */
+	case 0xDC: case 0xFC: case 0xD4: case 0xC4:
+	case 0xF4: case 0xEC: case 0xE4: case 0xCC:
+		instr.StackEffect = EInstructionStackEffect::Push;
+		instr.Flow = EInstructionFlow::Call;
+		instr.bStepOver = true;
+		break;
+
+		/* DJNZ d */
+	case 0x10:
+		instr.bStepOver = true;
+		break;
+
+		// ret
+	case 0xC0:
+	case 0xC8:
+	case 0xC9:
+	case 0xD0:
+	case 0xD8:
+	case 0xE0:
+	case 0xE8:
+	case 0xF0:
+	case 0xF8:
+		instr.Flow = EInstructionFlow::Return;
+		break;
+
+		// index register opcodes
+	case 0xdd:
+	case 0xfd:
+	{
+		const bool bIX = instr.Opcode == 0xDD;
+		switch (state.ReadByte(pc + 1))
+		{
+		case 0xF9:	// LD SP,IX/IY
+			instr.StackEffect = bIX ? EInstructionStackEffect::SetSPFromIX : EInstructionStackEffect::SetSPFromIY;
+			break;
+		case 0xe5:	// PUSH IX/IY
+			instr.StackEffect = EInstructionStackEffect::Push;
 			break;
+		default:
+			break;
+		}
+	}
+	break;
 
-			// index register opcodes
-		case 0xdd:
-		case 0xfd:
+	case 0xed:
+		if (state.ReadByte(pc + 1) == 0x7b)	// LD SP,(nn)
 		{
-			const bool bIX = opcode == 0xDD;
-			const uint8_t indexOpcode = pCPUInterface->ReadByte(pc + 1);
-			switch (indexOpcode)
-			{
-			case 0xF9:	// LD SP,IX/IY
-				debugger.RegisterNewStackPointer(bIX ? pCPU->ix : pCPU->iy, state.AddressRefFromPhysicalAddress(pc));
-				break;
-			case 0xe5:	// PUSH IX/IY
-				bPushInstruction = true;
-				break;
-			default:
-				break;
-			}
+			instr.StackEffect = EInstructionStackEffect::SetSPIndirect;
+			instr.OperandAddress = state.ReadWord(pc + 2);
 		}
 		break;
+	default:
+		break;
+	}
 
-		case 0xed:
-		{
-			const uint8_t extendedOpcode = pCPUInterface->ReadByte(pc + 1);
+	return true;
+}
 
-			switch (extendedOpcode)
-			{
-				case 0x7b:	// LD SP,(nn)
-				{
-					const uint16_t newSP = state.ReadWord(state.ReadWord(pc + 2));	// indirect
-					debugger.RegisterNewStackPointer(newSP, state.AddressRefFromPhysicalAddress(pc));
-				}
-				break;
-			}
+bool RegisterCodeExecutedZ80(FCodeAnalysisState& state, uint16_t pc, uint16_t oldpc, const FDecodedInstruction& instr, const FDecodedInstruction& oldInstr)
+{
+	FDebugger& debugger = state.Debugger;
+	const z80_t* pCPU = static_cast<z80_t*>(state.CPUInterface->GetCPUEmulator());
 
-		}
-			break;
+	std::vector<FCPUFunctionCall>&	callStack = state.Debugger.GetCallstack();
+
+	bool bPushInstruction = false;
+	
+	// check current instruction
+	switch (instr.StackEffect)
+	{
+	case EInstructionStackEffect::SetSPImmediate:
+		debugger.RegisterNewStackPointer(instr.OperandAddress, state.AddressRefFromPhysicalAddress(pc));
+		break;
+	case EInstructionStackEffect::SetSPIndirect:
+		debugger.RegisterNewStackPointer(state.ReadWord(instr.OperandAddress), state.AddressRefFromPhysicalAddress(pc));
+		break;
+	case EInstructionStackEffect::SetSPFromHL:
+		debugger.RegisterNewStackPointer(pCPU->hl, state.AddressRefFromPhysicalAddress(pc));
+		break;
+	case EInstructionStackEffect::SetSPFromIX:
+		debugger.RegisterNewStackPointer(pCPU->ix, state.AddressRefFromPhysicalAddress(pc));
+		break;
+	case EInstructionStackEffect::SetSPFromIY:
+		debugger.RegisterNewStackPointer(pCPU->iy, state.AddressRefFromPhysicalAddress(pc));
+		break;
+	case EInstructionStackEffect::Push:
+		bPushInstruction = true;
+		break;
 	default:
 		break;
 	}
 
-	// TODO: check old opcode for jump/ret instructions
-	switch (oldOpcode)
+	// check previous instruction for calls & returns
+	switch (oldInstr.Flow)
 	{
-		// Call instructions
-		/* CALL nnnn */
-	case 0xCD:
-		/* CALL cc,nnnn */
-	case 0xDC: case 0xFC: case 0xD4: case 0xC4:
-	case 0xF4: case 0xEC: case 0xE4: case 0xCC:
-
-		if (pc != oldpc + 3)	// call instructions are 3 bytes
+	case EInstructionFlow::Call:
+		if (pc != (uint16_t)(oldpc + oldInstr.Length))	// didn't fall through so the call was taken
 		{
 			FCPUFunctionCall callInfo;
 			callInfo.CallAddr = state.AddressRefFromPhysicalAddress(oldpc);
 			callInfo.FunctionAddr = state.AddressRefFromPhysicalAddress(pc);
-			callInfo.ReturnAddr = state.AddressRefFromPhysicalAddress(oldpc + 3);
+			callInfo.ReturnAddr = state.AddressRefFromPhysicalAddress(oldpc + oldInstr.Length);
 			callStack.push_back(callInfo);
 		}
-
 		break;
-		// ret
-	case 0xC0:
-	case 0xC8:
-	case 0xC9:
-	case 0xD0:
-	case 0xD8:
-	case 0xE0:
-	case 0xE8:
-	case 0xF0:
-	case 0xF8:
-		if (pc != oldpc + 1)	// ret instructions are 1 byte so if we're not on the next instruction, we've returned
+
+	case EInstructionFlow::Return:
+		if (pc != (uint16_t)(oldpc + oldInstr.Length))	// if we're not on the next instruction, we've returned
 		{
 			if (callStack.empty() == false)
-			{
-				FCPUFunctionCall& callInfo = callStack.back();
-				//assert(callInfo.ReturnAddr == nextpc);
-
 				callStack.pop_back();
-
-				/*if (callInfo.ReturnAddr != nextpc)
-				{
-					fprintf(stderr, "PC: $%04x, NextPC $%04x, Return Address $%04x\n", pc, nextpc, callInfo.ReturnAddr);
-					return true;
-				}*/
-
-			}
 		}
 		break;
+
+	default:
+		break;
 	}
 
 	// Handle push instruction
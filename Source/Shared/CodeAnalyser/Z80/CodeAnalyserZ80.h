@@ -32,7 +32,8 @@ bool CheckPointerRefInstructionZ80(FCodeAnalysisState& state, uint16_t pc, uint1
 bool CheckJumpInstructionZ80(FCodeAnalysisState& state, uint16_t pc, uint16_t* out_addr);
 bool CheckCallInstructionZ80(FCodeAnalysisState& state, uint16_t pc);
 bool CheckStopInstructionZ80(FCodeAnalysisState& state, uint16_t pc);
-bool RegisterCodeExecutedZ80(FCodeAnalysisState& state, uint16_t pc, uint16_t oldpc);
+bool DecodeInstructionZ80(FCodeAnalysisState& state, uint16_t pc, FDecodedInstruction& instr);
+bool RegisterCodeExecutedZ80(FCodeAnalysisState& state, uint16_t pc, uint16_t oldpc, const FDecodedInstruction& instr, const FDecodedInstruction& oldInstr);
 
 FMachineStateZ80* AllocateMachineStateZ80();
 void FreeMachineStatesZ80();
@@ -0,0 +1,21 @@
+#include "../ImGuiTexture.h"
+
+// Texture functions for builds with no renderer, like the batch runner
+// Nothing gets drawn so no textures are made
+
+ImTextureID ImGui_CreateTextureRGBA(const void* pixels, int width, int height)
+{
+	return nullptr;
+}
+
+void ImGui_FreeTexture(ImTextureID texture)
+{
+}
+
+void ImGui_UpdateTextureRGBA(ImTextureID texture, const void* pixels)
+{
+}
+
+void ImGui_UpdateTextureRGBA(ImTextureID texture, const void* pixels, int srcWidth, int srcHeight)
+{
+}
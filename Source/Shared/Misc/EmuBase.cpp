@@ -13,6 +13,9 @@
 #include "Util/FileUtil.h"
 #include "LuaScripting/LuaSys.h"
 
+#include <cassert>
+#include <chrono>
+
 void FEmulatorLaunchConfig::ParseCommandline(int argc, char** argv)
 {
 	std::vector<std::string> argList;
@@ -87,6 +90,79 @@ void FEmuBase::Reset()
 
 }
 
+// Run the machine for a host frame
+// In warp mode whole machine frames are run until the time budget is used, only the last one gets displayed
+void FEmuBase::ExecuteHostFrame(uint32_t microSeconds)
+{
+	if (IsWarping() == false)
+	{
+		ExecuteFrame(microSeconds);
+		UpdateLoadingDetection();
+		NoWarpFrames = 0;
+		return;
+	}
+
+	const uint32_t frameMicroSeconds = GetMachineFrameMicroSeconds();
+	assert(frameMicroSeconds >= kMinMachineFrameMicroSeconds);	// tiny frames would make warp pay the per frame costs for almost no emulation
+	const auto startTime = std::chrono::steady_clock::now();
+	int noFrames = 0;
+
+	while (noFrames < kMaxWarpFrames && CodeAnalysis.Debugger.IsStopped() == false)
+	{
+		ExecuteFrame(frameMicroSeconds);
+		UpdateLoadingDetection();
+		noFrames++;
+
+		if (IsWarping() == false)	// loader finished
+			break;
+
+		const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+		if (elapsed.count() >= kWarpTimeBudgetMicroSeconds)
+			break;
+	}
+
+	NoWarpFrames = noFrames;
+}
+
+// only put a flag back if it's not been changed since loading started
+static void RestoreAnalysisFlag(bool& bFlag, bool bPreLoadingValue, bool bLoadingValue)
+{
+	if (bFlag == bLoadingValue)
+		bFlag = bPreLoadingValue;
+}
+
+// Start auto warp when the machine starts loading & stop once it's been quiet for a while
+void FEmuBase::UpdateLoadingDetection()
+{
+	// always check so the machine's per frame loading counters get reset
+	const bool bLoadingActivity = DetectLoading();
+	if (bAutoWarpWhenLoading && bLoadingActivity)
+		LoadingHoldFrames = kLoadingHoldFrames;
+	else if (LoadingHoldFrames > 0)
+		LoadingHoldFrames--;
+
+	const bool bLoading = bAutoWarpWhenLoading && LoadingHoldFrames > 0;
+	if (bLoading == bAutoWarpActive)
+		return;
+
+	bAutoWarpActive = bLoading;
+	if (bAutoWarpActive)
+	{
+		PreLoadingFlags.GetFromAnalysis(CodeAnalysis);
+		if (bAnalyseLoaders == false)
+			CodeAnalysis.SetAnalysisLevel(EAnalysisLevel::Off);
+		LoadingFlags.GetFromAnalysis(CodeAnalysis);
+	}
+	else
+	{
+		LoadingHoldFrames = 0;
+		RestoreAnalysisFlag(CodeAnalysis.bRegisterCodeExecution, PreLoadingFlags.bRegisterCodeExecution, LoadingFlags.bRegisterCodeExecution);
+		RestoreAnalysisFlag(CodeAnalysis.bRegisterDataAccesses, PreLoadingFlags.bRegisterDataAccesses, LoadingFlags.bRegisterDataAccesses);
+		RestoreAnalysisFlag(CodeAnalysis.bRegisterIOAccesses, PreLoadingFlags.bRegisterIOAccesses, LoadingFlags.bRegisterIOAccesses);
+		RestoreAnalysisFlag(CodeAnalysis.bRecordEvents, PreLoadingFlags.bRecordEvents, LoadingFlags.bRecordEvents);
+	}
+}
+
 bool FEmuBase::DrawDockingView()
 {
 	//SCOPE_PROFILE_CPU("UI", "DrawUI", ProfCols::UI);
@@ -378,6 +454,26 @@ void FEmuBase::OptionsMenu()
 	ImGui::MenuItem("ImPlot Demo", 0, &bShowImPlotDemo);
 #endif // NDEBUG
 
+	if (ImGui::BeginMenu("Analysis"))
+	{
+		const EAnalysisLevel level = CodeAnalysis.GetAnalysisLevel();
+		if (ImGui::MenuItem("Off", 0, level == EAnalysisLevel::Off))
+			CodeAnalysis.SetAnalysisLevel(EAnalysisLevel::Off);
+		if (ImGui::MenuItem("Code Coverage", 0, level == EAnalysisLevel::CodeCoverage))
+			CodeAnalysis.SetAnalysisLevel(EAnalysisLevel::CodeCoverage);
+		if (ImGui::MenuItem("Data Accesses", 0, level == EAnalysisLevel::DataAccess))
+			CodeAnalysis.SetAnalysisLevel(EAnalysisLevel::DataAccess);
+		if (ImGui::MenuItem("Full", 0, level == EAnalysisLevel::Full))
+			CodeAnalysis.SetAnalysisLevel(EAnalysisLevel::Full);
+
+		ImGui::Separator();
+		ImGui::MenuItem("Register Code Execution", 0, &CodeAnalysis.bRegisterCodeExecution);
+		ImGui::MenuItem("Register Data Accesses", 0, &CodeAnalysis.bRegisterDataAccesses);
+		ImGui::MenuItem("Register IO Accesses", 0, &CodeAnalysis.bRegisterIOAccesses);
+		ImGui::MenuItem("Record Events", 0, &CodeAnalysis.bRecordEvents);
+		ImGui::EndMenu();
+	}
+
 	OptionsMenuAdditions();
 }
 
@@ -393,6 +489,10 @@ void FEmuBase::SystemMenu()
 		Reset();
 	}
 
+	ImGui::MenuItem("Warp Mode", 0, &bWarpMode);
+	ImGui::MenuItem("Auto Warp When Loading", 0, &bAutoWarpWhenLoading);
+	ImGui::MenuItem("Analyse Loaders", 0, &bAnalyseLoaders, bAutoWarpWhenLoading);
+
 	SystemMenuAdditions();
 }
 
@@ -45,6 +45,21 @@ public:
 	virtual void    Reset();
 	virtual void	AppFocusCallback(int focused){}
 
+	// Run the machine with analysis for a period of time
+	virtual void	ExecuteFrame(uint32_t microSeconds) = 0;
+	virtual uint32_t	GetMachineFrameMicroSeconds() { return 20000; }	// 50Hz
+	void			ExecuteHostFrame(uint32_t microSeconds);
+
+	// Warp runs as many whole machine frames as fit in the host frame
+	bool			IsWarping() const { return bWarpMode || bAutoWarpActive; }
+	void			SetWarpMode(bool bWarp) { bWarpMode = bWarp; }
+	int				GetNoWarpFrames() const { return NoWarpFrames; }
+
+	// Auto warp while a loader is running
+	virtual bool	DetectLoading() { return false; }	// called after each machine frame, true if the machine is loading
+	void			SetAutoWarpWhenLoading(bool bAutoWarp) { bAutoWarpWhenLoading = bAutoWarp; }
+	bool			IsAutoWarping() const { return bAutoWarpActive; }
+
 	virtual bool	LoadLua(){ return false;}
 
 	virtual bool	NewGameFromSnapshot(const FGameSnapshot& gameConfig) = 0;
@@ -74,6 +89,7 @@ public:
 	FCodeAnalysisState&		GetCodeAnalysis() { return CodeAnalysis; }
 	const FGlobalConfig*	GetGlobalConfig() const { return pGlobalConfig; }
 	const FGameConfig*		GetGameConfig() const { return pCurrentGameConfig; }
+	const FGamesList&		GetGamesList() const { return GamesList; }
 
 protected:
 	void			FileMenu();
@@ -107,6 +123,38 @@ protected:
 	// Assembler Export
 	uint16_t			AssemblerExportStartAddress = 0x0000;
 	uint16_t			AssemblerExportEndAddress = 0xffff;
+
+	// Warp mode
+	static const int	kWarpTimeBudgetMicroSeconds = 12000;	// leaves time for the UI in a 60Hz host frame
+	static const int	kMaxWarpFrames = 200;
+	static const uint32_t	kMinMachineFrameMicroSeconds = 10000;	// machines run at 100Hz or less
+	bool				bWarpMode = false;
+	int					NoWarpFrames = 0;	// machine frames run in the last host frame
+
+	// Auto warp - loading is detected by the machine, analysis is dropped to the minimum unless loaders are analysed
+	void				UpdateLoadingDetection();
+	static const int	kLoadingHoldFrames = 25;	// frames without loading activity before the loader is considered finished
+	bool				bAutoWarpWhenLoading = false;
+	bool				bAnalyseLoaders = false;
+	bool				bAutoWarpActive = false;
+	int					LoadingHoldFrames = 0;
+	struct FLoadingAnalysisFlags
+	{
+		void	GetFromAnalysis(const FCodeAnalysisState& state)
+		{
+			bRegisterCodeExecution = state.bRegisterCodeExecution;
+			bRegisterDataAccesses = state.bRegisterDataAccesses;
+			bRegisterIOAccesses = state.bRegisterIOAccesses;
+			bRecordEvents = state.bRecordEvents;
+		}
+
+		bool	bRegisterCodeExecution = false;
+		bool	bRegisterDataAccesses = false;
+		bool	bRegisterIOAccesses = false;
+		bool	bRecordEvents = false;
+	};
+	FLoadingAnalysisFlags	PreLoadingFlags;	// analysis flags to restore when loading finishes
+	FLoadingAnalysisFlags	LoadingFlags;		// what they were set to for loading, any changed since are left alone
 public:
 	bool		bShowImGuiDemo = false;
 	bool		bShowImPlotDemo = false;
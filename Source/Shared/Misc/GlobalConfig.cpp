@@ -38,6 +38,8 @@ void FGlobalConfig::ReadFromJson(const json& jsonConfigFile)
 		FontSizePixels = jsonConfigFile["FontSizePixels"];
 	if (jsonConfigFile.contains("ImageScale"))
 		ImageScale = jsonConfigFile["ImageScale"];
+	if (jsonConfigFile.contains("SaveAnalysisJson"))
+		bSaveAnalysisJson = jsonConfigFile["SaveAnalysisJson"];
 	
     if (jsonConfigFile.contains("EnableLua"))
         bEnableLua = jsonConfigFile["EnableLua"];
@@ -74,6 +76,7 @@ void FGlobalConfig::WriteToJson(json& jsonConfigFile) const
 	jsonConfigFile["Font"] = Font;
 	jsonConfigFile["FontSizePixels"] = FontSizePixels;
 	jsonConfigFile["ImageScale"] = ImageScale;
+	jsonConfigFile["SaveAnalysisJson"] = bSaveAnalysisJson;
     jsonConfigFile["EnableLua"] = bEnableLua;
 	jsonConfigFile["EditLuaBaseFiles"] = bEditLuaBaseFiles;
 
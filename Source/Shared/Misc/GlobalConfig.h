@@ -21,6 +21,7 @@ struct FGlobalConfig
 	std::string			Font = ""; // if no font is specified the default font will be used
 	uint32_t			FontSizePixels = 13;
 	int					ImageScale = 1;
+	bool				bSaveAnalysisJson = false;	// also export the analysis as Json when saving
     
 	// Lua config
     bool                bEnableLua = false;
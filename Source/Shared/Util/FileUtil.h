@@ -39,6 +39,10 @@ bool SaveTextFile(const char* pFileName, const char* pText);
 void *LoadBinaryFile(const char *pFilename, size_t &byteCount);
 bool SaveBinaryFile(const char *pFilename, const void * pData, size_t byteCount);
 
+// Read only memory mapped file - platform specific
+const void *MapFile(const char *pFilename, size_t &byteCount);
+void UnmapFile(const void *pData, size_t byteCount);
+
 void WriteStringToFile(const std::string& str, FILE* fp);
 void ReadStringFromFile(std::string& str, FILE* fp);
 std::string MakeHexString(uint16_t val);
@@ -3,6 +3,7 @@
 #include <imgui.h>
 #include <ImGuiSupport/ImGuiTexture.h>
 #include <ImGuiSupport/ImGuiScaling.h>
+#include <algorithm>
 #include <cstdint>
 #include <vector>
 
@@ -292,12 +293,14 @@ void InitCharacterSets()
 	g_CharacterMaps.clear();
 }
 
+void UpdateDynamicCharacterSetImage(FCodeAnalysisState& state, FCharacterSet& characterSet);
+
 void UpdateCharacterSets(FCodeAnalysisState& state)
 {
 	for (auto& it : g_CharacterSets)
 	{
 		if(it->Params.bDynamic)
-			UpdateCharacterSetImage(state, *it);
+			UpdateDynamicCharacterSetImage(state, *it);
 	}
 }
 
@@ -330,21 +333,36 @@ FCharacterSet* GetCharacterSetFromAddress(FAddressRef address)
 	return nullptr;
 }
 
-void DrawCharacterSetImage2BppCPC(FCodeAnalysisState& state, FCharacterSet& characterSet, uint16_t addr)
+// bytes each character takes up in memory
+static int GetCharacterStride(const FCharSetCreateParams& params)
 {
-	for (int charNo = 0; charNo < 256; charNo++)
+	switch (params.BitmapFormat)
 	{
-		const uint8_t* pCharData = state.CPUInterface->GetMemPtr(addr);
-		const int xp = (charNo & 15) * 8;
-		const int yp = (charNo >> 4) * 8;
-
-		const uint32_t* pPaletteColours = GetPaletteFromPaletteNo(characterSet.Params.PaletteNo);
-		characterSet.Image->Draw2BppImageAt(pCharData, xp, yp, 8, 8, pPaletteColours);
-		addr += 16; // 2bpp * 8
+	case EBitmapFormat::Bitmap_1Bpp:
+	{
+		int stride = params.MaskInfo == EMaskInfo::None ? 8 : 16;
+		if (params.ColourInfo == EColourInfo::InterleavedPre || params.ColourInfo == EColourInfo::InterleavedPost)
+			stride++;
+		return stride;
+	}
+	case EBitmapFormat::ColMap2Bpp_CPC:
+		return 16;	// 2bpp * 8
+	default:
+		return 0;
 	}
 }
 
-void DrawCharacterSetImage1Bpp(FCodeAnalysisState& state, FCharacterSet& characterSet, uint16_t addr)
+void DrawCharacter2BppCPC(FCodeAnalysisState& state, FCharacterSet& characterSet, int charNo, uint16_t addr)
+{
+	const uint8_t* pCharData = state.CPUInterface->GetMemPtr(addr);
+	const int xp = (charNo & 15) * 8;
+	const int yp = (charNo >> 4) * 8;
+
+	const uint32_t* pPaletteColours = GetPaletteFromPaletteNo(characterSet.Params.PaletteNo);
+	characterSet.Image->Draw2BppImageAt(pCharData, xp, yp, 8, 8, pPaletteColours);
+}
+
+void DrawCharacter1Bpp(FCodeAnalysisState& state, FCharacterSet& characterSet, int charNo, uint16_t addr)
 {
 	// TODO: these are speccy specific, put in config
 	const uint8_t brightMask = 1 << 6;
@@ -353,71 +371,134 @@ void DrawCharacterSetImage1Bpp(FCodeAnalysisState& state, FCharacterSet& charact
 	const uint8_t paperMask = 7;
 	const uint8_t paperShift = 3;
 
-	for (int charNo = 0; charNo < 256; charNo++)
-	{
-		const uint8_t* pCharData = state.CPUInterface->GetMemPtr(addr);
-		const int xp = (charNo & 15) * 8;
-		const int yp = (charNo >> 4) * 8;
-		uint32_t cols[2] = { 0,0xffffffff };
-		uint8_t colAttr = 0xff;
-		uint8_t charPix[8];
-		uint8_t charMask[8];
-
-		if (characterSet.Params.ColourInfo == EColourInfo::InterleavedPre)
-			colAttr = state.ReadByte(addr++);
-
-		for (int i = 0; i < 8; i++)
-		{
-			if (characterSet.Params.MaskInfo == EMaskInfo::InterleavedBytesMP)
-				charMask[i] = state.ReadByte(addr++);
-			charPix[i] = state.ReadByte(addr++);
-			if (characterSet.Params.MaskInfo == EMaskInfo::InterleavedBytesPM)
-				charMask[i] = state.ReadByte(addr++);
-		}
+	const int xp = (charNo & 15) * 8;
+	const int yp = (charNo >> 4) * 8;
+	uint32_t cols[2] = { 0,0xffffffff };
+	uint8_t colAttr = 0xff;
+	uint8_t charPix[8];
+	uint8_t charMask[8];
 
-		// Get colour from colour info
-		switch (characterSet.Params.ColourInfo)
-		{
-            case EColourInfo::MemoryLUT:
-                colAttr = state.ReadByte(characterSet.Params.AttribsAddress.Address + charNo);
-                break;
-            case EColourInfo::InterleavedPost:
-                colAttr = state.ReadByte(addr++);
-                break;
-            default:
-                break;
-		}
+	if (characterSet.Params.ColourInfo == EColourInfo::InterleavedPre)
+		colAttr = state.ReadByte(addr++);
 
-		if (colAttr != 0xff)
-		{
-			// get ink & paper
-			const bool bBright = !!(colAttr & brightMask);
-			cols[0] = GetColFromAttr((colAttr >> paperShift) & paperMask, characterSet.Params.ColourLUT, bBright);
-			cols[1] = GetColFromAttr((colAttr >> inkShift) & inkMask, characterSet.Params.ColourLUT, bBright);
-		}
+	for (int i = 0; i < 8; i++)
+	{
+		if (characterSet.Params.MaskInfo == EMaskInfo::InterleavedBytesMP)
+			charMask[i] = state.ReadByte(addr++);
+		charPix[i] = state.ReadByte(addr++);
+		if (characterSet.Params.MaskInfo == EMaskInfo::InterleavedBytesPM)
+			charMask[i] = state.ReadByte(addr++);
+	}
 
-		characterSet.Image->Draw1BppImageAt(charPix, xp, yp, 8, 8, cols);
+	// Get colour from colour info
+	switch (characterSet.Params.ColourInfo)
+	{
+        case EColourInfo::MemoryLUT:
+            colAttr = state.ReadByte(characterSet.Params.AttribsAddress.Address + charNo);
+            break;
+        case EColourInfo::InterleavedPost:
+            colAttr = state.ReadByte(addr++);
+            break;
+        default:
+            break;
 	}
+
+	if (colAttr != 0xff)
+	{
+		// get ink & paper
+		const bool bBright = !!(colAttr & brightMask);
+		cols[0] = GetColFromAttr((colAttr >> paperShift) & paperMask, characterSet.Params.ColourLUT, bBright);
+		cols[1] = GetColFromAttr((colAttr >> inkShift) & inkMask, characterSet.Params.ColourLUT, bBright);
+	}
+
+	characterSet.Image->Draw1BppImageAt(charPix, xp, yp, 8, 8, cols);
 }
 
-// This function assumes the data is mapped in memory
-void UpdateCharacterSetImage(FCodeAnalysisState& state, FCharacterSet& characterSet)
+void DrawCharacter(FCodeAnalysisState& state, FCharacterSet& characterSet, int charNo)
 {
-	uint16_t addr = characterSet.Params.Address.Address;
-
-	characterSet.Image->Clear(0);	// clear first
+	const uint16_t addr = characterSet.Params.Address.Address + charNo * GetCharacterStride(characterSet.Params);
 
 	switch (characterSet.Params.BitmapFormat)
 	{
 	case EBitmapFormat::Bitmap_1Bpp:
-		DrawCharacterSetImage1Bpp(state, characterSet, addr);
+		DrawCharacter1Bpp(state, characterSet, charNo, addr);
 		break;
 	case EBitmapFormat::ColMap2Bpp_CPC:
-		DrawCharacterSetImage2BppCPC(state, characterSet, addr);
+		DrawCharacter2BppCPC(state, characterSet, charNo, addr);
 		break;
     default:
         break;
 	}
+}
+
+// pages the character data & attributes are read from
+static void GetCharacterSetSourcePageIds(FCodeAnalysisState& state, const FCharSetCreateParams& params, std::vector<int16_t>& outPageIds)
+{
+	auto addPages = [&state, &outPageIds](int addr, int noBytes)
+	{
+		const int endAddr = std::min(addr + noBytes, 1 << 16);
+		for (int pageAddr = addr & ~FCodeAnalysisPage::kPageMask; pageAddr < endAddr; pageAddr += FCodeAnalysisPage::kPageSize)
+			outPageIds.push_back(state.GetAddressReadPageId((uint16_t)pageAddr));
+	};
+
+	outPageIds.clear();
+	addPages(params.Address.Address, GetCharacterStride(params) * 256);
+	if (params.ColourInfo == EColourInfo::MemoryLUT)
+		addPages(params.AttribsAddress.Address, 256);
+}
+
+// This function assumes the data is mapped in memory
+void UpdateCharacterSetImage(FCodeAnalysisState& state, FCharacterSet& characterSet)
+{
+	characterSet.Image->Clear(0);	// clear first
+
+	for (int charNo = 0; charNo < 256; charNo++)
+		DrawCharacter(state, characterSet, charNo);
+
+	characterSet.Image->UpdateTexture();
+	characterSet.WriteToken = state.GetWriteToken();
+	GetCharacterSetSourcePageIds(state, characterSet.Params, characterSet.SourcePageIds);
+}
+
+// Redraw the characters whose data or attribute has been written to since the last draw
+void UpdateDynamicCharacterSetImage(FCodeAnalysisState& state, FCharacterSet& characterSet)
+{
+	std::vector<int16_t> sourcePageIds;
+	GetCharacterSetSourcePageIds(state, characterSet.Params, sourcePageIds);
+	if (sourcePageIds != characterSet.SourcePageIds)
+	{
+		UpdateCharacterSetImage(state, characterSet);
+		return;
+	}
+
+	const uint32_t writeToken = characterSet.WriteToken;
+	characterSet.WriteToken = state.GetWriteToken();
+
+	const FCharSetCreateParams& params = characterSet.Params;
+	const int stride = GetCharacterStride(params);
+	const bool bAttribLUT = params.ColourInfo == EColourInfo::MemoryLUT;
+	const bool bCharDataWritten = state.HasMemoryBeenWrittenSince(params.Address.Address, stride * 256, writeToken);
+	const bool bAttribsWritten = bAttribLUT && state.HasMemoryBeenWrittenSince(params.AttribsAddress.Address, 256, writeToken);
+	if (stride == 0 || (bCharDataWritten == false && bAttribsWritten == false))
+		return;
+
+	uint32_t* pPixels = characterSet.Image->GetPixelBuffer();
+	const int imageWidth = characterSet.Image->GetWidth();
+	for (int charNo = 0; charNo < 256; charNo++)
+	{
+		const uint16_t charAddr = params.Address.Address + charNo * stride;
+		const bool bCharWritten = (bCharDataWritten && state.HasMemoryBeenWrittenSince(charAddr, stride, writeToken))
+			|| (bAttribsWritten && state.HasMemoryBeenWrittenSince((uint16_t)(params.AttribsAddress.Address + charNo), 1, writeToken));
+		if (bCharWritten == false)
+			continue;
+
+		// clear the character's cell as transparent pixels aren't drawn
+		uint32_t* pCell = pPixels + ((charNo & 15) * 8) + ((charNo >> 4) * 8 * imageWidth);
+		for (int y = 0; y < 8; y++)
+			memset(pCell + (y * imageWidth), 0, 8 * sizeof(uint32_t));
+
+		DrawCharacter(state, characterSet, charNo);
+	}
 
 	characterSet.Image->UpdateTexture();
 }
@@ -583,6 +664,19 @@ const FPaletteEntry* GetPaletteEntry(int paletteNo)
 	return nullptr;
 }
 
+const uint32_t* GetPaletteColours(int& outNoColours)
+{
+	outNoColours = (int)g_PaletteColours.size();
+	return g_PaletteColours.data();
+}
+
+// replace the whole palette store - used by the binary loader
+void SetPaletteStore(const uint32_t* pColours, int noColours, const FPaletteEntry* pEntries, int noEntries)
+{
+	g_PaletteColours.assign(pColours, pColours + noColours);
+	g_Palettes.assign(pEntries, pEntries + noEntries);
+}
+
 #include <json.hpp>
 
 const char* kPaletteColours = "PaletteColours";
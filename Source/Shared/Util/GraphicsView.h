@@ -2,6 +2,7 @@
 
 #include <cstdint>
 #include <cstring>
+#include <vector>
 #include <json_fwd.hpp>
 #include "CodeAnalyser/CodeAnalyserTypes.h"
 
@@ -113,6 +114,10 @@ struct FCharacterSet
 	FCharSetCreateParams	Params;
 
 	FGraphicsView*	Image = nullptr;	
+
+	// dynamic sets only redraw the characters written to since they were last drawn
+	uint32_t				WriteToken = 0;
+	std::vector<int16_t>	SourcePageIds;	// pages mapped in when drawn, remapping redraws the lot
 };
 
 // Character Maps
@@ -165,3 +170,5 @@ int GetNoPaletteEntries(void);
 const FPaletteEntry* GetPaletteEntry(int paletteNo);
 void SavePalettesToJson(nlohmann::json& jsonDoc);
 void LoadPalettesFromJson(const nlohmann::json& jsonDoc);
+const uint32_t* GetPaletteColours(int& outNoColours);
+void SetPaletteStore(const uint32_t* pColours, int noColours, const FPaletteEntry* pEntries, int noEntries);
@@ -2,6 +2,9 @@
 
 #include <string.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 bool CreateDir(const char* osDir)
 {
@@ -25,6 +28,34 @@ char GetDirSep()
 	return '/';
 }
 
+const void* MapFile(const char* pFilename, size_t& byteCount)
+{
+	const int fd = open(pFilename, O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	struct stat st = { 0 };
+	if (fstat(fd, &st) == -1 || st.st_size == 0)
+	{
+		close(fd);
+		return nullptr;
+	}
+
+	void* pData = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);	// the mapping keeps the file open
+	if (pData == MAP_FAILED)
+		return nullptr;
+
+	byteCount = st.st_size;
+	return pData;
+}
+
+void UnmapFile(const void* pData, size_t byteCount)
+{
+	if (pData != nullptr)
+		munmap(const_cast<void*>(pData), byteCount);
+}
+
 void FileInit(void)
 {
 }
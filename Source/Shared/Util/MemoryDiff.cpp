@@ -0,0 +1,86 @@
+#include "MemoryDiff.h"
+
+#include <algorithm>
+#include <string.h>
+
+static const size_t kDiffBlockSize = 64;
+static const size_t kDiffBlockWords = kDiffBlockSize / sizeof(uint64_t);
+
+static bool HasBlockChanged(const uint8_t* pOld, const uint8_t* pNew)
+{
+	uint64_t diff = 0;
+	for (size_t wordNo = 0; wordNo < kDiffBlockWords; wordNo++)
+	{
+		uint64_t oldWord, newWord;
+		memcpy(&oldWord, pOld + wordNo * sizeof(uint64_t), sizeof(uint64_t));
+		memcpy(&newWord, pNew + wordNo * sizeof(uint64_t), sizeof(uint64_t));
+		diff |= oldWord ^ newWord;
+	}
+	return diff != 0;
+}
+
+// extend the last range if this run joins on to it
+static void AddChangedRun(std::vector<FMemoryDiffRange>& ranges, size_t start, size_t end, size_t firstNewRange)
+{
+	if (ranges.size() > firstNewRange && ranges.back().Start + ranges.back().Size == start)
+		ranges.back().Size += (uint32_t)(end - start);
+	else
+		ranges.push_back({ (uint32_t)start, (uint32_t)(end - start) });
+}
+
+static void DiffBytes(const uint8_t* pOld, const uint8_t* pNew, size_t start, size_t end, std::vector<FMemoryDiffRange>& ranges, size_t firstNewRange)
+{
+	size_t offset = start;
+	while (offset < end)
+	{
+		if (pOld[offset] == pNew[offset])
+		{
+			offset++;
+			continue;
+		}
+
+		const size_t runStart = offset;
+		while (offset < end && pOld[offset] != pNew[offset])
+			offset++;
+		AddChangedRun(ranges, runStart, offset, firstNewRange);
+	}
+}
+
+void DiffMemory(const uint8_t* pOld, const uint8_t* pNew, size_t size, std::vector<FMemoryDiffRange>& outRanges)
+{
+	const size_t firstNewRange = outRanges.size();
+	const size_t blocksEnd = size - (size % kDiffBlockSize);
+
+	for (size_t blockStart = 0; blockStart < blocksEnd; blockStart += kDiffBlockSize)
+	{
+		if (HasBlockChanged(pOld + blockStart, pNew + blockStart))
+			DiffBytes(pOld, pNew, blockStart, blockStart + kDiffBlockSize, outRanges, firstNewRange);
+	}
+
+	DiffBytes(pOld, pNew, blocksEnd, size, outRanges, firstNewRange);
+}
+
+void ExcludeFromDiffRanges(std::vector<FMemoryDiffRange>& ranges, uint32_t excludeStart, uint32_t excludeSize)
+{
+	const uint32_t excludeEnd = excludeStart + excludeSize;
+	std::vector<FMemoryDiffRange> remaining;
+	remaining.reserve(ranges.size() + 1);
+
+	for (const FMemoryDiffRange& range : ranges)
+	{
+		const uint32_t rangeEnd = range.Start + range.Size;
+		if (rangeEnd <= excludeStart || range.Start >= excludeEnd)
+		{
+			remaining.push_back(range);
+			continue;
+		}
+
+		// keep what's either side
+		if (range.Start < excludeStart)
+			remaining.push_back({ range.Start, excludeStart - range.Start });
+		if (rangeEnd > excludeEnd)
+			remaining.push_back({ excludeEnd, rangeEnd - excludeEnd });
+	}
+
+	ranges = std::move(remaining);
+}
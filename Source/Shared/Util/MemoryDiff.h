@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// run of changed bytes
+struct FMemoryDiffRange
+{
+	uint32_t	Start = 0;
+	uint32_t	Size = 0;
+
+	bool operator==(const FMemoryDiffRange& other) const { return Start == other.Start && Size == other.Size; }
+};
+
+// Find the runs of bytes that differ between two blocks of memory, ranges are added in address order
+// Memory is compared 64 bytes at a time with word wide XORs the compiler can vectorise, unchanged blocks are skipped.
+void DiffMemory(const uint8_t* pOld, const uint8_t* pNew, size_t size, std::vector<FMemoryDiffRange>& outRanges);
+
+// Remove the parts of the ranges that fall inside an excluded range
+void ExcludeFromDiffRanges(std::vector<FMemoryDiffRange>& ranges, uint32_t excludeStart, uint32_t excludeSize);
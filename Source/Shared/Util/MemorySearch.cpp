@@ -0,0 +1,107 @@
+#include "MemorySearch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <string.h>
+
+// below this it's quicker to search on one thread than start workers
+static const size_t kParallelSearchBytes = 1024 * 1024;
+
+// 0 & ff fill a lot of memory so make poor bytes to scan for
+static bool IsCommonByte(uint8_t byte)
+{
+	return byte == 0x00 || byte == 0xff;
+}
+
+static bool MatchesAt(const uint8_t* pMemory, const FMemoryPattern& pattern)
+{
+	if (pattern.pMask == nullptr)
+		return memcmp(pMemory, pattern.pBytes, pattern.Size) == 0;
+
+	for (size_t byteNo = 0; byteNo < pattern.Size; byteNo++)
+	{
+		const uint8_t mask = pattern.pMask[byteNo];
+		if ((pMemory[byteNo] & mask) != (pattern.pBytes[byteNo] & mask))
+			return false;
+	}
+	return true;
+}
+
+void FindPatternMatches(const uint8_t* pMemory, size_t memorySize, const FMemoryPattern& pattern, std::vector<uint32_t>& outOffsets)
+{
+	if (pattern.Size == 0 || pattern.Size > memorySize)
+		return;
+
+	const size_t noStartOffsets = memorySize - pattern.Size + 1;
+
+	// pick a fully significant byte to scan for
+	int anchor = -1;
+	for (size_t byteNo = 0; byteNo < pattern.Size; byteNo++)
+	{
+		if (pattern.pMask != nullptr && pattern.pMask[byteNo] != 0xff)
+			continue;
+		if (anchor == -1 || (IsCommonByte(pattern.pBytes[anchor]) && IsCommonByte(pattern.pBytes[byteNo]) == false))
+			anchor = (int)byteNo;
+	}
+
+	// no fixed bytes - try every position
+	if (anchor == -1)
+	{
+		for (size_t offset = 0; offset < noStartOffsets; offset++)
+		{
+			if (MatchesAt(pMemory + offset, pattern))
+				outOffsets.push_back((uint32_t)offset);
+		}
+		return;
+	}
+
+	const uint8_t anchorByte = pattern.pBytes[anchor];
+	const uint8_t* pScan = pMemory + anchor;
+	const uint8_t* pScanEnd = pScan + noStartOffsets;
+	while (pScan < pScanEnd)
+	{
+		const uint8_t* pFound = (const uint8_t*)memchr(pScan, anchorByte, pScanEnd - pScan);
+		if (pFound == nullptr)
+			break;
+
+		const size_t offset = (pFound - pMemory) - anchor;
+		if (MatchesAt(pMemory + offset, pattern))
+			outOffsets.push_back((uint32_t)offset);
+		pScan = pFound + 1;
+	}
+}
+
+void FindPatternMatchesInBlocks(const std::vector<FMemoryBlock>& blocks, const FMemoryPattern& pattern, std::vector<std::vector<uint32_t>>& outMatches)
+{
+	outMatches.clear();
+	outMatches.resize(blocks.size());
+
+	size_t totalBytes = 0;
+	for (const FMemoryBlock& block : blocks)
+		totalBytes += block.Size;
+
+	const size_t noThreads = std::min<size_t>(std::thread::hardware_concurrency(), blocks.size());
+	if (totalBytes < kParallelSearchBytes || noThreads < 2)
+	{
+		for (size_t blockNo = 0; blockNo < blocks.size(); blockNo++)
+			FindPatternMatches(blocks[blockNo].pMemory, blocks[blockNo].Size, pattern, outMatches[blockNo]);
+		return;
+	}
+
+	// each worker takes the next block until they're all done, results go in the block's own list
+	std::atomic<size_t> nextBlock(0);
+	auto searchBlocks = [&]()
+	{
+		for (size_t blockNo = nextBlock++; blockNo < blocks.size(); blockNo = nextBlock++)
+			FindPatternMatches(blocks[blockNo].pMemory, blocks[blockNo].Size, pattern, outMatches[blockNo]);
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t threadNo = 1; threadNo < noThreads; threadNo++)
+		workers.emplace_back(searchBlocks);
+	searchBlocks();
+
+	for (std::thread& worker : workers)
+		worker.join();
+}
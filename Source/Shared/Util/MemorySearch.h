@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Byte pattern to search for
+// Memory matches where (memory & mask) == (pattern & mask), a mask byte of 0 is a wildcard.
+// A null mask means every bit is significant.
+struct FMemoryPattern
+{
+	const uint8_t*	pBytes = nullptr;
+	const uint8_t*	pMask = nullptr;
+	size_t			Size = 0;
+};
+
+struct FMemoryBlock
+{
+	const uint8_t*	pMemory = nullptr;
+	size_t			Size = 0;
+};
+
+// Find every offset in a block of memory the pattern matches at
+// Candidates are found with memchr on one fixed byte of the pattern, then the rest of the pattern is compared.
+void FindPatternMatches(const uint8_t* pMemory, size_t memorySize, const FMemoryPattern& pattern, std::vector<uint32_t>& outOffsets);
+
+// Search several blocks, outMatches gets a list of offsets per block
+// Large searches are split across worker threads.
+void FindPatternMatchesInBlocks(const std::vector<FMemoryBlock>& blocks, const FMemoryPattern& pattern, std::vector<std::vector<uint32_t>>& outMatches);
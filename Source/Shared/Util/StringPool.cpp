@@ -0,0 +1,57 @@
+#include "StringPool.h"
+
+#include <string.h>
+
+FStringHandle FStringPool::Intern(std::string_view str)
+{
+	if (str.empty())
+		return 0;
+
+	const auto it = Lookup.find(str);
+	if (it != Lookup.end())
+		return it->second;
+
+	const char* pStr = Store(str);
+	const FStringHandle handle = (FStringHandle)Strings.size();
+	Strings.push_back(pStr);
+	Lookup[std::string_view(pStr, str.size())] = handle;
+	return handle;
+}
+
+FStringHandle FStringPool::Find(std::string_view str) const
+{
+	const auto it = Lookup.find(str);
+	return it != Lookup.end() ? it->second : 0;
+}
+
+void FStringPool::Clear()
+{
+	Blocks.clear();
+	BlockUsed = 0;
+	BlockBytes = 0;
+	Strings.clear();
+	Lookup.clear();
+
+	Strings.push_back("");	// handle 0
+}
+
+// copy the string into a block, null terminated
+const char* FStringPool::Store(std::string_view str)
+{
+	const size_t size = str.size() + 1;
+
+	if (Blocks.empty() || BlockUsed + size > kBlockSize)
+	{
+		// big strings get a block of their own
+		const size_t blockSize = size > kBlockSize ? size : kBlockSize;
+		Blocks.emplace_back(new char[blockSize]);
+		BlockUsed = 0;
+		BlockBytes += blockSize;
+	}
+
+	char* pDest = Blocks.back().get() + BlockUsed;
+	memcpy(pDest, str.data(), str.size());
+	pDest[str.size()] = 0;
+	BlockUsed += size;
+	return pDest;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+typedef uint32_t FStringHandle;	// 0 is the empty string
+
+// Interned string table
+// Each distinct string is stored once in large blocks and referred to by a handle.
+// Strings are never freed individually, the whole pool is cleared at once.
+class FStringPool
+{
+public:
+	FStringPool() { Clear(); }
+
+	FStringHandle	Intern(std::string_view str);
+	FStringHandle	Find(std::string_view str) const;	// returns 0 if the string isn't in the pool
+	const char*		Get(FStringHandle handle) const { return Strings[handle]; }
+
+	void			Clear();
+	size_t			GetNoStrings() const { return Strings.size(); }
+	size_t			GetMemoryUsage() const { return BlockBytes; }
+
+private:
+	const char*		Store(std::string_view str);
+
+	static const size_t kBlockSize = 64 * 1024;
+
+	std::vector<std::unique_ptr<char[]>>	Blocks;
+	size_t							BlockUsed = 0;
+	size_t							BlockBytes = 0;
+	std::vector<const char*>		Strings;	// indexed by handle
+	std::unordered_map<std::string_view, FStringHandle>	Lookup;	// keys point into the blocks
+};
@@ -100,6 +100,39 @@ char GetDirSep()
 	return '\\';
 }
 
+const void* MapFile(const char* pFilename, size_t& byteCount)
+{
+	HANDLE hFile = CreateFileA(pFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return nullptr;
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(hFile, &fileSize) == FALSE || fileSize.QuadPart == 0)
+	{
+		CloseHandle(hFile);
+		return nullptr;
+	}
+
+	HANDLE hMapping = CreateFileMappingA(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	CloseHandle(hFile);
+	if (hMapping == NULL)
+		return nullptr;
+
+	const void* pData = MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(hMapping);	// the view keeps the mapping open
+	if (pData == nullptr)
+		return nullptr;
+
+	byteCount = (size_t)fileSize.QuadPart;
+	return pData;
+}
+
+void UnmapFile(const void* pData, size_t byteCount)
+{
+	if (pData != nullptr)
+		UnmapViewOfFile(pData);
+}
+
 
 #if 0
 std::string g_BrowserURL;
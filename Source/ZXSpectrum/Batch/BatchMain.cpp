@@ -0,0 +1,165 @@
+// Headless batch runner
+// Loads a game or snapshot, runs it for a number of frames with full analysis and saves the results
+// Usage: SpectrumAnalyserBatch [-128] [-game <project> | -snapshot <name>] [-frames <n>] [-json <file>]
+
+#include "../SpectrumEmu.h"
+#include "CodeAnalyser/CodeAnalysisJson.h"
+#include "Debug/DebugLog.h"
+#include "Misc/GamesList.h"
+
+#include <imgui.h>
+#include <cstdlib>
+#include <climits>
+
+static const char* kBatchUsage = "Usage: SpectrumAnalyserBatch [-128] [-game <project> | -snapshot <name>] [-frames <n>] [-json <file>]";
+
+struct FSpectrumBatchConfig : public FSpectrumLaunchConfig
+{
+	void ParseCommandline(int argc, char** argv) override;
+
+	std::string		SnapshotName;
+	std::string		JsonExportFile;
+	int				NoFrames = 500;	// 10 seconds of machine time
+	bool			bValidArgs = true;
+};
+
+void FSpectrumBatchConfig::ParseCommandline(int argc, char** argv)
+{
+	FSpectrumLaunchConfig::ParseCommandline(argc, argv);	// call base class
+
+	std::vector<std::string> argList;
+	for (int arg = 0; arg < argc; arg++)
+	{
+		argList.emplace_back(argv[arg]);
+	}
+
+	auto argIt = argList.begin();
+	argIt++;	// skip exe name
+	while (argIt != argList.end())
+	{
+		if (*argIt == std::string("-snapshot"))
+		{
+			if (++argIt == argList.end())
+			{
+				LOGERROR("-snapshot : No snapshot specified");
+				break;
+			}
+			SnapshotName = *argIt;
+		}
+		else if (*argIt == std::string("-frames"))
+		{
+			if (++argIt == argList.end())
+			{
+				LOGERROR("-frames : No frame count specified");
+				bValidArgs = false;
+				break;
+			}
+			char* pEnd = nullptr;
+			const long frames = strtol(argIt->c_str(), &pEnd, 10);
+			if (pEnd == argIt->c_str() || *pEnd != 0 || frames <= 0 || frames > INT_MAX)
+			{
+				LOGERROR("-frames : '%s' is not a positive frame count", argIt->c_str());
+				bValidArgs = false;
+				break;
+			}
+			NoFrames = (int)frames;
+		}
+		else if (*argIt == std::string("-json"))
+		{
+			if (++argIt == argList.end())
+			{
+				LOGERROR("-json : No file specified");
+				break;
+			}
+			JsonExportFile = *argIt;
+		}
+
+		++argIt;
+	}
+}
+
+// there's no window in batch builds
+void SetWindowTitle(const char* pTitle) {}
+void SetWindowIcon(const char* pIconFile) {}
+
+int main(int argc, char** argv)
+{
+	FSpectrumBatchConfig config;
+	config.ParseCommandline(argc, argv);
+	if (config.bValidArgs == false)
+	{
+		LOGERROR("%s", kBatchUsage);
+		return 1;
+	}
+
+	// Nothing gets drawn but the emulator UI code expects a context
+	ImGui::CreateContext();
+	ImGui::GetIO().IniFilename = nullptr;
+
+	// Without a specific game the emulator will load the last game, stop it doing that
+	const bool bLoadProject = config.SpecificGame.empty() == false;
+	if (bLoadProject == false)
+		config.SpecificGame = "ROM";
+
+	FSpectrumEmu* pEmu = new FSpectrumEmu;
+	if (pEmu->Init(config) == false)
+	{
+		LOGERROR("Failed to initialise emulator");
+		delete pEmu;
+		ImGui::DestroyContext();
+		return 1;
+	}
+
+	int retVal = 0;
+
+	if (bLoadProject == false && config.SnapshotName.empty() == false)
+	{
+		const FGameSnapshot* pSnapshot = pEmu->GetGamesList().GetGame(config.SnapshotName.c_str());
+		if (pSnapshot == nullptr || pEmu->NewGameFromSnapshot(*pSnapshot) == false)
+		{
+			LOGERROR("Failed to load snapshot '%s'", config.SnapshotName.c_str());
+			retVal = 1;
+		}
+	}
+
+	if (retVal == 0)
+	{
+		FDebugger& debugger = pEmu->GetCodeAnalysis().Debugger;
+		int framesLeft = config.NoFrames;
+
+		debugger.Continue();
+		while (framesLeft > 0)
+		{
+			framesLeft -= pEmu->RunMachineFrames(framesLeft);
+
+			// nobody is there to resume from a breakpoint so log it and carry on
+			if (debugger.IsStopped())
+			{
+				LOGINFO("Stopped at 0x%04X, %d frames remaining - continuing", debugger.GetPC().Address, framesLeft);
+				debugger.Continue();
+			}
+		}
+
+		LOGINFO("Ran %d frames", config.NoFrames);
+
+		if (pEmu->SaveCurrentGameData() == false)
+		{
+			LOGERROR("Failed to save game data");
+			retVal = 1;
+		}
+
+		if (config.JsonExportFile.empty() == false)
+		{
+			if (ExportAnalysisJson(pEmu->GetCodeAnalysis(), config.JsonExportFile.c_str()) == false)
+			{
+				LOGERROR("Failed to export analysis to '%s'", config.JsonExportFile.c_str());
+				retVal = 1;
+			}
+		}
+	}
+
+	pEmu->Shutdown();
+	delete pEmu;
+	ImGui::DestroyContext();
+	return retVal;
+}
@@ -834,6 +834,7 @@ bool LoadMachineState(FSpectrumEmu* pSpectrumEmu, FILE* fp)
 	ay38910_snapshot_onload(&im.ay, &sys->ay);
 	mem_snapshot_onload(&im.mem, sys);
 	*sys = im;	// copy across new state
+	pSpectrumEmu->GetCodeAnalysis().Debugger.GetReverseExecution().Reset();
 
 	// Set code analysis banks
 	if (sys->type == ZX_TYPE_128)
@@ -349,6 +349,7 @@ void FormatSmallPlatformMemory(FSpectrumEmu* pEmu, int platformNo)
 		snprintf(labelName,32, "SmallPlatform_%d", platformNo);
 		FLabelInfo* pLabel = AddLabel(state, kPlatformAddr, labelName, ELabelType::Data);
 		pLabel->Global = true;
+		state.UpdateGlobalLabelIndex(state.AddressRefFromPhysicalAddress(kPlatformAddr));
 	}
 	// Format Mask - 6 bytes bitmap
 	FDataFormattingOptions format;
@@ -377,6 +378,7 @@ void FormatSmallPlatformMemory(FSpectrumEmu* pEmu, int platformNo)
 		snprintf(labelName,32, "SmallPlatform_%d_Attributes", platformNo);
 		FLabelInfo* pLabel = AddLabel(state, kPlatformAddr - noPlatformChars, labelName, ELabelType::Data);
 		pLabel->Global = true;
+		state.UpdateGlobalLabelIndex(state.AddressRefFromPhysicalAddress(kPlatformAddr - noPlatformChars));
 
 		format.StartAddress = state.AddressRefFromPhysicalAddress(kPlatformAddr - noPlatformChars);
 
@@ -400,6 +402,7 @@ void FormatSmallPlatformMemory(FSpectrumEmu* pEmu, int platformNo)
 		snprintf(labelName,32, "SmallPlatform_%d_Char_%d", platformNo, platChar);
 		FLabelInfo* pLabel = AddLabel(state, platCharAddr, labelName, ELabelType::Data);
 		pLabel->Global = true;
+		state.UpdateGlobalLabelIndex(state.AddressRefFromPhysicalAddress(platCharAddr));
 
 		format.SetupForBitmap(state.AddressRefFromPhysicalAddress(platCharAddr), 8, 8, 1);
 		FormatData(state, format);
@@ -420,6 +423,7 @@ void FormatBigPlatformMemory(FSpectrumEmu* pEmu, int platformNo)
 	snprintf(labelName,32, "BigPlatform_%d", platformNo);
 	FLabelInfo* pLabel = AddLabel(state, kBigPlatformData, labelName, ELabelType::Data);
 	pLabel->Global = true;
+	state.UpdateGlobalLabelIndex(state.AddressRefFromPhysicalAddress(kBigPlatformData));
 
 	// Format Charmap 2x2
 	FDataFormattingOptions format;
@@ -438,6 +442,7 @@ void FormatScreenMemory(FSpectrumEmu* pEmu, int screenNo)
 	snprintf(labelName,32, "Screen_%d", screenNo);
 	FLabelInfo* pLabel = AddLabel(state, kScreenData, labelName, ELabelType::Data);
 	pLabel->Global = true;
+	state.UpdateGlobalLabelIndex(state.AddressRefFromPhysicalAddress(kScreenData));
 
 	// Format Charmap 4x3
 	FDataFormattingOptions format;
@@ -456,6 +461,7 @@ void FormatPlatformMemory(FSpectrumEmu* pEmu, int platformNo)
 	snprintf(labelName, 32, "Platform_%d", platformNo);
 	FLabelInfo* pLabel = AddLabel(state, platformAddr, labelName, ELabelType::Data);
 	pLabel->Global = true;
+	state.UpdateGlobalLabelIndex(state.AddressRefFromPhysicalAddress(platformAddr));
 
 	// Format Bitmap 16x8
 	FDataFormattingOptions format;
@@ -294,6 +294,8 @@ bool ImportSkoolKitFile(FCodeAnalysisState& state, const char* pTextFileName, FS
 	if (fp == nullptr)
 		return false;
 
+	FGlobalLabelBatchScope labelBatch(state);
+
 	char blockDirective = kSkoolkitDirectiveNone;
 	char subBlockDirective = kSkoolkitDirectiveNone;
 
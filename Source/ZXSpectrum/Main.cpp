@@ -1,7 +1,7 @@
 #include "SpectrumEmu.h"
 #include "Misc/MainLoop.h"
 
-#ifndef TEST
+#if !defined(TEST) && !defined(BATCH)
 int main(int argc, char** argv)
 {
 	FSpectrumLaunchConfig launchConfig;
@@ -16,6 +16,8 @@ bool FZXGameLoader::LoadSnapshot(const FGameSnapshot& snapshot)
 
 	const char* pFileName = snapshot.FileName.c_str();
 
+	pSpectrumEmu->Tape.Eject();	// the tape loaders insert a new one
+
 	switch (snapshot.Type)
 	{
 	case ESnapshotType::Z80:
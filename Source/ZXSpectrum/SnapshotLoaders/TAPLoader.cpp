@@ -6,6 +6,7 @@
 #include <cassert>
 #include <systems/zx.h>
 #include "Util/MemoryBuffer.h"
+#include "Debug/DebugLog.h"
 
 // https://sinclair.wiki.zxnet.co.uk/wiki/TAP_format
 
@@ -26,30 +27,27 @@ bool LoadTAPFromMemory(FSpectrumEmu* pEmu, const uint8_t* pData, size_t dataSize
 	FMemoryBuffer tapBuffer;
 	tapBuffer.Init(pData, dataSize);
 
-	// TODO: This is a basic POC reader, we could store it a much nicer way
+	// each block is a length followed by the flag byte, data & checksum the ROM loads
+	std::vector<FSpectrumTapeBlock> blocks;
 	while (tapBuffer.Finished() == false)
 	{
-		const uint16_t blockLength = tapBuffer.Read<uint16_t>();
-		const uint8_t flags = tapBuffer.Read<uint8_t>();
-		if (flags == 0)
+		uint16_t blockLength = 0;
+		FSpectrumTapeBlock block;
+		const bool bHaveLength = tapBuffer.Read(blockLength);
+		block.Data.resize(blockLength);
+		if (bHaveLength == false || tapBuffer.ReadBytes(block.Data.data(), blockLength) == false)
 		{
-			const uint8_t blockType = tapBuffer.Read<uint8_t>();
-			char fileName[10];
-			tapBuffer.ReadBytes(fileName, 10);
-			const uint16_t dataBlockLength = tapBuffer.Read<uint16_t>();
-			const uint16_t Param1 = tapBuffer.Read<uint16_t>();
-			const uint16_t Param2 = tapBuffer.Read<uint16_t>();
-			const uint8_t checksum = tapBuffer.Read<uint8_t>();
-		}
-		else if (flags == 0xff)
-		{
-			uint16_t dataLength = blockLength - 2;
-			uint8_t* pData = new uint8_t[dataLength];
-			tapBuffer.ReadBytes(pData, dataLength);
-			const uint8_t checksum = tapBuffer.Read<uint8_t>();
-			delete[] pData;
+			LOGWARNING("TAP Loader: Truncated block %d", (int)blocks.size());
+			break;
 		}
+		blocks.push_back(std::move(block));
 	}
 
-	return false;
-}
\ No newline at end of file
+	if (blocks.empty())
+		return false;
+
+	// boot the machine with the tape in, LOAD "" will load it
+	zx_reset(&pEmu->ZXEmuState);
+	pEmu->Tape.Insert(blocks);
+	return true;
+}
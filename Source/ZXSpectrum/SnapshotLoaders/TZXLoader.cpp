@@ -16,12 +16,34 @@ enum class ETZXBlockId
 {
 	StandardSpeed	= 0x10,
 	TurboSpeed		= 0x11,
-
+	PureTone		= 0x12,
+	PulseSequence	= 0x13,
+	PureData		= 0x14,
+	DirectRecording	= 0x15,
+	CSWRecording	= 0x18,
+	GeneralizedData	= 0x19,
+	Pause			= 0x20,
+	GroupStart		= 0x21,
+	GroupEnd		= 0x22,
+	JumpTo			= 0x23,
+	LoopStart		= 0x24,
+	LoopEnd			= 0x25,
+	CallSequence	= 0x26,
+	ReturnFromSequence	= 0x27,
+	Select			= 0x28,
+	StopTape48K		= 0x2A,
+	SetSignalLevel	= 0x2B,
+	TextDescription	= 0x30,
+	Message			= 0x31,
 	ArchiveInfo		= 0x32,
+	HardwareType	= 0x33,
+	CustomInfo		= 0x35,
+	Glue			= 0x5A,
 };
 
 struct FTZXBlockBase
 {
+	virtual ~FTZXBlockBase() = default;
 	ETZXBlockId	Type;
 };
 
@@ -51,6 +73,42 @@ struct FTZXArchiveBlock : public FTZXBlockBase
 	std::vector<FTZXArchiveBlockText>	TextEntries;
 };
 
+// Read a block of tape data following its header, turbo & pure data blocks have 24 bit lengths
+static bool ReadTZXDataBlock(FMemoryBuffer& buffer, size_t headerSize, size_t lengthSize, bool bStandardSpeed, std::vector<FSpectrumTapeBlock>& blocks)
+{
+	uint8_t header[18];
+	if (buffer.ReadBytes(header, headerSize) == false)
+		return false;
+
+	size_t length = 0;
+	for (size_t byteNo = 0; byteNo < lengthSize; byteNo++)
+		length |= header[headerSize - lengthSize + byteNo] << (byteNo * 8);
+
+	FSpectrumTapeBlock block;
+	block.bStandardSpeed = bStandardSpeed;
+	block.Data.resize(length);
+	if (buffer.ReadBytes(block.Data.data(), length) == false)
+		return false;
+
+	blocks.push_back(std::move(block));
+	return true;
+}
+
+// Skip a block we don't use, the length field is at the end of the block's header
+static bool SkipTZXBlock(FMemoryBuffer& buffer, size_t headerSize, size_t lengthSize, size_t lengthScale = 1)
+{
+	uint8_t header[20];
+	if (buffer.ReadBytes(header, headerSize) == false)
+		return false;
+
+	size_t length = 0;
+	for (size_t byteNo = 0; byteNo < lengthSize; byteNo++)
+		length |= header[headerSize - lengthSize + byteNo] << (byteNo * 8);
+
+	std::vector<uint8_t> skipped(length * lengthScale);
+	return buffer.ReadBytes(skipped.data(), skipped.size());
+}
+
 struct FTZXFile
 {
 
@@ -83,19 +141,83 @@ bool LoadTZXFromMemory(FSpectrumEmu* pEmu, const uint8_t* pData, size_t dataSize
 	const uint8_t majorVersion = tzxBuffer.Read<uint8_t>();
 	const uint8_t minorVersion = tzxBuffer.Read<uint8_t>();
 
-	while (tzxBuffer.Finished() == false)
+	// Only standard speed blocks can be loaded by the ROM trap.
+	// Turbo & pure data blocks are kept so the tape knows where a custom loader takes over, other signal blocks stand in as empty blocks.
+	std::vector<FSpectrumTapeBlock> tapeBlocks;
+	bool bOk = true;
+
+	while (bOk && tzxBuffer.Finished() == false)
 	{
 		const ETZXBlockId blockId = (ETZXBlockId)tzxBuffer.Read<uint8_t>();
 
 		switch (blockId)
 		{
 		case ETZXBlockId::StandardSpeed:
-			{
-				LOGINFO("TZX Loader: Standard Speed Block");
-			}
+			bOk = ReadTZXDataBlock(tzxBuffer, 4, 2, true, tapeBlocks);
 			break;
 		case ETZXBlockId::TurboSpeed:
 			LOGINFO("TZX Loader: Turbo Speed Block");
+			bOk = ReadTZXDataBlock(tzxBuffer, 18, 3, false, tapeBlocks);
+			break;
+		case ETZXBlockId::PureData:
+			bOk = ReadTZXDataBlock(tzxBuffer, 10, 3, false, tapeBlocks);
+			break;
+
+		case ETZXBlockId::PureTone:
+		case ETZXBlockId::PulseSequence:
+		case ETZXBlockId::DirectRecording:
+		case ETZXBlockId::CSWRecording:
+		case ETZXBlockId::GeneralizedData:
+			{
+				FSpectrumTapeBlock signalBlock;
+				signalBlock.bStandardSpeed = false;
+				tapeBlocks.push_back(signalBlock);
+
+				if (blockId == ETZXBlockId::PureTone)
+					bOk = SkipTZXBlock(tzxBuffer, 4, 0);
+				else if (blockId == ETZXBlockId::PulseSequence)
+					bOk = SkipTZXBlock(tzxBuffer, 1, 1, 2);
+				else if (blockId == ETZXBlockId::DirectRecording)
+					bOk = SkipTZXBlock(tzxBuffer, 8, 3);
+				else
+					bOk = SkipTZXBlock(tzxBuffer, 4, 4);
+			}
+			break;
+
+		case ETZXBlockId::Pause:
+		case ETZXBlockId::JumpTo:
+		case ETZXBlockId::LoopStart:
+			bOk = SkipTZXBlock(tzxBuffer, 2, 0);
+			break;
+		case ETZXBlockId::GroupEnd:
+		case ETZXBlockId::LoopEnd:
+		case ETZXBlockId::ReturnFromSequence:
+			break;
+		case ETZXBlockId::GroupStart:
+		case ETZXBlockId::TextDescription:
+			bOk = SkipTZXBlock(tzxBuffer, 1, 1);
+			break;
+		case ETZXBlockId::Message:
+			bOk = SkipTZXBlock(tzxBuffer, 2, 1);
+			break;
+		case ETZXBlockId::CallSequence:
+			bOk = SkipTZXBlock(tzxBuffer, 2, 2, 2);
+			break;
+		case ETZXBlockId::Select:
+			bOk = SkipTZXBlock(tzxBuffer, 2, 2);
+			break;
+		case ETZXBlockId::StopTape48K:
+		case ETZXBlockId::SetSignalLevel:
+			bOk = SkipTZXBlock(tzxBuffer, 4, 4);
+			break;
+		case ETZXBlockId::HardwareType:
+			bOk = SkipTZXBlock(tzxBuffer, 1, 1, 3);
+			break;
+		case ETZXBlockId::CustomInfo:
+			bOk = SkipTZXBlock(tzxBuffer, 20, 4);
+			break;
+		case ETZXBlockId::Glue:
+			bOk = SkipTZXBlock(tzxBuffer, 9, 0);
 			break;
 
 		case ETZXBlockId::ArchiveInfo:
@@ -107,10 +229,23 @@ bool LoadTZXFromMemory(FSpectrumEmu* pEmu, const uint8_t* pData, size_t dataSize
 			}
 			break;
 		default:
+			// we don't know how long the block is so can't carry on
 			LOGWARNING("TZX Loader: Unrecognised block Id: 0x%0X", (uint8_t)blockId);
+			bOk = false;
 		}
-
 	}
 
-	return false;
+	for (FTZXBlockBase* pBlock : tzxFile.Blocks)
+		delete pBlock;
+
+	if (bOk == false)
+		LOGWARNING("TZX Loader: Stopped reading at block %d", (int)tapeBlocks.size());
+
+	if (tapeBlocks.empty())
+		return false;
+
+	// boot the machine with the tape in, LOAD "" will load it
+	zx_reset(&pEmu->ZXEmuState);
+	pEmu->Tape.Insert(tapeBlocks);
+	return true;
 }
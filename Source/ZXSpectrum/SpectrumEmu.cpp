@@ -23,6 +23,8 @@
 
 #include "zx-roms.h"
 #include <algorithm>
+#include <array>
+#include <utility>
 #include <sokol_audio.h>
 #include "Exporters/SkoolkitExporter.h"
 #include "Importers/SkoolkitImporter.h"
@@ -38,6 +40,7 @@
 #include "App.h"
 #include <CodeAnalyser/CodeAnalysisState.h>
 #include "CodeAnalyser/CodeAnalysisJson.h"
+#include "CodeAnalyser/CodeAnalysisBinary.h"
 #include "ZXSpectrumGameConfig.h"
 
 #include "LuaScripting/LuaSys.h"
@@ -105,6 +108,11 @@ const uint8_t* FSpectrumEmu::GetMemPtr(uint16_t address) const
 void FSpectrumEmu::WriteByte(uint16_t address, uint8_t value)
 {
 	mem_wr(&ZXEmuState.mem, address, value);
+	CodeAnalysis.MarkMemoryWritten(address);
+
+	const int ramBankNo = CurRAMBankNo[address >> 14];
+	if (ramBankNo != -1)
+		FrameTraceViewer.MarkMemoryWritten(ramBankNo, address & 0x3fff);
 }
 
 
@@ -217,13 +225,16 @@ void gfx_destroy_texture(void* h)
 	
 }
 
+#ifndef BATCH
 /* audio-streaming callback */
 static void PushAudio(const float* samples, int num_samples, void* user_data)
 {
 	FSpectrumEmu* pEmu = (FSpectrumEmu*)user_data;
-	if(pEmu->GetGlobalConfig()->bEnableAudio)
+	// don't play audio when the debugger is re-executing code or running in warp mode
+	if(pEmu->GetGlobalConfig()->bEnableAudio && pEmu->GetCodeAnalysis().Debugger.IsReplaying() == false && pEmu->IsWarping() == false)
 		saudio_push(samples, num_samples);
 }
+#endif
 
 void	FSpectrumEmu::OnInstructionExecuted(int ticks, uint64_t pins)
 {
@@ -233,8 +244,12 @@ void	FSpectrumEmu::OnInstructionExecuted(int ticks, uint64_t pins)
 	const bool bWrite = (pins & Z80_CTRL_PIN_MASK) == (Z80_MREQ | Z80_WR);
 	const uint16_t pc = pins & 0xffff;	// set PC to pc of instruction just executed
 
-	RegisterCodeExecuted(state, pc, PreviousPC);
-	MemoryHandlerTrapFunction(pc, ticks, pins, this);
+	// replays re-run code that's already been analysed
+	if (state.Debugger.IsReplaying() == false)
+	{
+		RegisterCodeExecuted(state, pc, PreviousPC);
+		MemoryHandlerTrapFunction(pc, ticks, pins, this);
+	}
 
 #if ENABLE_CAPTURES
 	FLabelInfo* pLabel = state.GetLabelForAddress(pc);
@@ -253,27 +268,57 @@ int UIEvalBreakpoint(ui_dbg_t* dbg_win, uint16_t pc, int ticks, uint64_t pins, v
 	return 0;
 }
 
-uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
+// Tick specialised on the analysis features that are switched on - see ETickFeature
+// The pins are decoded once and shared with the code analyser & debugger
+template <uint32_t kFeatures>
+uint64_t FSpectrumEmu::Z80TickWithFeatures(int num, uint64_t pins)
+{
+	ProcessTick<kFeatures>(CodeAnalysis.Debugger.DecodeTickPins(pins), (uint16_t)ZXEmuState.scanline_y);
+	return pins;
+}
+
+// Replay the accesses an instruction made, then the tick that completed it
+template <uint32_t kFeatures>
+void FSpectrumEmu::Z80InstructionWithFeatures(const FZXInstructionInfo& instruction, uint64_t pins, uint64_t lastPins)
+{
+	FDebugger& debugger = CodeAnalysis.Debugger;
+
+	for (int accessNo = 0; accessNo < instruction.NoAccesses; accessNo++)
+	{
+		const FZXInstructionAccess& access = instruction.Accesses[accessNo];
+		FCPUTickPins tick = debugger.DecodeTickPins(access.Pins, access.LastPins);
+		tick.bNewOp = false;	// the CPU has moved on since this tick
+		ProcessTick<kFeatures>(tick, access.ScanlineY);
+	}
+
+	InstructionsTicks += instruction.NoTicks - instruction.NoAccesses - 1;	// ticks with no accesses
+	ProcessTick<kFeatures>(debugger.DecodeTickPins(pins, lastPins), (uint16_t)ZXEmuState.scanline_y);
+}
+
+template <uint32_t kFeatures>
+void FSpectrumEmu::ProcessTick(const FCPUTickPins& tick, uint16_t scanlinePos)
 {
 	FCodeAnalysisState &state = CodeAnalysis;
 	FDebugger& debugger = CodeAnalysis.Debugger;
 	z80_t& cpu = ZXEmuState.cpu;
 	const uint16_t pc = GetPC().Address;
-	static uint64_t lastTickPins = 0;
-	const uint64_t risingPins = pins & (pins ^ lastTickPins);
-	lastTickPins = pins;
-	static uint16_t lastScanlinePos = 0;
-	const uint16_t scanlinePos = (uint16_t)ZXEmuState.scanline_y;
+	const uint64_t pins = tick.Pins;
+
+	constexpr bool bDataAccesses = (kFeatures & TickFeature_DataAccesses) != 0;
+	constexpr bool bEvents = (kFeatures & TickFeature_Events) != 0;
+	constexpr bool bScreenWriteEvents = (kFeatures & TickFeature_ScreenWriteEvents) != 0;
+	constexpr bool bIOAnalysis = (kFeatures & TickFeature_IOAnalysis) != 0;
+	const bool bReplaying = debugger.IsReplaying();
 
 	// trigger frame events on scanline pos
-	if(scanlinePos != lastScanlinePos)
+	if(scanlinePos != LastScanlinePos && bReplaying == false)
 	{
 		if (scanlinePos == 0)	// first scanline
 			CodeAnalysis.OnMachineFrameStart();
 		if (scanlinePos == ZXEmuState.frame_scan_lines)	// last scanline
 			CodeAnalysis.OnMachineFrameEnd();
 	}
-	lastScanlinePos = scanlinePos;
+	LastScanlinePos = scanlinePos;
 
 	/* memory and IO requests */
 	if (pins & Z80_MREQ) 
@@ -281,11 +326,11 @@ uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
 		/* a memory request machine cycle
 			FIXME: 'contended memory' accesses should inject wait states
 		*/
-		const uint16_t addr = Z80_GET_ADDR(pins);
-		const uint8_t value = Z80_GET_DATA(pins);
+		const uint16_t addr = tick.Addr;
+		const uint8_t value = tick.Data;
 		if (pins & Z80_RD)
 		{
-			if (risingPins & Z80_INT)	// check if in interrupt - could this be done in the shared code analysis?
+			if (tick.RisingPins & Z80_INT)	// check if in interrupt - could this be done in the shared code analysis?
 			{
 				// TODO: read is to fetch interrupt handler address
 				//LOGINFO("Interrupt Handler at: %x", value);
@@ -303,25 +348,32 @@ uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
 			}
 			else
 			{
-				if (state.bRegisterDataAccesses)
+				if constexpr (bDataAccesses)
 					RegisterDataRead(state, pc, addr);
 			}
 		}
-		else if (pins & Z80_WR) 
+		else if ((pins & Z80_WR) && bReplaying == false)	// the checkpoint restore marked all memory as written
 		{
-			if (state.bRegisterDataAccesses)
+			state.MarkMemoryWritten(addr);
+			if constexpr (bDataAccesses)
 				RegisterDataWrite(state, pc, addr, value);
-			const FAddressRef addrRef = state.AddressRefFromPhysicalAddress(addr);
 			const FAddressRef pcAddrRef = state.AddressRefFromPhysicalAddress(pc);
 			state.SetLastWriterForAddress(addr, pcAddrRef);
+
+			const int ramBankNo = CurRAMBankNo[addr >> 14];
+			if (ramBankNo != -1)
+				FrameTraceViewer.MarkMemoryWritten(ramBankNo, addr & 0x3fff);
 			
-			if (addr >= kScreenPixMemStart && addr <= kScreenPixMemEnd)
+			if constexpr (bScreenWriteEvents)
 			{
-				debugger.RegisterEvent((uint8_t)EEventType::ScreenPixWrite, pcAddrRef, addr, value, scanlinePos);
-			}
-			else if (addr >= kScreenAttrMemStart && addr < kScreenAttrMemEnd)
-			{
-				debugger.RegisterEvent((uint8_t)EEventType::ScreenAttrWrite, pcAddrRef, addr, value, scanlinePos);
+				if (addr >= kScreenPixMemStart && addr <= kScreenPixMemEnd)
+				{
+					debugger.RegisterEvent((uint8_t)EEventType::ScreenPixWrite, pcAddrRef, addr, value, scanlinePos);
+				}
+				else if (addr >= kScreenAttrMemStart && addr < kScreenAttrMemEnd)
+				{
+					debugger.RegisterEvent((uint8_t)EEventType::ScreenAttrWrite, pcAddrRef, addr, value, scanlinePos);
+				}
 			}
 		}
 	}
@@ -330,8 +382,8 @@ uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
 	if (pins & Z80_IORQ)
 	{
 		const FAddressRef pcAddrRef = state.AddressRefFromPhysicalAddress(pc);
-		const uint8_t data = Z80_GET_DATA(pins);
-		const uint16_t addr = Z80_GET_ADDR(pins);
+		const uint8_t data = tick.Data;
+		const uint16_t addr = tick.Addr;
 
 		//IOAnalysis.IOHandler(pc, pins);
 
@@ -339,22 +391,29 @@ uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
 		{
 			if ((pins & Z80_A0) == 0)
 			{
-				debugger.RegisterEvent((uint8_t)EEventType::KeyboardRead, pcAddrRef, addr , data, scanlinePos);
-				Keyboard.RegisterKeyboardRead(pcAddrRef,addr,data);
+				if (bReplaying == false)
+					ULAPortReads++;
+				if constexpr (bEvents)
+					debugger.RegisterEvent((uint8_t)EEventType::KeyboardRead, pcAddrRef, addr , data, scanlinePos);
+				if constexpr (bIOAnalysis)
+					Keyboard.RegisterKeyboardRead(pcAddrRef,addr,data);
 			}
-			else if ((pins & (Z80_A7 | Z80_A6 | Z80_A5)) == 0) // Kempston Joystick (........000.....)
+			else if constexpr (bEvents)
 			{
-				debugger.RegisterEvent((uint8_t)EEventType::KempstonJoystickRead, pcAddrRef, addr, data, scanlinePos);
-			}
-			else if (pins & 0xff)
-			{
-				debugger.RegisterEvent((uint8_t)EEventType::FloatingBusRead, pcAddrRef, addr, data, scanlinePos);
-			}
-			// 128K specific
-			else if (ZXEmuState.type == ZX_TYPE_128)
-			{
-				if ((pins & (Z80_A15 | Z80_A14 | Z80_A1)) == (Z80_A15 | Z80_A14))
-					debugger.RegisterEvent((uint8_t)EEventType::SoundChipRead, pcAddrRef, addr, data, scanlinePos);
+				if ((pins & (Z80_A7 | Z80_A6 | Z80_A5)) == 0) // Kempston Joystick (........000.....)
+				{
+					debugger.RegisterEvent((uint8_t)EEventType::KempstonJoystickRead, pcAddrRef, addr, data, scanlinePos);
+				}
+				else if (pins & 0xff)
+				{
+					debugger.RegisterEvent((uint8_t)EEventType::FloatingBusRead, pcAddrRef, addr, data, scanlinePos);
+				}
+				// 128K specific
+				else if (ZXEmuState.type == ZX_TYPE_128)
+				{
+					if ((pins & (Z80_A15 | Z80_A14 | Z80_A1)) == (Z80_A15 | Z80_A14))
+						debugger.RegisterEvent((uint8_t)EEventType::SoundChipRead, pcAddrRef, addr, data, scanlinePos);
+				}
 			}
 		}
 		else if (pins & Z80_WR)
@@ -362,23 +421,30 @@ uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
 			// handle bank switching on speccy 128
 			if ((pins & Z80_A0) == 0)
 			{
-				static uint8_t LastFE = 0;
 				// Spectrum ULA (...............0)
 
 				// has border colour changed?
 				if ((data & 7) != (LastFE & 7))
-					debugger.RegisterEvent((uint8_t)EEventType::SetBorderColour, pcAddrRef, Z80_GET_ADDR(pins), data, scanlinePos);
+				{
+					if constexpr (bEvents)
+						debugger.RegisterEvent((uint8_t)EEventType::SetBorderColour, pcAddrRef, addr, data, scanlinePos);
+				}
 
 				// has beeper changed
 				if ((data & (1 << 4)) != (LastFE & (1 << 4)))
 				{
-					debugger.RegisterEvent((uint8_t)EEventType::OutputBeeper, pcAddrRef, Z80_GET_ADDR(pins), data, scanlinePos);
-					Beeper.RegisterBeeperWrite(pcAddrRef,data);
+					if constexpr (bEvents)
+						debugger.RegisterEvent((uint8_t)EEventType::OutputBeeper, pcAddrRef, addr, data, scanlinePos);
+					if constexpr (bIOAnalysis)
+						Beeper.RegisterBeeperWrite(pcAddrRef,data);
 				}
 
 				// has mic output changed
 				if ((data & (1 << 3)) != (LastFE & (1 << 3)))
-					debugger.RegisterEvent((uint8_t)EEventType::OutputMic, pcAddrRef, Z80_GET_ADDR(pins), data, scanlinePos);
+				{
+					if constexpr (bEvents)
+						debugger.RegisterEvent((uint8_t)EEventType::OutputMic, pcAddrRef, addr, data, scanlinePos);
+				}
 
 				LastFE = data;
 			}
@@ -388,7 +454,8 @@ uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
 				{
 					if (!ZXEmuState.memory_paging_disabled)
 					{
-						debugger.RegisterEvent((uint8_t)EEventType::SwitchMemoryBanks, pcAddrRef, Z80_GET_ADDR(pins), data, scanlinePos);
+						if constexpr (bEvents)
+							debugger.RegisterEvent((uint8_t)EEventType::SwitchMemoryBanks, pcAddrRef, addr, data, scanlinePos);
 
 						const int ramBank = data & 0x7;
 						const int romBank = (data & (1 << 4)) ? 1 : 0;
@@ -397,18 +464,23 @@ uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
 						SetROMBank(romBank);
 						SetRAMBank(3, ramBank);
 
-						MemoryControl.RegisterMemoryConfigWrite(pcAddrRef, data);
+						if constexpr (bIOAnalysis)
+							MemoryControl.RegisterMemoryConfigWrite(pcAddrRef, data);
 					}
 				}
 				else if ((pins & (Z80_A15 | Z80_A14 | Z80_A1)) == (Z80_A15 | Z80_A14))	// select AY-3-8912 register (11............0.)
 				{
-					debugger.RegisterEvent((uint8_t)EEventType::SoundChipRegisterSelect, pcAddrRef, addr, data, scanlinePos);
-					AYSoundChip.SelectAYRegister(pcAddrRef, data);
+					if constexpr (bEvents)
+						debugger.RegisterEvent((uint8_t)EEventType::SoundChipRegisterSelect, pcAddrRef, addr, data, scanlinePos);
+					if constexpr (bIOAnalysis)
+						AYSoundChip.SelectAYRegister(pcAddrRef, data);
 				}
 				else if ((pins & (Z80_A15 | Z80_A14 | Z80_A1)) == Z80_A15)	// write to AY-3-8912 (10............0.) 
 				{
-					debugger.RegisterEvent((uint8_t)EEventType::SoundChipRegisterWrite, pcAddrRef, addr, data, scanlinePos);
-					AYSoundChip.WriteAYRegister(pcAddrRef, data);
+					if constexpr (bEvents)
+						debugger.RegisterEvent((uint8_t)EEventType::SoundChipRegisterWrite, pcAddrRef, addr, data, scanlinePos);
+					if constexpr (bIOAnalysis)
+						AYSoundChip.WriteAYRegister(pcAddrRef, data);
 				}
 			}
 		}
@@ -416,17 +488,67 @@ uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
 
 	InstructionsTicks++;
 
-	const bool bNewOp = z80_opdone(&ZXEmuState.cpu);
-
-	if (bNewOp)
+	if (tick.bNewOp)
 	{
 		OnInstructionExecuted(InstructionsTicks, pins);
 		InstructionsTicks = 0;
 	}
 
-	CodeAnalysis.OnCPUTick(pins);
-	//debugger.CPUTick(pins);
-	return pins;
+	CodeAnalysis.OnCPUTick<kFeatures>(tick);
+}
+
+// Tables of tick & instruction functions, indexed by the feature flags
+template <size_t... kFeatures>
+static constexpr std::array<FSpectrumEmu::FZ80TickFunc, sizeof...(kFeatures)> MakeZ80TickFunctions(std::index_sequence<kFeatures...>)
+{
+	return { &FSpectrumEmu::Z80TickWithFeatures<(uint32_t)kFeatures>... };
+}
+
+template <size_t... kFeatures>
+static constexpr std::array<FSpectrumEmu::FZ80InstructionFunc, sizeof...(kFeatures)> MakeZ80InstructionFunctions(std::index_sequence<kFeatures...>)
+{
+	return { &FSpectrumEmu::Z80InstructionWithFeatures<(uint32_t)kFeatures>... };
+}
+
+static const std::array<FSpectrumEmu::FZ80TickFunc, TickFeature_NoCombinations> g_Z80TickFunctions = MakeZ80TickFunctions(std::make_index_sequence<TickFeature_NoCombinations>());
+static const std::array<FSpectrumEmu::FZ80InstructionFunc, TickFeature_NoCombinations> g_Z80InstructionFunctions = MakeZ80InstructionFunctions(std::make_index_sequence<TickFeature_NoCombinations>());
+
+// Select the tick function for the analysis features that are currently needed
+// Features are only changed from the UI or the debugger between runs so this is done before the machine is run
+void FSpectrumEmu::UpdateTickFunction()
+{
+	FDebugger& debugger = CodeAnalysis.Debugger;
+	uint32_t features = CodeAnalysis.GetTickFeatures();
+
+	// replays only need to find where to stop, the analysis has already seen the code run
+	if (debugger.IsReplaying())
+		features &= TickFeature_Breakpoints;
+
+	if ((features & TickFeature_Events) && 
+		(debugger.IsEventTypeEnabled((uint8_t)EEventType::ScreenPixWrite) || debugger.IsEventTypeEnabled((uint8_t)EEventType::ScreenAttrWrite)))
+		features |= TickFeature_ScreenWriteEvents;
+
+	Z80TickFunction = g_Z80TickFunctions[features];
+	Z80InstructionFunction = g_Z80InstructionFunctions[features];
+
+	// breakpoints & step modes that are checked every tick need to be able to stop part way through an instruction
+	bPerInstructionCallbacks = (features & TickFeature_Breakpoints) == 0;
+}
+
+uint64_t FSpectrumEmu::Z80Tick(int num, uint64_t pins)
+{
+	return (this->*Z80TickFunction)(num, pins);
+}
+
+void FSpectrumEmu::OnZ80Instruction(const FZXInstructionInfo& instruction, uint64_t pins, uint64_t lastPins)
+{
+	(this->*Z80InstructionFunction)(instruction, pins, lastPins);
+}
+
+static void Z80InstructionThunk(void* pUserData, const FZXInstructionInfo* pInstruction, uint64_t pins, uint64_t lastPins)
+{
+	FSpectrumEmu* pEmu = (FSpectrumEmu*)pUserData;
+	pEmu->OnZ80Instruction(*pInstruction, pins, lastPins);
 }
 
 static uint64_t Z80TickThunk(int num, uint64_t pins, void* user_data)
@@ -462,6 +584,7 @@ void FSpectrumEmu::SetRAMBank(int slot, int bankNo)
 	CodeAnalysis.MapBank(bankId, startPage, EBankAccess::ReadWrite);
 
 	CurRAMBank[slot] = bankId;
+	CurRAMBankNo[slot] = (int8_t)bankNo;
 }
 
 // callback function to save snapshot to a numbered slot
@@ -586,6 +709,8 @@ bool FSpectrumEmu::Init(const FEmulatorLaunchConfig& config)
 	SetWindowIcon(GetBundlePath("SALogo.png"));
 
 	// Initialise Emulator
+	Z80TickFunction = g_Z80TickFunctions[TickFeature_All];
+	Z80InstructionFunction = g_Z80InstructionFunctions[TickFeature_All];
 	pGlobalConfig = new FZXSpectrumConfig();
     pGlobalConfig->Init();
 	pGlobalConfig->Load(kGlobalConfigFilename);
@@ -614,10 +739,12 @@ bool FSpectrumEmu::Init(const FEmulatorLaunchConfig& config)
 	//desc.pixel_buffer = FrameBuffer;
 	//desc.pixel_buffer_size = pixelBufferSize;
 
-	// audio
+	// audio - batch builds have no audio device
+#ifndef BATCH
 	desc.audio.callback.func = PushAudio;	// our audio callback
 	desc.audio.callback.user_data = this;
 	desc.audio.sample_rate = saudio_sample_rate();
+#endif
 	
 	// roms
 	desc.roms.zx48k.ptr = dump_amstrad_zx48k_bin;
@@ -684,6 +811,9 @@ bool FSpectrumEmu::Init(const FEmulatorLaunchConfig& config)
 
 	SpectrumViewer.Init(this);
 	FrameTraceViewer.Init(this);
+	ReverseExecutionMachine.Init(this);
+	CodeAnalysis.Debugger.GetReverseExecution().SetMachine(&ReverseExecutionMachine);
+	Tape.Init(this);
 
 	CodeAnalysis.ViewState[0].Enabled = true;	// always have first view enabled
 
@@ -818,6 +948,7 @@ bool FSpectrumEmu::Init(const FEmulatorLaunchConfig& config)
 void FSpectrumEmu::Shutdown()
 {
 	FEmuBase::Shutdown();
+	Tape.Eject();
 	
 	if (RZXManager.GetReplayMode() == EReplayMode::Off)
 		SaveCurrentGameData();	// save on close
@@ -829,6 +960,7 @@ void FSpectrumEmu::Shutdown()
 	pGlobalConfig->NumberDisplayMode = GetNumberDisplayMode();
 	pGlobalConfig->bShowOpcodeValues = CodeAnalysis.pGlobalConfig->bShowOpcodeValues;
 	pGlobalConfig->BranchLinesDisplayMode = CodeAnalysis.pGlobalConfig->BranchLinesDisplayMode;
+	((FZXSpectrumConfig*)pGlobalConfig)->bInstantTapeLoad = Tape.IsInstantLoadEnabled();
 
 	pGlobalConfig->Save(kGlobalConfigFilename);
 
@@ -882,6 +1014,7 @@ bool FSpectrumEmu::StartGame(FGameConfig* pGameConfig, bool bLoadGameData /* =
 		const std::string root = pGlobalConfig->WorkspaceRoot;
 
 		std::string analysisJsonFName = root + "AnalysisJson/" + pGameConfig->Name + ".json";
+		std::string analysisBinFName = root + "AnalysisBin/" + pGameConfig->Name + ".bin";
 		std::string graphicsSetsJsonFName = root + "GraphicsSets/" + pGameConfig->Name + ".json";
 		std::string analysisStateFName = root + "AnalysisState/" + pGameConfig->Name + ".astate";
 		std::string saveStateFName = root + "SaveStates/" + pGameConfig->Name + ".state";
@@ -891,6 +1024,7 @@ bool FSpectrumEmu::StartGame(FGameConfig* pGameConfig, bool bLoadGameData /* =
 		if (FileExists((gameRoot + "Config.json").c_str()))	
 		{
 			analysisJsonFName = gameRoot + "Analysis.json";
+			analysisBinFName = gameRoot + "Analysis.bin";
 			graphicsSetsJsonFName = gameRoot + "GraphicsSets.json";
 			analysisStateFName = gameRoot + "AnalysisState.bin";
 			saveStateFName = gameRoot + "SaveState.bin";
@@ -902,7 +1036,13 @@ bool FSpectrumEmu::StartGame(FGameConfig* pGameConfig, bool bLoadGameData /* =
 			bLoadSnapshot = false;
 		}
 
-		if (FileExists(analysisJsonFName.c_str()))
+		// prefer the binary analysis, Json is for older projects
+		if (FileExists(analysisBinFName.c_str()))
+		{
+			ImportAnalysisBinary(CodeAnalysis, analysisBinFName.c_str());
+			ImportAnalysisState(CodeAnalysis, analysisStateFName.c_str());
+		}
+		else if (FileExists(analysisJsonFName.c_str()))
 		{
 			ImportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
 			ImportAnalysisState(CodeAnalysis, analysisStateFName.c_str());
@@ -995,6 +1135,7 @@ bool FSpectrumEmu::SaveCurrentGameData()
 		const std::string root = pGlobalConfig->WorkspaceRoot + pGameConfig->Name + "/";
 		const std::string configFName = root + "Config.json";
 		const std::string analysisJsonFName = root + "Analysis.json";
+		const std::string analysisBinFName = root + "Analysis.bin";
 		const std::string graphicsSetsJsonFName = root + "GraphicsSets.json";
 		const std::string analysisStateFName = root + "AnalysisState.bin";
 		const std::string saveStateFName = root + "SaveState.bin";
@@ -1004,12 +1145,14 @@ bool FSpectrumEmu::SaveCurrentGameData()
 		const std::string configFName = root + "Configs/" + pGameConfig->Name + ".json";
 		//const std::string dataFName = root + "GameData/" + pGameConfig->Name + ".bin";
 		const std::string analysisJsonFName = root + "AnalysisJson/" + pGameConfig->Name + ".json";
+		const std::string analysisBinFName = root + "AnalysisBin/" + pGameConfig->Name + ".bin";
 		const std::string graphicsSetsJsonFName = root + "GraphicsSets/" + pGameConfig->Name + ".json";
 		const std::string analysisStateFName = root + "AnalysisState/" + pGameConfig->Name + ".astate";
 		const std::string saveStateFName = root + "SaveStates/" + pGameConfig->Name + ".state";
 		EnsureDirectoryExists(std::string(root + "Configs").c_str());
 		EnsureDirectoryExists(std::string(root + "GameData").c_str());
 		EnsureDirectoryExists(std::string(root + "AnalysisJson").c_str());
+		EnsureDirectoryExists(std::string(root + "AnalysisBin").c_str());
 		EnsureDirectoryExists(std::string(root + "GraphicsSets").c_str());
 		EnsureDirectoryExists(std::string(root + "AnalysisState").c_str());
 		EnsureDirectoryExists(std::string(root + "SaveStates").c_str());
@@ -1030,7 +1173,9 @@ bool FSpectrumEmu::SaveCurrentGameData()
 
 		// The Future
 		SaveGameState(this, saveStateFName.c_str());
-		ExportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
+		ExportAnalysisBinaryChanges(CodeAnalysis, analysisBinFName.c_str());
+		if (pGlobalConfig->bSaveAnalysisJson)
+			ExportAnalysisJson(CodeAnalysis, analysisJsonFName.c_str());
 		ExportAnalysisState(CodeAnalysis, analysisStateFName.c_str());
 		pGraphicsViewer->SaveGraphicsSets(graphicsSetsJsonFName.c_str());
 	}
@@ -1159,6 +1304,20 @@ void FSpectrumEmu::SystemMenuAdditions(void)
 		}
 		ImGui::EndMenu();
 	}
+
+	if (ImGui::BeginMenu("Tape"))
+	{
+		if (Tape.IsInserted())
+			ImGui::Text("Block %d of %d", Tape.GetCurrentBlock(), Tape.GetNoBlocks());
+		if (ImGui::MenuItem("Rewind", 0, false, Tape.IsInserted()))
+			Tape.Rewind();
+		if (ImGui::MenuItem("Eject", 0, false, Tape.IsInserted()))
+			Tape.Eject();
+		bool bInstantLoad = Tape.IsInstantLoadEnabled();
+		if (ImGui::MenuItem("Instant Load", 0, &bInstantLoad))
+			Tape.SetInstantLoad(bInstantLoad);
+		ImGui::EndMenu();
+	}
 }
 
 void FSpectrumEmu::OptionsMenuAdditions(void)
@@ -1714,83 +1873,139 @@ void FSpectrumEmu::Tick()
 		//const float frameTime = min(1000000.0f / 50, 32000.0f) * ExecSpeedScale;
 		const uint32_t microSeconds = std::max(static_cast<uint32_t>(frameTime), uint32_t(1));
 
-		CodeAnalysis.OnFrameStart();
-		StoreRegisters_Z80(CodeAnalysis);
+		ExecuteHostFrame(microSeconds);
+	}
+
+	UpdateCharacterSets(CodeAnalysis);
+
+	// Draw UI
+	DrawDockingView();
+}
+
+// Run the machine for a period of time with full analysis
+// This doesn't depend on the host frame rate so can be used without a UI
+void FSpectrumEmu::ExecuteFrame(uint32_t microSeconds)
+{
+	LoadingCheckMicroSeconds += microSeconds;
+	CodeAnalysis.OnFrameStart();
+	UpdateTickFunction();
+	StoreRegisters_Z80(CodeAnalysis);
 #if ENABLE_CAPTURES
-		const uint32_t ticks_to_run = clk_ticks_to_run(&ZXEmuState.clk, microSeconds);
-		uint32_t ticks_executed = 0;
-		while (UIZX.dbg.dbg.z80->trap_id != kCaptureTrapId && ticks_executed < ticks_to_run)
-		{
-			ticks_executed += z80_exec(&ZXEmuState.cpu, ticks_to_run - ticks_executed);
+	const uint32_t ticks_to_run = clk_ticks_to_run(&ZXEmuState.clk, microSeconds);
+	uint32_t ticks_executed = 0;
+	while (UIZX.dbg.dbg.z80->trap_id != kCaptureTrapId && ticks_executed < ticks_to_run)
+	{
+		ticks_executed += z80_exec(&ZXEmuState.cpu, ticks_to_run - ticks_executed);
 
-			if (UIZX.dbg.dbg.z80->trap_id == kCaptureTrapId)
+		if (UIZX.dbg.dbg.z80->trap_id == kCaptureTrapId)
+		{
+			const uint16_t PC = GetPC();
+			FMachineState* pMachineState = CodeAnalysis.GetMachineState(PC);
+			if (pMachineState == nullptr)
 			{
-				const uint16_t PC = GetPC();
-				FMachineState* pMachineState = CodeAnalysis.GetMachineState(PC);
-				if (pMachineState == nullptr)
-				{
-					pMachineState = AllocateMachineState(CodeAnalysis);
-					CodeAnalysis.SetMachineStateForAddress(PC, pMachineState);
-				}
-
-				CaptureMachineState(pMachineState, this);
-				UIZX.dbg.dbg.z80->trap_id = 0;
-				_ui_dbg_continue(&UIZX.dbg);
+				pMachineState = AllocateMachineState(CodeAnalysis);
+				CodeAnalysis.SetMachineStateForAddress(PC, pMachineState);
 			}
+
+			CaptureMachineState(pMachineState, this);
+			UIZX.dbg.dbg.z80->trap_id = 0;
+			_ui_dbg_continue(&UIZX.dbg);
 		}
+	}
+	clk_ticks_executed(&ZXEmuState.clk, ticks_executed);
+	kbd_update(&ZXEmuState.kbd);
+#else
+	if (RZXManager.GetReplayMode() == EReplayMode::Playback)
+	{
+		if (RZXFetchesRemaining <= 0)
+			RZXFetchesRemaining += RZXManager.Update();
+		const uint32_t fetchesProcessed = ZXExeEmu_UseFetchCount(&ZXEmuState, RZXFetchesRemaining, GetIOInputFunc, this);
+		RZXFetchesRemaining -= fetchesProcessed;
+	}
+	else if (bPerInstructionCallbacks)
+	{
+		ZXExeEmu_PerInstruction(&ZXEmuState, microSeconds, &CurrentInstruction, Z80InstructionThunk, this);
+	}
+	else
+	{
+		CurrentInstruction.NoAccesses = 0;	// drop any part instruction from a previous per instruction run
+		CurrentInstruction.NoTicks = 0;
+		ZXExeEmu(&ZXEmuState, microSeconds);
+	}
+#endif
+	/*if (RZXManager.GetReplayMode() == EReplayMode::Playback)
+	{
+		assert(ZXEmuState.valid);
+		uint32_t icount = RZXManager.Update();
+
+		uint32_t ticks_to_run = clk_ticks_to_run(&ZXEmuState.clk, microSeconds);
+		uint32_t ticks_executed = z80_exec(&ZXEmuState.cpu, ticks_to_run);
 		clk_ticks_executed(&ZXEmuState.clk, ticks_executed);
 		kbd_update(&ZXEmuState.kbd);
-#else
-		if (RZXManager.GetReplayMode() == EReplayMode::Playback)
-		{
-			if (RZXFetchesRemaining <= 0)
-				RZXFetchesRemaining += RZXManager.Update();
-			const uint32_t fetchesProcessed = ZXExeEmu_UseFetchCount(&ZXEmuState, RZXFetchesRemaining, GetIOInputFunc, this);
-			RZXFetchesRemaining -= fetchesProcessed;
-		}
-		else
-		{
-			ZXExeEmu(&ZXEmuState, microSeconds);
-		}
+	}
+	else
+	{
+		uint32_t frameTicks = ZXEmuState.frame_scan_lines* ZXEmuState.scanline_period;
+		//zx_exec(&ZXEmuState, microSeconds);
+
+		//uint32_t ticks_to_run = clk_ticks_to_run(&ZXEmuState.clk, microSeconds);
+		//frameTicks = ticks_to_run;
+		ZXEmuState.clk.ticks_to_run = frameTicks;
+		const uint32_t ticksExecuted = z80_exec(&ZXEmuState.cpu, frameTicks);
+		clk_ticks_executed(&ZXEmuState.clk, ticksExecuted);
+		kbd_update(&ZXEmuState.kbd);
+	}*/
+#ifndef BATCH	// nobody looks at the frame trace in batch builds
+	FrameTraceViewer.CaptureFrame();
 #endif
-		/*if (RZXManager.GetReplayMode() == EReplayMode::Playback)
-		{
-			assert(ZXEmuState.valid);
-			uint32_t icount = RZXManager.Update();
+	//FrameScreenPixWrites.clear();
+	//FrameScreenAttrWrites.clear();
+	CodeAnalysis.OnFrameEnd();
+}
 
-			uint32_t ticks_to_run = clk_ticks_to_run(&ZXEmuState.clk, microSeconds);
-			uint32_t ticks_executed = z80_exec(&ZXEmuState.cpu, ticks_to_run);
-			clk_ticks_executed(&ZXEmuState.clk, ticks_executed);
-			kbd_update(&ZXEmuState.kbd);
-		}
-		else
-		{
-			uint32_t frameTicks = ZXEmuState.frame_scan_lines* ZXEmuState.scanline_period;
-			//zx_exec(&ZXEmuState, microSeconds);
-
-			//uint32_t ticks_to_run = clk_ticks_to_run(&ZXEmuState.clk, microSeconds);
-			//frameTicks = ticks_to_run;
-			ZXEmuState.clk.ticks_to_run = frameTicks;
-			const uint32_t ticksExecuted = z80_exec(&ZXEmuState.cpu, frameTicks);
-			clk_ticks_executed(&ZXEmuState.clk, ticksExecuted);
-			kbd_update(&ZXEmuState.kbd);
-		}*/
-		FrameTraceViewer.CaptureFrame();
-		//FrameScreenPixWrites.clear();
-		//FrameScreenAttrWrites.clear();
-		CodeAnalysis.OnFrameEnd();
+uint32_t FSpectrumEmu::GetMachineFrameMicroSeconds()
+{
+	return ZXGetFrameMicroSeconds(&ZXEmuState);
+}
+
+// Run a number of whole machine frames as fast as possible
+// returns the number of frames run before the debugger stopped
+int FSpectrumEmu::RunMachineFrames(int noFrames)
+{
+	const uint32_t frameMicroSeconds = GetMachineFrameMicroSeconds();
+
+	for (int frameNo = 0; frameNo < noFrames; frameNo++)
+	{
+		if (CodeAnalysis.Debugger.IsStopped())
+			return frameNo;
+
+		ExecuteFrame(frameMicroSeconds);
+		UpdateLoadingDetection();
 	}
 
-	UpdateCharacterSets(CodeAnalysis);
+	return noFrames;
+}
 
-	// Draw UI
-	DrawDockingView();
+// Tape loaders poll the ULA port for edges in a tight loop with interrupts off
+// Keyboard scanning reads it a handful of times a frame & normally with interrupts on
+bool FSpectrumEmu::DetectLoading()
+{
+	static const int kLoadingULAPortReads = 500;	// per machine frame, an edge loop does well over 1000 a frame
+
+	// host frames aren't machine frames so scale to the time run since the last check
+	const int loadingReads = (int)((uint64_t)kLoadingULAPortReads * LoadingCheckMicroSeconds / GetMachineFrameMicroSeconds());
+	const bool bLoading = LoadingCheckMicroSeconds > 0 && ULAPortReads >= loadingReads && ZXEmuState.cpu.iff1 == false;
+	ULAPortReads = 0;
+	LoadingCheckMicroSeconds = 0;
+	return bLoading;
 }
 
 void FSpectrumEmu::Reset()
 {
 	// Reset speccy
 	zx_reset(&ZXEmuState);
+	CodeAnalysis.Debugger.GetReverseExecution().Reset();
+	Tape.Rewind();
 	//ui_dbg_reset(&pZXUI->dbg);
 
 	FZXSpectrumGameConfig* pBasicConfig = (FZXSpectrumGameConfig * )GetGameConfigForName("ZXBasic");
@@ -31,6 +31,7 @@
 #include <string>
 #include "Viewers/SpriteViewer.h"
 #include "MemoryHandlers.h"
+#include "ZXChipsImpl.h"
 //#include "Disassembler.h"
 //#include "FunctionHandlers.h"
 #include "CodeAnalyser/CodeAnalyser.h"
@@ -45,6 +46,8 @@
 #include "SnapshotLoaders/RZXLoader.h"
 #include "Util/Misc.h"
 #include "SpectrumDevices.h"
+#include "SpectrumReverseExecution.h"
+#include "SpectrumTape.h"
 #include "Misc/EmuBase.h"
 
 struct FGame;
@@ -94,6 +97,11 @@ public:
 	void	Tick() override;
 	void	Reset() override;
 
+	void	ExecuteFrame(uint32_t microSeconds) override;
+	uint32_t	GetMachineFrameMicroSeconds() override;
+	int		RunMachineFrames(int noFrames);
+	bool	DetectLoading() override;
+
 	bool	LoadLua() override;
 
 	bool	NewGameFromSnapshot(const FGameSnapshot& snapshot) override;
@@ -120,6 +128,14 @@ public:
 
 	void	OnInstructionExecuted(int ticks, uint64_t pins);
 	uint64_t Z80Tick(int num, uint64_t pins);
+	void	OnZ80Instruction(const FZXInstructionInfo& instruction, uint64_t pins, uint64_t lastPins);
+	template <uint32_t kFeatures> uint64_t Z80TickWithFeatures(int num, uint64_t pins);
+	template <uint32_t kFeatures> void Z80InstructionWithFeatures(const FZXInstructionInfo& instruction, uint64_t pins, uint64_t lastPins);
+	template <uint32_t kFeatures> void ProcessTick(const FCPUTickPins& tick, uint16_t scanlinePos);
+	void	UpdateTickFunction();
+
+	typedef uint64_t (FSpectrumEmu::*FZ80TickFunc)(int num, uint64_t pins);
+	typedef void (FSpectrumEmu::*FZ80InstructionFunc)(const FZXInstructionInfo& instruction, uint64_t pins, uint64_t lastPins);
 
 	void	DrawMemoryTools();
 	void	DrawEmulatorUI() override;
@@ -170,6 +186,7 @@ public:
 	//FGamesList		GamesList;
 	FGamesList		RZXGamesList;
 	FZXGameLoader	GameLoader;
+	FZXReverseExecutionMachine	ReverseExecutionMachine;
 
 	//Viewers
 	FSpectrumViewer			SpectrumViewer;
@@ -183,6 +200,8 @@ public:
 	FAYAudioDevice			AYSoundChip;
 	FSpectrum128MemoryCtrl	MemoryControl;
 
+	FSpectrumTape		Tape;
+
 	// Code analysis pages - to cover 48K & 128K Spectrums
 	static const int	kNoBankPages = 16;	// no of pages per physical address slot (16k)
 	static const int	kNoRAMPages = 128;
@@ -193,6 +212,7 @@ public:
 	int16_t				RAMBanks[kNoRAMBanks];
 	int16_t				CurROMBank = -1;
 	int16_t				CurRAMBank[4] = { -1,-1,-1,-1 };
+	int8_t				CurRAMBankNo[4] = { -1,-1,-1,-1 };	// Spectrum RAM bank number (0-7) in each slot
 
 	// Memory handling
 	std::string							SelectedMemoryHandler;
@@ -206,6 +226,14 @@ public:
 	
 	uint16_t		PreviousPC = 0;		// store previous pc
 	int				InstructionsTicks = 0;
+	uint16_t		LastScanlinePos = 0;
+	uint8_t			LastFE = 0;			// last value written to the ULA port
+	int				ULAPortReads = 0;	// since the last loading check
+	uint32_t		LoadingCheckMicroSeconds = 0;	// machine time run since the last loading check
+	FZ80TickFunc	Z80TickFunction = nullptr;	// selected by UpdateTickFunction
+	FZ80InstructionFunc	Z80InstructionFunction = nullptr;
+	bool			bPerInstructionCallbacks = false;	// analyse per instruction rather than per tick
+	FZXInstructionInfo	CurrentInstruction = {};	// accesses buffered for the per instruction callback
 
 	FRZXManager		RZXManager;
 	int				RZXFetchesRemaining = 0;
@@ -0,0 +1,50 @@
+#include "SpectrumReverseExecution.h"
+
+#include "SpectrumEmu.h"
+#include "ZXChipsImpl.h"
+
+#include <cstring>
+
+// safety net in case a replay never reaches its target
+static const uint32_t kMaxReplayTicks = 100 * 70000;	// ~100 frames
+
+static bool GetReplayIOInput(uint16_t port, uint8_t* pInVal, void* pUserData)
+{
+	FSpectrumEmu* pEmu = (FSpectrumEmu*)pUserData;
+	return pEmu->GetCodeAnalysis().Debugger.GetReverseExecution().GetRecordedIORead(port, *pInVal);
+}
+
+size_t FZXReverseExecutionMachine::GetMachineStateSize() const
+{
+	return sizeof(zx_t);
+}
+
+// zx_t only contains pointers to itself or things that don't move so it can be copied as is
+void FZXReverseExecutionMachine::SaveMachineState(void* pDest, uint64_t pins)
+{
+	zx_t& zx = pSpectrumEmu->ZXEmuState;
+	zx.pins = pins;	// only written back at the end of execution so do it here
+	memcpy(pDest, &zx, sizeof(zx_t));
+}
+
+void FZXReverseExecutionMachine::RestoreMachineState(const void* pSrc)
+{
+	zx_t& zx = pSpectrumEmu->ZXEmuState;
+	memcpy(&zx, pSrc, sizeof(zx_t));
+
+	// Set code analysis banks
+	if (zx.type == ZX_TYPE_128)
+	{
+		pSpectrumEmu->SetROMBank(zx.last_mem_config & (1 << 4) ? 1 : 0);
+		pSpectrumEmu->SetRAMBank(3, zx.last_mem_config & 0x7);
+	}
+
+	pSpectrumEmu->GetCodeAnalysis().SetAllBanksDirty();
+	pSpectrumEmu->FrameTraceViewer.InvalidateMemoryHistory();
+}
+
+void FZXReverseExecutionMachine::ReplayUntilStopped()
+{
+	pSpectrumEmu->UpdateTickFunction();
+	ZXExeEmu_UntilStopped(&pSpectrumEmu->ZXEmuState, kMaxReplayTicks, GetReplayIOInput, pSpectrumEmu);
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "CodeAnalyser/ReverseExecution.h"
+
+class FSpectrumEmu;
+
+// Lets the debugger checkpoint & restore the whole zx_t for reverse stepping
+class FZXReverseExecutionMachine : public IReverseExecutionMachine
+{
+public:
+	// IReverseExecutionMachine
+	size_t	GetMachineStateSize() const override;
+	void	SaveMachineState(void* pDest, uint64_t pins) override;
+	void	RestoreMachineState(const void* pSrc) override;
+	void	ReplayUntilStopped() override;
+	// ~IReverseExecutionMachine
+
+	void Init(FSpectrumEmu* pEmu) { pSpectrumEmu = pEmu; }
+
+private:
+	FSpectrumEmu* pSpectrumEmu = nullptr;
+};
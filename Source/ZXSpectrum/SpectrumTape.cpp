@@ -0,0 +1,181 @@
+#include "SpectrumTape.h"
+
+#include "SpectrumEmu.h"
+#include "ZXSpectrumConfig.h"
+#include "Debug/DebugLog.h"
+
+#include <algorithm>
+
+// 48K ROM addresses
+static const uint16_t kLoadBytesTrapAddress = 0x056c;	// LD-START - LD-BYTES has set up the border, flag & return address
+static const uint16_t kLoadBytesReturnAddress = 0x05e2;	// RET to SA/LD-RET which restores the border & interrupts
+static const uint16_t kLoadBytesResumeAddress = 0x056f;	// after the trapped 'CALL LD-EDGE-1' returns
+
+static bool LoadBytesTrap(uint16_t pc, uint16_t* pNewPC, void* pUserData)
+{
+	return ((FSpectrumTape*)pUserData)->OnLoadBytesTrap(pNewPC);
+}
+
+// flags after 'CP 1' - the ROM's parity check, carry is set when the parity is 0
+static uint8_t GetCompareOneFlags(uint8_t a)
+{
+	const uint8_t result = a - 1;
+	uint8_t f = Z80_NF;
+	f |= result ? (result & Z80_SF) : Z80_ZF;
+	f |= (a ^ 1 ^ result) & Z80_HF;
+	f |= (((a ^ 1) & (a ^ result)) & 0x80) >> 5;	// overflow
+	if (a < 1)
+		f |= Z80_CF;
+	return f;
+}
+
+void FSpectrumTape::Init(FSpectrumEmu* pEmu)
+{
+	pSpectrumEmu = pEmu;
+	bInstantLoad = pEmu->GetZXSpectrumGlobalConfig()->bInstantTapeLoad;
+}
+
+void FSpectrumTape::Insert(std::vector<FSpectrumTapeBlock>& blocks)
+{
+	Blocks = std::move(blocks);
+	CurrentBlock = 0;
+	UpdateTrap();
+}
+
+void FSpectrumTape::Eject()
+{
+	Blocks.clear();
+	CurrentBlock = 0;
+	UpdateTrap();
+}
+
+// the trap is removed at a custom loader's block, so it needs putting back
+void FSpectrumTape::Rewind()
+{
+	CurrentBlock = 0;
+	UpdateTrap();
+}
+
+void FSpectrumTape::SetInstantLoad(bool bEnable)
+{
+	bInstantLoad = bEnable;
+	UpdateTrap();
+}
+
+void FSpectrumTape::UpdateTrap()
+{
+	if (bInstantLoad && IsInserted())
+		ZXSetInstructionTrap(kLoadBytesTrapAddress, LoadBytesTrap, this);
+	else
+		ZXSetInstructionTrap(0, nullptr, nullptr);
+}
+
+// the 128K machines only have LD-BYTES in the 48 BASIC ROM
+bool FSpectrumTape::IsLoadBytesROMPagedIn() const
+{
+	if (pSpectrumEmu->ZXEmuState.type == ZX_TYPE_128)
+		return pSpectrumEmu->CurROMBank == pSpectrumEmu->ROMBanks[1];
+
+	return true;
+}
+
+// Load or verify the next block in place of LD-BYTES
+// On entry A' is the expected flag byte, F' carry is set for LOAD & clear for VERIFY, DE is the length & IX the destination.
+// On exit carry is set on success, DE & IX are advanced by the bytes read and B, H & L are left as the ROM would leave them.
+bool FSpectrumTape::OnLoadBytesTrap(uint16_t* pReturnPC)
+{
+	if (IsLoadBytesROMPagedIn() == false || CurrentBlock >= (int)Blocks.size())
+		return false;
+
+	const FSpectrumTapeBlock& block = Blocks[CurrentBlock];
+	if (block.bStandardSpeed == false)
+	{
+		LOGWARNING("Tape block %d is for a custom loader, it can't be loaded instantly", CurrentBlock);
+		ZXSetInstructionTrap(0, nullptr, nullptr);	// leave the rest of the tape alone
+		return false;
+	}
+	CurrentBlock++;
+
+	// registers & memory change outside of the CPU & replays don't run the trap, so the histories can't be stepped back through
+	pSpectrumEmu->FrameTraceViewer.InvalidateMemoryHistory();
+	pSpectrumEmu->GetCodeAnalysis().Debugger.GetReverseExecution().Reset();
+
+	z80_t& cpu = pSpectrumEmu->ZXEmuState.cpu;
+	const uint8_t expectedFlag = cpu.af2 >> 8;
+	const bool bVerify = (cpu.af2 & Z80_CF) == 0;
+	const int blockLength = (int)block.Data.size();
+	*pReturnPC = kLoadBytesReturnAddress;
+
+	// the CALL at the trap has been registered as executed, jumping away from it would look like a call taken
+	// make it look like the call returned so the debugger doesn't push a call stack frame for every block
+	pSpectrumEmu->PreviousPC = kLoadBytesResumeAddress;
+
+	// no flag byte
+	if (blockLength == 0)
+	{
+		cpu.hl = (cpu.hl & 0xff00) | 0x01;
+		cpu.af2 = (cpu.af2 & 0xff00) | 0x01;
+		cpu.af &= ~Z80_CF;
+		return true;
+	}
+
+	cpu.af2 = 0x0145;
+	uint8_t parity = block.Data[0];
+	if (parity != expectedFlag)
+	{
+		cpu.hl = (cpu.hl & 0xff00) | parity;
+		cpu.af &= ~Z80_CF;
+		return true;
+	}
+
+	const int noBytes = std::min(blockLength - 1, (int)cpu.de);
+	uint8_t lastByte = block.Data[noBytes];
+	bool bFailed = false;
+	int byteNo = 0;
+	for (; byteNo < noBytes; byteNo++)
+	{
+		const uint8_t val = block.Data[byteNo + 1];
+		const uint16_t address = cpu.ix + byteNo;
+		parity ^= val;
+
+		if (bVerify == false)
+		{
+			pSpectrumEmu->WriteByte(address, val);
+		}
+		else if (pSpectrumEmu->ReadByte(address) != val)
+		{
+			lastByte = val;
+			bFailed = true;
+			break;
+		}
+	}
+
+	if (bFailed)
+	{
+		cpu.af &= ~Z80_CF;
+	}
+	else if (cpu.de == byteNo && noBytes + 1 < blockLength)
+	{
+		// read the checksum & do the parity check
+		parity ^= block.Data[noBytes + 1];
+		cpu.af = (parity << 8) | GetCompareOneFlags(parity);
+		cpu.bc = (0xb0 << 8) | (cpu.bc & 0xff);
+	}
+	else
+	{
+		// ran out of block - the ROM fails to read the next byte's first edge with B at 0
+		lastByte = 0x01;
+		cpu.af = (cpu.af & 0xff00) | Z80_ZF | Z80_HF;
+		cpu.bc = cpu.bc & 0xff;
+	}
+
+	cpu.hl = (parity << 8) | lastByte;
+	cpu.de -= byteNo;
+	cpu.ix += byteNo;
+
+	// memory has changed behind the write tracking's back
+	if (bVerify == false && byteNo > 0)
+		pSpectrumEmu->GetCodeAnalysis().SetAllBanksDirty();
+
+	return true;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+class FSpectrumEmu;
+
+// Tape block as the ROM loader sees it
+struct FSpectrumTapeBlock
+{
+	std::vector<uint8_t>	Data;	// flag byte, data & checksum
+	bool					bStandardSpeed = true;	// ROM timings - can be loaded by the trap
+};
+
+// Tape that loads instantly by trapping the ROM's LD-BYTES routine
+// Standard speed blocks are copied straight into memory with the registers & flags the ROM would leave.
+// Blocks for custom loaders can't be trapped, loading stops at the first one.
+// Instant load can be turned off to leave LD-BYTES running for analysis.
+class FSpectrumTape
+{
+public:
+	void	Init(FSpectrumEmu* pEmu);
+	void	Insert(std::vector<FSpectrumTapeBlock>& blocks);
+	void	Eject();
+	void	Rewind();
+
+	bool	IsInserted() const { return Blocks.empty() == false; }
+	int		GetNoBlocks() const { return (int)Blocks.size(); }
+	int		GetCurrentBlock() const { return CurrentBlock; }
+
+	void	SetInstantLoad(bool bEnable);
+	bool	IsInstantLoadEnabled() const { return bInstantLoad; }
+
+	bool	OnLoadBytesTrap(uint16_t* pReturnPC);
+
+private:
+	bool	IsLoadBytesROMPagedIn() const;
+	void	UpdateTrap();
+
+	FSpectrumEmu*	pSpectrumEmu = nullptr;
+	std::vector<FSpectrumTapeBlock>	Blocks;
+	int				CurrentBlock = 0;
+	bool			bInstantLoad = true;
+};
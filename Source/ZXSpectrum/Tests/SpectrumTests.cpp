@@ -62,6 +62,37 @@ TEST_F(FSpectrumEmuTest, SnapshotLoaderTest)
 
 };
 
+TEST_F(FSpectrumEmuTest, MachineFrameLengthTest)
+{
+	ASSERT_NE(pEmu, nullptr);
+
+	// 69888 ticks at 3.5MHz
+	const uint32_t frameMicroSeconds = pEmu->GetMachineFrameMicroSeconds();
+	EXPECT_NEAR(frameMicroSeconds, 19968, 1);
+};
+
+// a loader's edge detect loop polls the ULA port with interrupts off, auto warp should hold on for the whole load
+TEST_F(FSpectrumEmuTest, AutoWarpHoldsWhileLoadingTest)
+{
+	ASSERT_NE(pEmu, nullptr);
+
+	// DI then a loop as fast as the ROM's LD-SAMPLE: INC B, LD A,$7F, IN A,($FE), RRA, XOR C, AND $20, JR loop
+	const uint8_t edgeLoop[] = { 0xF3, 0x04, 0x3E, 0x7F, 0xDB, 0xFE, 0x1F, 0xA9, 0xE6, 0x20, 0x18, 0xF5 };
+	for (int i = 0; i < (int)sizeof(edgeLoop); i++)
+		pEmu->WriteByte(0x8000 + i, edgeLoop[i]);
+	pEmu->ZXEmuState.cpu.pc = 0x8000;
+
+	pEmu->SetAutoWarpWhenLoading(true);
+	pEmu->GetCodeAnalysis().Debugger.Continue();
+
+	// 60Hz host frames, the first runs normally & the rest warp
+	for (int hostFrame = 0; hostFrame < 10; hostFrame++)
+	{
+		pEmu->ExecuteHostFrame(16667);
+		EXPECT_TRUE(pEmu->IsAutoWarping());
+	}
+};
+
 
 // needed to get it compiling
 //void SetWindowTitle(const char* pTitle) {}
@@ -0,0 +1,273 @@
+#include "FrameMemoryHistory.h"
+#include "FrameTraceViewer.h"
+
+#include <cstring>
+
+// Simple RLE, runs of 3 or more bytes are stored as a run
+// control byte 0x00-0x7f: 1-128 literal bytes follow
+// control byte 0x80-0xff: next byte is repeated 3-130 times
+static void RLEEncode(const uint8_t* pSrc, int size, std::vector<uint8_t>& out)
+{
+	int pos = 0;
+	while (pos < size)
+	{
+		int runLength = 1;
+		while (pos + runLength < size && runLength < 130 && pSrc[pos + runLength] == pSrc[pos])
+			runLength++;
+
+		if (runLength >= 3)
+		{
+			out.push_back((uint8_t)(0x80 | (runLength - 3)));
+			out.push_back(pSrc[pos]);
+			pos += runLength;
+		}
+		else
+		{
+			// gather literals until the next run starts
+			int literalEnd = pos;
+			while (literalEnd < size && literalEnd - pos < 128)
+			{
+				if (literalEnd + 2 < size && pSrc[literalEnd] == pSrc[literalEnd + 1] && pSrc[literalEnd] == pSrc[literalEnd + 2])
+					break;
+				literalEnd++;
+			}
+
+			out.push_back((uint8_t)(literalEnd - pos - 1));
+			out.insert(out.end(), pSrc + pos, pSrc + literalEnd);
+			pos = literalEnd;
+		}
+	}
+}
+
+// returns pointer to the data after the encoded block
+static const uint8_t* RLEDecode(const uint8_t* pSrc, uint8_t* pDest, int size)
+{
+	int pos = 0;
+	while (pos < size)
+	{
+		const uint8_t control = *pSrc++;
+		if (control & 0x80)
+		{
+			const int runLength = (control & 0x7f) + 3;
+			memset(pDest + pos, *pSrc++, runLength);
+			pos += runLength;
+		}
+		else
+		{
+			const int literalLength = control + 1;
+			memcpy(pDest + pos, pSrc, literalLength);
+			pSrc += literalLength;
+			pos += literalLength;
+		}
+	}
+	return pSrc;
+}
+
+void FFrameMemoryHistory::Init(int noBanks, int maxFrames)
+{
+	NoBanks = noBanks;
+	MaxFrames = maxFrames;
+	Shadow.resize(NoBanks * FFrameMemoryState::kBankSize);
+	Reset();
+}
+
+void FFrameMemoryHistory::Reset()
+{
+	Frames.clear();
+	DataSize = 0;
+	FramesSinceKeyFrame = 0;
+	bForceKeyFrame = true;
+	memset(DirtyPages, 0, sizeof(DirtyPages));
+}
+
+void FFrameMemoryHistory::SetMaxFrames(int maxFrames)
+{
+	MaxFrames = maxFrames > 1 ? maxFrames : 1;
+	TrimHistory();
+}
+
+void FFrameMemoryHistory::WritePage(FFrameRecord& record, int bankNo, int pageNo, const uint8_t* pPageData)
+{
+	record.Data.push_back((uint8_t)bankNo);
+	record.Data.push_back((uint8_t)pageNo);
+	RLEEncode(pPageData, kPageSize, record.Data);
+}
+
+void FFrameMemoryHistory::CaptureFrame(uint8_t* const* pBanks, uint8_t memoryBankRegister, const z80_t& cpuState)
+{
+	const bool bKeyFrame = bForceKeyFrame || Frames.empty() || FramesSinceKeyFrame >= kKeyFrameInterval;
+
+	FFrameRecord& record = Frames.emplace_back();
+	record.bKeyFrame = bKeyFrame;
+	record.MemoryBankRegister = memoryBankRegister;
+	record.CPUState = cpuState;
+
+	if (bKeyFrame)
+	{
+		for (int bankNo = 0; bankNo < NoBanks; bankNo++)
+		{
+			for (int pageNo = 0; pageNo < kPagesPerBank; pageNo++)
+				WritePage(record, bankNo, pageNo, pBanks[bankNo] + pageNo * kPageSize);
+
+			memcpy(&Shadow[bankNo * FFrameMemoryState::kBankSize], pBanks[bankNo], FFrameMemoryState::kBankSize);
+		}
+		FramesSinceKeyFrame = 0;
+	}
+	else
+	{
+		// only look at the pages that have been written to
+		uint8_t xorPage[kPageSize];
+		for (int bankNo = 0; bankNo < NoBanks; bankNo++)
+		{
+			const uint16_t dirtyPages = DirtyPages[bankNo];
+			if (dirtyPages == 0)
+				continue;
+
+			for (int pageNo = 0; pageNo < kPagesPerBank; pageNo++)
+			{
+				if ((dirtyPages & (1 << pageNo)) == 0)
+					continue;
+
+				const uint8_t* pPage = pBanks[bankNo] + pageNo * kPageSize;
+				uint8_t* pShadowPage = &Shadow[bankNo * FFrameMemoryState::kBankSize + pageNo * kPageSize];
+				bool bChanged = false;
+				for (int i = 0; i < kPageSize; i++)
+				{
+					xorPage[i] = pPage[i] ^ pShadowPage[i];
+					bChanged |= xorPage[i] != 0;
+				}
+
+				if (bChanged)	// pages can be written with the same values
+				{
+					WritePage(record, bankNo, pageNo, xorPage);
+					memcpy(pShadowPage, pPage, kPageSize);
+				}
+			}
+		}
+		FramesSinceKeyFrame++;
+	}
+
+	record.Data.shrink_to_fit();
+	DataSize += record.Data.size();
+	memset(DirtyPages, 0, sizeof(DirtyPages));
+	bForceKeyFrame = false;
+
+	TrimHistory();
+}
+
+// Remove the oldest frames a key frame group at a time so the history always starts with a key frame
+void FFrameMemoryHistory::TrimHistory()
+{
+	while ((int)Frames.size() > MaxFrames)
+	{
+		int nextKeyFrame = 1;
+		while (nextKeyFrame < (int)Frames.size() && Frames[nextKeyFrame].bKeyFrame == false)
+			nextKeyFrame++;
+
+		if (nextKeyFrame == (int)Frames.size() || (int)Frames.size() - nextKeyFrame < MaxFrames)
+			break;
+
+		for (int i = 0; i < nextKeyFrame; i++)
+		{
+			DataSize -= Frames.front().Data.size();
+			Frames.pop_front();
+		}
+	}
+}
+
+void FFrameMemoryHistory::ApplyRecord(const FFrameRecord& record, FFrameMemoryState& state) const
+{
+	const uint8_t* pData = record.Data.data();
+	const uint8_t* pDataEnd = pData + record.Data.size();
+	uint8_t xorPage[kPageSize];
+
+	while (pData < pDataEnd)
+	{
+		const int bankNo = *pData++;
+		const int pageNo = *pData++;
+		uint8_t* pPage = &state.MemoryBanks[bankNo][pageNo * kPageSize];
+
+		if (record.bKeyFrame)
+		{
+			pData = RLEDecode(pData, pPage, kPageSize);
+		}
+		else
+		{
+			pData = RLEDecode(pData, xorPage, kPageSize);
+			for (int i = 0; i < kPageSize; i++)
+				pPage[i] ^= xorPage[i];
+		}
+	}
+
+	state.MemoryBankRegister = record.MemoryBankRegister;
+	state.CPUState = record.CPUState;
+}
+
+bool FFrameMemoryHistory::GetFrameState(int framesBack, FFrameMemoryState& outState) const
+{
+	const int frameIndex = (int)Frames.size() - 1 - framesBack;
+	if (frameIndex < 0 || framesBack < 0)
+		return false;
+
+	int keyFrameIndex = frameIndex;
+	while (Frames[keyFrameIndex].bKeyFrame == false)
+		keyFrameIndex--;
+
+	for (int i = keyFrameIndex; i <= frameIndex; i++)
+		ApplyRecord(Frames[i], outState);
+
+	return true;
+}
+
+bool FFrameMemoryHistory::GetFrameDiff(int framesBack, std::vector<FMemoryDiff>& outDiff) const
+{
+	outDiff.clear();
+
+	const int frameIndex = (int)Frames.size() - 1 - framesBack;
+	if (frameIndex < 1 || framesBack < 0)
+		return false;
+
+	FFrameMemoryState* pState = new FFrameMemoryState;
+	FFrameMemoryState* pPrevState = new FFrameMemoryState;
+	GetFrameState(framesBack + 1, *pPrevState);
+	GetFrameState(framesBack, *pState);
+
+	for (int bankNo = 0; bankNo < NoBanks; bankNo++)
+	{
+		for (int addr = 0; addr < FFrameMemoryState::kBankSize; addr++)
+		{
+			if (pState->MemoryBanks[bankNo][addr] != pPrevState->MemoryBanks[bankNo][addr])
+			{
+				FMemoryDiff diff;
+				diff.Bank = bankNo;
+				diff.Address = addr;
+				diff.NewVal = pState->MemoryBanks[bankNo][addr];
+				diff.OldVal = pPrevState->MemoryBanks[bankNo][addr];
+				outDiff.push_back(diff);
+			}
+		}
+	}
+
+	delete pState;
+	delete pPrevState;
+	return true;
+}
+
+void FFrameMemoryHistory::RewindTo(int framesBack, const FFrameMemoryState& state)
+{
+	for (int i = 0; i < framesBack && Frames.empty() == false; i++)
+	{
+		DataSize -= Frames.back().Data.size();
+		Frames.pop_back();
+	}
+
+	for (int bankNo = 0; bankNo < NoBanks; bankNo++)
+		memcpy(&Shadow[bankNo * FFrameMemoryState::kBankSize], state.MemoryBanks[bankNo], FFrameMemoryState::kBankSize);
+
+	memset(DirtyPages, 0, sizeof(DirtyPages));
+
+	FramesSinceKeyFrame = 0;
+	for (int i = (int)Frames.size() - 1; i >= 0 && Frames[i].bKeyFrame == false; i--)
+		FramesSinceKeyFrame++;
+	bForceKeyFrame = Frames.empty();
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chips/z80.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+struct FMemoryDiff;
+
+// Machine state for a single frame, reconstructed from the history
+struct FFrameMemoryState
+{
+	static const int	kNoBanks = 8;
+	static const int	kBankSize = 16 * 1024;
+
+	uint8_t		MemoryBanks[kNoBanks][kBankSize];	// 8 x 16K banks
+	uint8_t		MemoryBankRegister = 0;
+	z80_t		CPUState;
+};
+
+// Frame by frame RAM history
+// Stores a compressed key frame every kKeyFrameInterval frames, other frames store only the 1K pages
+// written during that frame as RLE compressed XOR deltas against the previous frame
+class FFrameMemoryHistory
+{
+public:
+	void	Init(int noBanks, int maxFrames);
+	void	Reset();
+	void	SetMaxFrames(int maxFrames);
+	int		GetMaxFrames() const { return MaxFrames; }
+
+	// called from the memory write path
+	void	MarkWritten(int bankNo, uint16_t bankOffset) { DirtyPages[bankNo] |= 1 << (bankOffset >> kPageShift); }
+
+	void	CaptureFrame(uint8_t* const* pBanks, uint8_t memoryBankRegister, const z80_t& cpuState);
+
+	// frames are indexed backwards from the most recent, which is 0
+	int		GetNoFrames() const { return (int)Frames.size(); }
+	bool	GetFrameState(int framesBack, FFrameMemoryState& outState) const;
+	bool	GetFrameDiff(int framesBack, std::vector<FMemoryDiff>& outDiff) const;
+
+	// throw away frames after the given one and continue from its state
+	void	RewindTo(int framesBack, const FFrameMemoryState& state);
+
+	// memory has been changed outside the write path so next frame needs to be a key frame
+	void	Invalidate() { bForceKeyFrame = true; }
+
+	size_t	GetMemoryUsage() const { return DataSize; }
+
+	static const int	kPageSize = 1024;
+	static const int	kPageShift = 10;
+	static const int	kPagesPerBank = FFrameMemoryState::kBankSize / kPageSize;
+	static const int	kKeyFrameInterval = 250;	// 5 seconds
+
+private:
+	struct FFrameRecord
+	{
+		bool					bKeyFrame = false;
+		uint8_t					MemoryBankRegister = 0;
+		z80_t					CPUState;
+		std::vector<uint8_t>	Data;	// [bank][page][RLE page data] blocks
+	};
+
+	void	WritePage(FFrameRecord& record, int bankNo, int pageNo, const uint8_t* pPageData);
+	void	ApplyRecord(const FFrameRecord& record, FFrameMemoryState& state) const;
+	void	TrimHistory();
+
+	int							NoBanks = 0;
+	int							MaxFrames = 0;
+	std::deque<FFrameRecord>	Frames;	// oldest first, first is always a key frame
+	std::vector<uint8_t>		Shadow;	// memory as of the last captured frame
+	uint16_t					DirtyPages[FFrameMemoryState::kNoBanks] = { 0 };	// bit per page
+	int							FramesSinceKeyFrame = 0;
+	bool						bForceKeyFrame = true;
+	size_t						DataSize = 0;
+};
@@ -9,19 +9,31 @@
 #include <Util/Misc.h>
 
 
+static const int kFramesPerSecond = 50;
+
+static int GetNoRAMBanks(const zx_t& zxState)
+{
+	return zxState.type == ZX_TYPE_48K ? 3 : 8;
+}
+
 void FFrameTraceViewer::Init(FSpectrumEmu* pEmu)
 {
 	pSpectrumEmu = pEmu;
-	chips_display_info_t dispInfo = zx_display_info(&pEmu->ZXEmuState);
 
-	// Init Frame Trace
+	// Init Frame Trace - batch builds don't capture frames
+#ifndef BATCH
+	chips_display_info_t dispInfo = zx_display_info(&pEmu->ZXEmuState);
 	for (int i = 0; i < kNoFramesInTrace; i++)
 	{
 		FrameTrace[i].Texture = ImGui_CreateTextureRGBA(pSpectrumEmu->SpectrumViewer.GetFrameBuffer(), dispInfo.frame.dim.width, dispInfo.frame.dim.height);
-		FrameTrace[i].CPUState = malloc(sizeof(z80_t));
 	}
+#endif
+
+	MemoryHistory.Init(GetNoRAMBanks(pEmu->ZXEmuState), HistoryLengthSeconds * kFramesPerSecond);
+	pHistoryState = new FFrameMemoryState;
 
 	ShowWritesView = new FZXGraphicsView(320, 256);
+	HistoryScreenView = new FZXGraphicsView(256, 192);
 }
 
 void FFrameTraceViewer::Reset()
@@ -33,7 +45,13 @@ void FFrameTraceViewer::Reset()
 		frame.FrameEvents.clear();
 		frame.FrameOverview.clear();
 		frame.MemoryDiffs.clear();
+		frame.bMemoryDiffsGenerated = false;
 	}
+	NoTraceFrames = 0;
+	ShowFrame = 0;
+
+	// machine type could have changed
+	MemoryHistory.Init(GetNoRAMBanks(pSpectrumEmu->ZXEmuState), HistoryLengthSeconds * kFramesPerSecond);
 }
 
 void	FFrameTraceViewer::Shutdown()
@@ -42,11 +60,16 @@ void	FFrameTraceViewer::Shutdown()
 	{
 		ImGui_FreeTexture(FrameTrace[i].Texture);
 		FrameTrace[i].Texture = nullptr;
-		free(FrameTrace[i].CPUState);
 	}
 
+	MemoryHistory.Reset();
+	delete pHistoryState;
+	pHistoryState = nullptr;
+
 	delete ShowWritesView;
 	ShowWritesView = nullptr;
+	delete HistoryScreenView;
+	HistoryScreenView = nullptr;
 }
 
 
@@ -55,40 +78,39 @@ void FFrameTraceViewer::CaptureFrame()
 	// set up new trace frame
 	FCodeAnalysisState& codeAnalysis = pSpectrumEmu->GetCodeAnalysis();
 	FSpeccyFrameTrace& frame = FrameTrace[CurrentTraceFrame];
-	ImGui_UpdateTextureRGBA(frame.Texture, pSpectrumEmu->SpectrumViewer.GetFrameBuffer());
+	if (pSpectrumEmu->IsWarping() == false)	// screens aren't captured in warp mode
+		ImGui_UpdateTextureRGBA(frame.Texture, pSpectrumEmu->SpectrumViewer.GetFrameBuffer());
 	frame.InstructionTrace = codeAnalysis.Debugger.GetFrameTrace();	// copy frame trace - use method?
 	frame.FrameEvents = codeAnalysis.Debugger.GetEventTrace();
 	frame.FrameOverview.clear();
+	frame.MemoryDiffs.clear();
+	frame.bMemoryDiffsGenerated = false;
 
-	// copy memory
-	const int noBanks = pSpectrumEmu->ZXEmuState.type == ZX_TYPE_48K ? 3:8;
-	for (int i = 0; i < noBanks; i++)
-		memcpy(frame.MemoryBanks[i], pSpectrumEmu->ZXEmuState.ram[i], 16 * 1024);
-
-	frame.MemoryBankRegister = pSpectrumEmu->ZXEmuState.last_mem_config;
+	// store memory & CPU state - only pages written to this frame get stored
+	uint8_t* banks[FFrameMemoryState::kNoBanks];
+	for (int i = 0; i < FFrameMemoryState::kNoBanks; i++)
+		banks[i] = pSpectrumEmu->ZXEmuState.ram[i];
 
-	// get CPU state
-	memcpy(frame.CPUState, &pSpectrumEmu->ZXEmuState.cpu, sizeof(z80_t));
-
-	// Generate diffs
-	const int prevFrameIndex = CurrentTraceFrame == 0 ? kNoFramesInTrace - 1 : CurrentTraceFrame - 1;
-	const FSpeccyFrameTrace& prevFrame = FrameTrace[prevFrameIndex];
-
-	// Not used atm
-	//GenerateMemoryDiff(frame, prevFrame, frame.MemoryDiffs);
+	MemoryHistory.CaptureFrame(banks, pSpectrumEmu->ZXEmuState.last_mem_config, pSpectrumEmu->ZXEmuState.cpu);
 
+	NoTraceFrames = std::min(NoTraceFrames + 1, kNoFramesInTrace);
 	if (++CurrentTraceFrame == kNoFramesInTrace)
 		CurrentTraceFrame = 0;
 }
 
 
-void FFrameTraceViewer::RestoreFrame(const FSpeccyFrameTrace& frame)
+bool FFrameTraceViewer::RestoreFrame(int framesBack)
 {
+	if (MemoryHistory.GetFrameState(framesBack, *pHistoryState) == false)
+		return false;
+
+	const FFrameMemoryState& frame = *pHistoryState;
+
 	// restore CPU regs
-	memcpy(&pSpectrumEmu->ZXEmuState.cpu, frame.CPUState, sizeof(z80_t));
+	memcpy(&pSpectrumEmu->ZXEmuState.cpu, &frame.CPUState, sizeof(z80_t));
 
 	// restore memory
-	const int noBanks = pSpectrumEmu->ZXEmuState.type == ZX_TYPE_48K ? 3 : 8;
+	const int noBanks = GetNoRAMBanks(pSpectrumEmu->ZXEmuState);
 	for (int i = 0; i < noBanks; i++)
 		memcpy(pSpectrumEmu->ZXEmuState.ram[i],frame.MemoryBanks[i],  16 * 1024);
 
@@ -113,23 +135,56 @@ void FFrameTraceViewer::RestoreFrame(const FSpeccyFrameTrace& frame)
 		pSpectrumEmu->SetROMBank(frame.MemoryBankRegister & (1 << 4) ? 1 : 0);
 		pSpectrumEmu->SetRAMBank(3, frame.MemoryBankRegister & 0x7);
 	}
+
+	// memory has changed behind the write tracking's back
+	MemoryHistory.Invalidate();
+	pSpectrumEmu->GetCodeAnalysis().Debugger.GetReverseExecution().Reset();
+	return true;
+}
+
+// Draw the screen from a reconstructed frame - for frames older than the frame trace
+void FFrameTraceViewer::DrawHistoryScreen(const FFrameMemoryState& state)
+{
+	const bool b48K = pSpectrumEmu->ZXEmuState.type == ZX_TYPE_48K;
+	const int screenBank = b48K ? 0 : ((state.MemoryBankRegister & (1 << 3)) ? 7 : 5);
+	const uint8_t* pScreenMem = state.MemoryBanks[screenBank];
+
+	for (int y = 0; y < 192; y++)
+	{
+		for (int x = 0; x < 256; x += 8)
+		{
+			const uint8_t pixels = pScreenMem[GetScreenPixMemoryAddress(x, y) - 0x4000];
+			const uint8_t attr = pScreenMem[GetScreenAttrMemoryAddress(x, y) - 0x4000];
+			HistoryScreenView->DrawCharLine(pixels, x, y, attr);
+		}
+	}
 }
 
 void FFrameTraceViewer::Draw()
 {
 	FCodeAnalysisState& codeAnalysis = pSpectrumEmu->GetCodeAnalysis();
+	const int noHistoryFrames = std::max(MemoryHistory.GetNoFrames(), 1);
+
 	if (ImGui::ArrowButton("##left", ImGuiDir_Left))
 		ShowFrame = std::max(--ShowFrame, 0);
 
 	ImGui::SameLine();
 
 	if (ImGui::ArrowButton("##right", ImGuiDir_Right))
-		ShowFrame = std::min(++ShowFrame, kNoFramesInTrace - 1);
+		ShowFrame = std::min(++ShowFrame, noHistoryFrames - 1);
 
 	ImGui::SameLine();
 	int frameNo = 0;
+	const bool bScrubbed = ImGui::SliderInt("Backwards Offset", &ShowFrame, 0, noHistoryFrames - 1);
+	ShowFrame = std::min(ShowFrame, noHistoryFrames - 1);
+
+	// only recent frames have a full trace
+	const bool bHasTrace = ShowFrame < NoTraceFrames;
+	frameNo = CurrentTraceFrame - ShowFrame - 1;
+	if (frameNo < 0)
+		frameNo += kNoFramesInTrace;
 
-	if (ImGui::SliderInt("Backwards Offset", &ShowFrame, 0, kNoFramesInTrace - 1))
+	if (bScrubbed)
 	{
 		if (ShowFrame == 0)
 			codeAnalysis.Debugger.Continue();
@@ -138,36 +193,50 @@ void FFrameTraceViewer::Draw()
 
 		PixelWriteline = -1;
 		SelectedTraceLine = -1;
-		frameNo = CurrentTraceFrame - ShowFrame - 1;
-		if (frameNo < 0)
-			frameNo += kNoFramesInTrace;
-		DrawFrameScreenWritePixels(FrameTrace[frameNo]);
+		if (bHasTrace)
+			DrawFrameScreenWritePixels(FrameTrace[frameNo]);
+		else if (MemoryHistory.GetFrameState(ShowFrame, *pHistoryState))
+			DrawHistoryScreen(*pHistoryState);
 
 		if (RestoreOnScrub)
-			RestoreFrame(FrameTrace[frameNo]);
+			RestoreFrame(ShowFrame);
 	}
-	else
-	{
-		frameNo = CurrentTraceFrame - ShowFrame - 1;
-		if (frameNo < 0)
-			frameNo += kNoFramesInTrace;
-	}
-	const FSpeccyFrameTrace& frame = FrameTrace[frameNo];
+	FSpeccyFrameTrace& frame = FrameTrace[frameNo];
 	
 
 	if (ImGui::Button("Restore"))
 	{
-		RestoreFrame(frame);
-
-		// continue running
-		codeAnalysis.Debugger.Continue();
+		if (RestoreFrame(ShowFrame))
+		{
+			// drop the frames after the restored one
+			MemoryHistory.RewindTo(ShowFrame, *pHistoryState);
+			NoTraceFrames = std::max(NoTraceFrames - ShowFrame, 0);
+			CurrentTraceFrame = (frameNo + 1) % kNoFramesInTrace;
+			ShowFrame = 0;
 
-		CurrentTraceFrame = frameNo;
-		ShowFrame = 0;
+			// continue running
+			codeAnalysis.Debugger.Continue();
+		}
 	}
 	ImGui::SameLine();
 	ImGui::Checkbox("Restore On Scrub", &RestoreOnScrub);
-	
+	ImGui::SameLine();
+	ImGui::SetNextItemWidth(100.0f);
+	if (ImGui::InputInt("History (secs)", &HistoryLengthSeconds))
+	{
+		HistoryLengthSeconds = std::min(std::max(HistoryLengthSeconds, kNoFramesInTrace / kFramesPerSecond), kMaxHistoryLengthSeconds);
+		MemoryHistory.SetMaxFrames(HistoryLengthSeconds * kFramesPerSecond);
+	}
+	ImGui::SameLine();
+	ImGui::Text("%d frames, %dKB", MemoryHistory.GetNoFrames(), (int)(MemoryHistory.GetMemoryUsage() / 1024));
+
+	if (bHasTrace == false)
+	{
+		HistoryScreenView->Draw();
+		ImGui::Text("No trace for this frame, only memory state is available");
+		return;
+	}
+
 	ImVec2 uv0(0, 0);
 	ImVec2 uv1(320.0f / 512.0f, 1.0f);
 	ImGui::Image(frame.Texture, ImVec2(320, 256), uv0, uv1);
@@ -187,7 +256,7 @@ void FFrameTraceViewer::Draw()
 		if (ImGui::BeginTabItem("Trace Overview"))
 		{
 			if (frame.FrameOverview.size() == 0)
-				GenerateTraceOverview(FrameTrace[frameNo]);
+				GenerateTraceOverview(frame);
 			DrawTraceOverview(frame);
 			ImGui::EndTabItem();
 		}
@@ -200,6 +269,11 @@ void FFrameTraceViewer::Draw()
 
 		if (ImGui::BeginTabItem("Diff"))
 		{
+			if (frame.bMemoryDiffsGenerated == false)
+			{
+				MemoryHistory.GetFrameDiff(ShowFrame, frame.MemoryDiffs);
+				frame.bMemoryDiffsGenerated = true;
+			}
 			DrawMemoryDiffs(frame);
 			ImGui::EndTabItem();
 		}
@@ -301,30 +375,6 @@ void	FFrameTraceViewer::GenerateTraceOverview(FSpeccyFrameTrace& frame)
 	}
 }
 
-void FFrameTraceViewer::GenerateMemoryDiff(const FSpeccyFrameTrace& frame, const FSpeccyFrameTrace& otherFrame, std::vector<FMemoryDiff>& outDiff)
-{
-	outDiff.clear();
-
-	// diff RAM with previous frame
-	// skip ROM & screen memory
-	// might want to exclude stack (once we determine where it is)
-	const int noBanks = pSpectrumEmu->ZXEmuState.type == ZX_TYPE_48K ? 3 : 8;
-	for (int bankNo = 0; bankNo < noBanks; bankNo++)
-	{
-		for (int addr = 0; addr < 16 * 1024; addr++)
-		{
-			if (frame.MemoryBanks[bankNo][addr] != otherFrame.MemoryBanks[bankNo][addr])
-			{
-				FMemoryDiff diff;
-				diff.Address = addr;
-				diff.NewVal = frame.MemoryBanks[bankNo][addr];
-				diff.OldVal = otherFrame.MemoryBanks[bankNo][addr];
-				outDiff.push_back(diff);
-			}
-		}
-	}
-}
-
 void	FFrameTraceViewer::DrawTraceOverview(const FSpeccyFrameTrace& frame)
 {
 	FCodeAnalysisState& state = pSpectrumEmu->GetCodeAnalysis();
@@ -416,8 +466,14 @@ void FFrameTraceViewer::DrawMemoryDiffs(const FSpeccyFrameTrace& frame)
 
 	for (const auto& diff : frame.MemoryDiffs)
 	{
-		ImGui::Text("%s : ", NumStr(diff.Address));
-		DrawAddressLabel(state, viewState, diff.Address);
+		// diff addresses are offsets into a RAM bank
+		const FCodeAnalysisBank* pBank = state.GetBank(pSpectrumEmu->RAMBanks[diff.Bank]);
+		if (pBank == nullptr)
+			continue;
+		const FAddressRef addr(pBank->Id, pBank->GetMappedAddress() + diff.Address);
+
+		ImGui::Text("%s : ", NumStr(addr.Address));
+		DrawAddressLabel(state, viewState, addr);
 		ImGui::SameLine();
 		ImGui::Text("%d(%s) -> %d(%s)", diff.OldVal, NumStr(diff.OldVal), diff.NewVal, NumStr(diff.NewVal));
 	}
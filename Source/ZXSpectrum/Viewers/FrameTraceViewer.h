@@ -2,6 +2,7 @@
 
 
 #include "CodeAnalyser/CodeAnalyser.h"
+#include "FrameMemoryHistory.h"
 
 #include <cstdint>
 #include <vector>
@@ -42,18 +43,17 @@ struct FMemoryDiff
 	uint8_t		NewVal;
 };
 
+// Detailed trace for recent frames - memory & CPU state is held in FFrameMemoryHistory
 struct FSpeccyFrameTrace
 {
 	void*					Texture = nullptr;
-	uint8_t					MemoryBanks[8][16 * 1024];	// 8 x 16K banks
-	uint8_t					MemoryBankRegister = 0;
-	void*					CPUState = nullptr;
 	std::vector<FAddressRef>	InstructionTrace;
 	std::vector<FMemoryAccess>	ScreenPixWrites;
 	std::vector<FEvent>			FrameEvents;
 
 	std::vector<FFrameOverviewItem>	FrameOverview;
 	std::vector<FMemoryDiff>	MemoryDiffs;
+	bool						bMemoryDiffsGenerated = false;
 };
 
 class FFrameTraceViewer
@@ -64,11 +64,14 @@ public:
 	void	Shutdown();
 	void	CaptureFrame();
 	void	Draw();
+
+	void	MarkMemoryWritten(int bankNo, uint16_t bankOffset) { MemoryHistory.MarkWritten(bankNo, bankOffset); }
+	void	InvalidateMemoryHistory() { MemoryHistory.Invalidate(); }
 private:
-	void	RestoreFrame(const FSpeccyFrameTrace& frame);
+	bool	RestoreFrame(int framesBack);
+	void	DrawHistoryScreen(const FFrameMemoryState& state);
 	void	DrawInstructionTrace(const FSpeccyFrameTrace& frame);
 	void	GenerateTraceOverview(FSpeccyFrameTrace& frame);
-	void	GenerateMemoryDiff(const FSpeccyFrameTrace& frameA, const FSpeccyFrameTrace& frameB, std::vector<FMemoryDiff>& outDiff);
 	void	DrawTraceOverview(const FSpeccyFrameTrace& frame);
 	void	DrawFrameScreenWritePixels(const FSpeccyFrameTrace& frame, int lastIndex = -1);
 	void	DrawScreenWrites(const FSpeccyFrameTrace& frame);
@@ -81,6 +84,14 @@ private:
 	bool				RestoreOnScrub = false;
 	static const int	kNoFramesInTrace = 300;
 	FSpeccyFrameTrace	FrameTrace[kNoFramesInTrace];
+	int					NoTraceFrames = 0;	// number of valid entries in FrameTrace
+
+	// memory history can go back further than the frame trace
+	FFrameMemoryHistory	MemoryHistory;
+	FFrameMemoryState*	pHistoryState = nullptr;	// scratch state for reconstructing frames
+	int					HistoryLengthSeconds = 60;
+	static const int	kMaxHistoryLengthSeconds = 600;
+	FZXGraphicsView*	HistoryScreenView = nullptr;
 
 	int		SelectedTraceLine = -1;
 	int		PixelWriteline = -1;
@@ -27,7 +27,9 @@ void FSpectrumViewer::Init(FSpectrumEmu* pEmu)
 	// setup pixel buffer
 	const size_t pixelBufferSize = dispInfo.frame.dim.width * dispInfo.frame.dim.height;
 	FrameBuffer = new uint32_t[pixelBufferSize * 2];
+#ifndef BATCH	// nothing is drawn in batch builds
 	ScreenTexture = ImGui_CreateTextureRGBA(FrameBuffer, dispInfo.frame.dim.width, dispInfo.frame.dim.height);
+#endif
 
 	//SetInputEventHandler(this);
 }
@@ -33,7 +33,7 @@ private:
 	FSpectrumEmu* pSpectrumEmu = nullptr;
 
 	uint32_t*		FrameBuffer;	// pixel buffer to store emu output
-	ImTextureID		ScreenTexture;		// texture 
+	ImTextureID		ScreenTexture = nullptr;		// texture 
 
 	// screen inspector
 	bool		bScreenCharSelected = false;
@@ -70,6 +70,30 @@ uint64_t ReadInputIOTick(uint64_t pins, GetIOInput ioInputCB, void* pUserData)
 	return pins;
 }
 
+// Trap on an instruction address - used to skip ROM routines such as the tape loader
+// Only the normal & per instruction runs check it, replays need to execute what was recorded
+static InstructionTrap	g_InstructionTrapCB = NULL;
+static void*			g_pInstructionTrapUserData = NULL;
+static uint16_t			g_InstructionTrapAddress = 0;
+
+void ZXSetInstructionTrap(uint16_t address, InstructionTrap trapCB, void* pUserData)
+{
+	g_InstructionTrapCB = trapCB;
+	g_pInstructionTrapUserData = pUserData;
+	g_InstructionTrapAddress = address;
+}
+
+static inline uint64_t InstructionTrapTick(zx_t* sys, uint64_t pins)
+{
+	if (g_InstructionTrapCB && z80_opdone(&sys->cpu) && Z80_GET_ADDR(pins) == g_InstructionTrapAddress)
+	{
+		uint16_t newPC = 0;
+		if (g_InstructionTrapCB(g_InstructionTrapAddress, &newPC, g_pInstructionTrapUserData))
+			pins = z80_prefetch(&sys->cpu, newPC);
+	}
+	return pins;
+}
+
 uint32_t ZXExeEmu(zx_t* sys, uint32_t micro_seconds) 
 {
 	CHIPS_ASSERT(sys && sys->valid);
@@ -83,6 +107,7 @@ uint32_t ZXExeEmu(zx_t* sys, uint32_t micro_seconds)
 		{
 			pins = _zx_tick(sys, pins);
 			pins = FloatingBusTick(sys, pins);
+			pins = InstructionTrapTick(sys, pins);
 		}
 	}
 	else 
@@ -93,6 +118,46 @@ uint32_t ZXExeEmu(zx_t* sys, uint32_t micro_seconds)
 			pins = _zx_tick(sys, pins);
 			pins = FloatingBusTick(sys, pins);
 			sys->debug.callback.func(sys->debug.callback.user_data, pins);
+			pins = InstructionTrapTick(sys, pins);
+		}
+	}
+	sys->pins = pins;
+	kbd_update(&sys->kbd, micro_seconds);
+	return num_ticks;
+}
+
+// Run with a callback per instruction rather than per tick
+// The ticks that access memory or IO are buffered in pInstruction and passed to the callback when the instruction completes.
+// pInstruction is owned by the caller so an instruction can span calls.
+uint32_t ZXExeEmu_PerInstruction(zx_t* sys, uint32_t micro_seconds, FZXInstructionInfo* pInstruction, InstructionCallback instructionCB, void* pUserData)
+{
+	CHIPS_ASSERT(sys && sys->valid && pInstruction && instructionCB);
+	const uint32_t num_ticks = clk_us_to_ticks(sys->freq_hz, micro_seconds);
+	uint64_t pins = sys->pins;
+
+	for (uint32_t tick = 0; (tick < num_ticks) && !(*sys->debug.stopped); tick++)
+	{
+		const uint64_t lastPins = pins;
+		pins = _zx_tick(sys, pins);
+		pins = FloatingBusTick(sys, pins);
+		pInstruction->NoTicks++;
+
+		if (z80_opdone(&sys->cpu))
+		{
+			instructionCB(pUserData, pInstruction, pins, lastPins);
+			pInstruction->NoAccesses = 0;
+			pInstruction->NoTicks = 0;
+			pins = InstructionTrapTick(sys, pins);
+		}
+		else if ((pins & (Z80_MREQ | Z80_IORQ)) && (pins & (Z80_RD | Z80_WR)))
+		{
+			if (pInstruction->NoAccesses < kZXMaxInstructionAccesses)
+			{
+				FZXInstructionAccess* pAccess = &pInstruction->Accesses[pInstruction->NoAccesses++];
+				pAccess->Pins = pins;
+				pAccess->LastPins = lastPins;
+				pAccess->ScanlineY = (uint16_t)sys->scanline_y;
+			}
 		}
 	}
 	sys->pins = pins;
@@ -100,9 +165,36 @@ uint32_t ZXExeEmu(zx_t* sys, uint32_t micro_seconds)
 	return num_ticks;
 }
 
+// Run with the debug hook until the debugger stops
+// Used to re-execute from a restored state, IO reads come from the callback so they match the original run
+uint32_t ZXExeEmu_UntilStopped(zx_t* sys, uint32_t maxTicks, GetIOInput ioInputCB, void* pUserData)
+{
+	CHIPS_ASSERT(sys && sys->valid && sys->debug.callback.func);
+	uint64_t pins = sys->pins;
+	uint32_t tick = 0;
+
+	for (; (tick < maxTicks) && !(*sys->debug.stopped); tick++)
+	{
+		pins = _zx_tick(sys, pins);
+		pins = FloatingBusTick(sys, pins);
+		if (ioInputCB)
+			pins = ReadInputIOTick(pins, ioInputCB, pUserData);
+		sys->debug.callback.func(sys->debug.callback.user_data, pins);
+	}
+
+	sys->pins = pins;
+	return tick;
+}
+
 uint32_t clk_ticks_to_us(uint64_t freq_hz, uint32_t ticks) 
 {
-	return (uint32_t)((ticks * 1000000) / freq_hz);
+	return (uint32_t)(((uint64_t)ticks * 1000000) / freq_hz);	// 64 bit so a frame's worth of ticks doesn't overflow
+}
+
+// duration of a single machine frame
+uint32_t ZXGetFrameMicroSeconds(zx_t* sys)
+{
+	return clk_ticks_to_us(sys->freq_hz, sys->frame_scan_lines * sys->scanline_period);
 }
 
 uint32_t ZXExeEmu_UseFetchCount(zx_t* sys, uint32_t noFetches, GetIOInput ioInputCB, void* pUserData)
@@ -17,9 +17,37 @@ extern "C" {
 	
 typedef bool(*GetIOInput)(uint16_t port, uint8_t* pInVal, void* pUserData);
 
+// Memory or IO access made during an instruction
+typedef struct
+{
+	uint64_t	Pins;		// pins on the tick the access was made
+	uint64_t	LastPins;	// pins on the tick before, for edge detection
+	uint16_t	ScanlineY;
+} FZXInstructionAccess;
+
+enum { kZXMaxInstructionAccesses = 16 };	// more than any Z80 instruction or interrupt acknowledge makes
+
+// Accesses buffered up between instruction boundaries
+typedef struct
+{
+	FZXInstructionAccess	Accesses[kZXMaxInstructionAccesses];
+	int						NoAccesses;
+	int						NoTicks;	// includes the tick that completed the instruction
+} FZXInstructionInfo;
+
+// Called on the tick that completes an instruction, with the accesses made since the last one
+typedef void(*InstructionCallback)(void* pUserData, const FZXInstructionInfo* pInstruction, uint64_t pins, uint64_t lastPins);
+
+// Called before the instruction at the trap address executes, return true & set pNewPC to skip it
+typedef bool(*InstructionTrap)(uint16_t pc, uint16_t* pNewPC, void* pUserData);
+
 void ZXDecodeScreen(zx_t* pZX);
 uint32_t ZXExeEmu(zx_t* sys, uint32_t micro_seconds);
+uint32_t ZXExeEmu_PerInstruction(zx_t* sys, uint32_t micro_seconds, FZXInstructionInfo* pInstruction, InstructionCallback instructionCB, void* pUserData);
 uint32_t ZXExeEmu_UseFetchCount(zx_t* sys, uint32_t noFetches, GetIOInput ioInputCB, void* pUserData);
+uint32_t ZXExeEmu_UntilStopped(zx_t* sys, uint32_t maxTicks, GetIOInput ioInputCB, void* pUserData);
+uint32_t ZXGetFrameMicroSeconds(zx_t* sys);
+void ZXSetInstructionTrap(uint16_t address, InstructionTrap trapCB, void* pUserData);
 
 #ifdef __cplusplus
 } // extern "C"
@@ -28,6 +28,8 @@ void FZXSpectrumConfig::ReadFromJson(const nlohmann::json& jsonConfigFile)
 		PokesFolder = jsonConfigFile["PokesFolder"];
 	if (jsonConfigFile.contains("RZXFolder"))
 		RZXFolder = jsonConfigFile["RZXFolder"];
+	if (jsonConfigFile.contains("InstantTapeLoad"))
+		bInstantTapeLoad = jsonConfigFile["InstantTapeLoad"];
 
 	FixupPaths();
 }
@@ -38,4 +40,5 @@ void FZXSpectrumConfig::WriteToJson(nlohmann::json& jsonConfigFile) const
 	jsonConfigFile["SnapshotFolder128"] = SnapshotFolder128;
 	jsonConfigFile["PokesFolder"] = PokesFolder;
 	jsonConfigFile["RZXFolder"] = RZXFolder;
+	jsonConfigFile["InstantTapeLoad"] = bInstantTapeLoad;
 }
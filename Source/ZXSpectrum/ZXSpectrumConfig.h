@@ -9,6 +9,7 @@ struct FZXSpectrumConfig : public FGlobalConfig
 	std::string			SnapshotFolder128 = "./Games128/";
 	std::string			PokesFolder = "./Pokes/";
 	std::string			RZXFolder = "./RZX/";
+	bool				bInstantTapeLoad = true;
 
 protected:
 